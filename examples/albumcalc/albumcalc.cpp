@@ -12,6 +12,9 @@
 #ifndef __LIBARCSTK_METADATA_HPP__   // libarcstk: Compact Disc metadata
 #include "metadata.hpp"
 #endif
+#ifndef __LIBARCSTK_PIPELINE_HPP__   // libarcstk: decode while calculating
+#include "pipeline.hpp"
+#endif
 #ifndef __LIBARCSTK_SAMPLES_HPP__    // libarcstk: normalize input samples
 #include "samples.hpp"
 #endif
@@ -136,7 +139,8 @@ int main(int argc, char* argv[])
 
 	// Define input block size in number of samples, where 'sample' means a
 	// 32 bit unsigned integer holding a pair of PCM 16 bit stereo samples.
-	const auto samples_per_block { 16777216 }; // == 64 MB block size
+	// Since decoding and calculating overlap, smaller blocks are preferable.
+	const auto samples_per_block { 262144 }; // == 1 MB block size
 
 	// Calculation will have to distinguish the tracks in the audiofile.
 	// To identify the track bounds, we need the TOC, precisely:
@@ -233,12 +237,14 @@ int main(int argc, char* argv[])
 	// things... If the channel order is switched, the sample format is
 	// changed or the sequence is planar, the example code will screw up!
 
-	using std::cbegin;
-	using std::cend;
+	// Step 4: Create a pipeline for the Calculation. The pipeline updates the
+	// Calculation by a separate thread, so while the Calculation processes a
+	// block of samples, we can already decode the next block. On a multicore
+	// machine, decoding is then almost for free.
+	arcstk::CalculationPipeline pipeline(*calculation, samples_per_block);
 
 	// Main loop: let libsndfile read the sample in its own format, normalize it
-	// and update the prepared Calculation with the samples read in the current
-	// loop run.
+	// to a free block of the pipeline and pass the block to the Calculation.
 	while ((ints_in_block = audiofile.read(&buffer[0], buffer_len)))
 	{
 		// Check whether we have read the expected amount of samples in this run
@@ -279,22 +285,28 @@ int main(int argc, char* argv[])
 		// Note: since libsndfile has told us the total sample count, we were
 		// able to configure the context with the correct leadout.
 		// Otherwise, we would not yet know the leadout frame number. If that
-		// were the case we would have to provide our Calculation with this
-		// information manually by doing:
+		// were the case we would have to provide our Calculation with the
+		// total number of samples manually by doing:
 		//
-		// calculation.update_audiosize(samples_read);
+		// calculation->update(audiosize);
 		//
-		// _before_ we send the last block of samples to it. This is absolutely
-		// essential since otherwise the Calculation will not know when to stop
-		// and eventually fail. It is sufficient to update the audio size
-		// just before the last block of samples is passed to Calculation. Since
-		// we can recognize the last block as demonstrated above, we can also
-		// count the total number of samples read before the last update.
-
-		// Update calculation with next portion of normalized samples.
-		calculation->update(cbegin(sequence), cend(sequence));
+		// _before_ we create the pipeline. This is absolutely essential since
+		// otherwise the Calculation will not know when to stop and eventually
+		// fail. Note that the Calculation must not be accessed while the
+		// pipeline is open.
+
+		// Normalize the samples to a free block of the pipeline and pass the
+		// block to the Calculation. If all blocks are occupied, acquire() waits
+		// until the Calculation has processed a block.
+		auto block { pipeline.acquire() };
+		sequence.copy(block, sequence.size());
+		pipeline.commit(sequence.size());
 	}
 
+	// Wait until the Calculation has processed all blocks. Before this, the
+	// Calculation must not be accessed.
+	pipeline.close();
+
 	// Ok, no more samples. We demonstrate that the Calculation is complete:
 	if (calculation->complete())
 	{
@@ -14,7 +14,7 @@
  */
 
 #ifndef __LIBARCSTK_CHECKSUM_HPP__
-#include "checksum.hpp"     // for checksum::type, ChecksumSet
+#include "checksum.hpp"     // for checksum::type, ChecksumSet, ChecksumtypeSet
 #endif
 #ifndef __LIBARCSTK_CALCULATE_HPP__
 #include "calculate.hpp"    // for Algorithm
@@ -23,7 +23,7 @@
 #include <cstdint>        // for uint_fast32_t, uint_fast64_t, int32_t
 #include <memory>         // for unique_ptr, swap
 #include <string>         // for string
-#include <unordered_set>  // for unordered_set
+#include <vector>         // for vector
 
 namespace arcstk
 {
@@ -109,6 +109,11 @@ struct Subtotals
 
 /**
  * \brief Functor for performing the actual update.
+ *
+ * Updates by contiguous sequences of samples are performed by a vectorized
+ * kernel that is selected at runtime according to the capabilities of the CPU.
+ * Large contiguous sequences may be split in shards that are processed by
+ * multiple threads.
  */
 template <enum checksum::type T1, enum checksum::type... T2>
 struct Update
@@ -145,6 +150,9 @@ struct Update<checksum::type::ARCS1>
 		}
 	}
 
+	void operator()(const sample_t* start, const sample_t* stop, Subtotals& st,
+		const unsigned threads) const;
+
 	ChecksumSet value(const Subtotals& st) const;
 	std::string id_string() const;
 };
@@ -166,6 +174,9 @@ struct Update<checksum::type::ARCS2>
 		}
 	}
 
+	void operator()(const sample_t* start, const sample_t* stop, Subtotals& st,
+		const unsigned threads) const;
+
 	ChecksumSet value(const Subtotals& st) const;
 	std::string id_string() const;
 };
@@ -186,6 +197,9 @@ struct Update<checksum::type::ARCS1,checksum::type::ARCS2>
 		}
 	}
 
+	void operator()(const sample_t* start, const sample_t* stop, Subtotals& st,
+		const unsigned threads) const;
+
 	ChecksumSet value(const Subtotals& st) const;
 	std::string id_string() const;
 };
@@ -195,7 +209,7 @@ struct Update<checksum::type::ARCS1,checksum::type::ARCS2>
  * \brief Updater for specified checksum types.
  */
 template <enum checksum::type T1, enum checksum::type... T2>
-std::unordered_set<checksum::type> types_set()
+ChecksumtypeSet types_set()
 {
 	return { T1, T2... };
 }
@@ -219,6 +233,11 @@ class AccurateRipCS final
 	 */
 	Update<T1, T2...> update_;
 
+	/**
+	 * \brief Maximum number of threads to update contiguous sequences.
+	 */
+	unsigned threads_;
+
 public:
 
 	/**
@@ -240,15 +259,40 @@ public:
 	 */
 	void set_multiplier(const uint_fast64_t m);
 
+	/**
+	 * \brief Maximum number of threads to update contiguous sequences.
+	 *
+	 * \return Maximum number of threads
+	 */
+	unsigned threads() const;
+
+	/**
+	 * \brief Set the maximum number of threads to update contiguous sequences.
+	 *
+	 * \param[in] threads Maximum number of threads, must be at least 1
+	 */
+	void set_threads(const unsigned threads);
+
 	/**
 	 * \brief Update the instance by a sequence of samples.
 	 *
+	 * The samples are copied block-wise to a scratch buffer that is processed
+	 * like a contiguous sequence of samples.
+	 *
 	 * \param[in] start The start position (part of update)
 	 * \param[in] stop  The stop position (not part of update)
 	 */
 	void update(const SampleInputIterator& start,
 			const SampleInputIterator& stop);
 
+	/**
+	 * \brief Update the instance by a contiguous sequence of samples.
+	 *
+	 * \param[in] start The start position (part of update)
+	 * \param[in] stop  The stop position (not part of update)
+	 */
+	void update(const sample_t* start, const sample_t* stop);
+
 	/**
 	 * \brief Get the current updated value from the Updatable.
 	 *
@@ -264,6 +308,20 @@ public:
 	 */
 	void reset();
 
+	/**
+	 * \brief Current subtotals of this instance.
+	 *
+	 * \return Current subtotals
+	 */
+	const Subtotals& subtotals() const;
+
+	/**
+	 * \brief Set the subtotals of this instance.
+	 *
+	 * \param[in] st Subtotals to set
+	 */
+	void set_subtotals(const Subtotals& st);
+
 	/**
 	 * \brief Get the ID string from the Updatable.
 	 *
@@ -279,7 +337,7 @@ public:
 	 *
 	 * \return Set of types calculated by this instance
 	 */
-	std::unordered_set<checksum::type> types() const
+	ChecksumtypeSet types() const
 	{
 		return types_set<T1, T2...>();
 	}
@@ -293,8 +351,9 @@ public:
 	friend void swap(AccurateRipCS& lhs, AccurateRipCS& rhs) noexcept
 	{
 		using std::swap;
-		swap(lhs.st_,     rhs.st_);
-		swap(lhs.update_, rhs.update_);
+		swap(lhs.st_,      rhs.st_);
+		swap(lhs.update_,  rhs.update_);
+		swap(lhs.threads_, rhs.threads_);
 	}
 };
 
@@ -323,17 +382,30 @@ class ARCSAlgorithm final : public Algorithm
 
 	void do_update(SampleInputIterator start, SampleInputIterator stop) final;
 
+	void do_update(const sample_t* start, const sample_t* stop) final;
+
 	void do_track_finished(const int t, const AudioSize& length) final;
 
 	ChecksumSet do_result() const final;
 
-	std::unordered_set<checksum::type> do_types() const final;
+	ChecksumtypeSet do_types() const final;
 
 	std::pair<int32_t, int32_t> do_range(const AudioSize& size,
 			const Points& points) const final;
 
 	std::unique_ptr<Algorithm> do_clone() const final;
 
+	void do_seek(const int t, const int32_t index) final;
+
+	void do_reset() final;
+
+	ChecksumSet do_merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+			const int32_t samples) const final;
+
+	void do_save(CheckpointWriter& out) const final;
+
+	void do_restore(CheckpointReader& in) final;
+
 public:
 
 	/**
@@ -341,6 +413,15 @@ public:
 	 */
 	ARCSAlgorithm();
 
+	/**
+	 * \brief Multiplier for the next sample of the current track.
+	 *
+	 * The multiplier is the 1-based index of the sample within the track.
+	 *
+	 * \return Multiplier for the next sample
+	 */
+	uint_fast64_t multiplier() const;
+
 	/**
 	 * \brief Swap two instances.
 	 *
@@ -356,6 +437,412 @@ public:
 	}
 };
 
+/**
+ * \internal
+ *
+ * \brief Base for the algorithms that provide the ARCS of frame 450.
+ *
+ * Retains the window of samples around frame 450 of each track that is
+ * required to detect the read offset of the track. For a maximal offset \c m,
+ * the window consists of the 588 + 2 * \c m samples starting with sample
+ * 450 * 588 - \c m of the track. The window is also the source of the ARCS of
+ * frame 450.
+ *
+ * The base does not depend on the checksum types of the subclass. Hence, the
+ * windows can be accessed for any of the algorithms.
+ */
+class ARCSFrame450Base : public Algorithm
+{
+	/**
+	 * \brief Maximal offset the windows are retained for.
+	 */
+	int32_t max_offset_;
+
+	/**
+	 * \brief Window of the current track.
+	 */
+	std::vector<sample_t> window_;
+
+	/**
+	 * \brief Windows of the finished tracks by 0-based track index.
+	 *
+	 * The window of a track that ended within its window is empty.
+	 */
+	std::vector<std::vector<sample_t>> windows_;
+
+protected:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] max_offset Maximal offset to retain the windows for
+	 *
+	 * \throws std::invalid_argument If \c max_offset is negative or the window
+	 * would start before the track
+	 */
+	explicit ARCSFrame450Base(const int32_t max_offset);
+
+	/**
+	 * \brief Part of the window within the specified samples of a track.
+	 *
+	 * \param[in] first 0-based index within the track of the first sample
+	 * \param[in] last  0-based index within the track behind the last sample
+	 *
+	 * \return 0-based indices within the track of the first sample and behind
+	 * the last sample, the range is empty if there are no such samples
+	 */
+	std::pair<int32_t, int32_t> window_range(const int32_t first,
+			const int32_t last) const;
+
+	/**
+	 * \brief Position of a sample of the current track within the window.
+	 *
+	 * \param[in] index 0-based index of a sample within the window range
+	 *
+	 * \return Position of the sample within the window
+	 */
+	sample_t* window_at(const int32_t index);
+
+	/**
+	 * \brief ARCS of frame 450 of the current track.
+	 *
+	 * \return ARCS of the samples of frame 450 in the window
+	 */
+	uint32_t window_arcs() const;
+
+	/**
+	 * \brief Retain the window of the current track and start the next one.
+	 *
+	 * \param[in] t        1-based number of the finished track
+	 * \param[in] complete TRUE iff the track ended behind its window
+	 */
+	void finish_window(const int t, const bool complete);
+
+	/**
+	 * \brief Discard all windows.
+	 */
+	void reset_windows();
+
+	/**
+	 * \brief Write the windows to a checkpoint.
+	 *
+	 * \param[in,out] out Writer to write the windows to
+	 */
+	void save_windows(CheckpointWriter& out) const;
+
+	/**
+	 * \brief Read the windows from a checkpoint.
+	 *
+	 * \param[in,out] in Reader to read the windows from
+	 *
+	 * \throws std::invalid_argument If the windows were retained for another
+	 * maximal offset
+	 */
+	void restore_windows(CheckpointReader& in);
+
+	/**
+	 * \brief Swap the windows with another instance.
+	 *
+	 * \param[in] rhs Instance to swap with
+	 */
+	void swap_windows(ARCSFrame450Base& rhs) noexcept;
+
+public:
+
+	/**
+	 * \brief Maximal offset the windows are retained for.
+	 *
+	 * \return Maximal absolute offset in samples
+	 */
+	int32_t max_offset() const noexcept;
+
+	/**
+	 * \brief Window of samples around frame 450 of a finished track.
+	 *
+	 * The window can be passed to OffsetDetector::detect() with max_offset().
+	 *
+	 * \param[in] track 1-based number of the track
+	 *
+	 * \return Window of the track, empty if the track is not finished or
+	 * ended within its window
+	 */
+	std::vector<sample_t> frame450_window(const int track) const;
+};
+
+/**
+ * \internal
+ *
+ * \brief AccurateRip algorithm variants that also provide the ARCS of frame 450.
+ *
+ * AccurateRip references contain the ARCSv1 of frame 450 of each track for
+ * detecting the offset of the drive and the pressing. This ARCS is calculated
+ * over the 588 samples of frame 450 with multipliers starting with 1. The
+ * algorithm calculates it in the same pass as the ARCSs of the track and
+ * provides it as checksum::type::FRAME450.
+ *
+ * The window of samples around frame 450 of each track is retained in the same
+ * pass. Its size is determined by the maximal offset passed on construction.
+ * Offset detection therefore does not require to read the input again.
+ *
+ * Tracks that end before frame 450 is complete do not have a FRAME450
+ * checksum.
+ */
+template<enum checksum::type T1, enum checksum::type... T2>
+class ARCSFrame450Algorithm final : public ARCSFrame450Base
+{
+	/**
+	 * \brief Algorithm for the ARCSs of the track.
+	 */
+	ARCSAlgorithm<T1, T2...> arcs_;
+
+	/**
+	 * \brief Current result of performing the algorithm.
+	 */
+	ChecksumSet current_result_;
+
+	/**
+	 * \brief Samples of the last update that are part of the window.
+	 *
+	 * \param[in] first_multiplier Multiplier before the last update
+	 *
+	 * \return 0-based indices within the track of the first sample and behind
+	 * the last sample, the range is empty if there are no such samples
+	 */
+	std::pair<int32_t, int32_t> update_range(
+			const uint_fast64_t first_multiplier) const;
+
+	// Algorithm
+
+	void do_setup(const Settings* s) final;
+
+	void do_update(SampleInputIterator start, SampleInputIterator stop) final;
+
+	void do_update(const sample_t* start, const sample_t* stop) final;
+
+	void do_track_finished(const int t, const AudioSize& length) final;
+
+	ChecksumSet do_result() const final;
+
+	ChecksumtypeSet do_types() const final;
+
+	std::pair<int32_t, int32_t> do_range(const AudioSize& size,
+			const Points& points) const final;
+
+	std::unique_ptr<Algorithm> do_clone() const final;
+
+	void do_reset() final;
+
+	void do_save(CheckpointWriter& out) const final;
+
+	void do_restore(CheckpointReader& in) final;
+
+public:
+
+	/**
+	 * \brief Default constructor.
+	 *
+	 * Retains only the samples of frame 450 of each track.
+	 */
+	ARCSFrame450Algorithm();
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] max_offset Maximal offset to retain the windows for
+	 *
+	 * \throws std::invalid_argument If \c max_offset is negative or the window
+	 * would start before the track
+	 */
+	explicit ARCSFrame450Algorithm(const int32_t max_offset);
+
+	/**
+	 * \brief Swap two instances.
+	 *
+	 * \param[in] lhs First instance to swap
+	 * \param[in] rhs Second instance to swap
+	 */
+	friend void swap(ARCSFrame450Algorithm& lhs, ARCSFrame450Algorithm& rhs)
+		noexcept
+	{
+		using std::swap;
+
+		lhs.swap_windows(rhs);
+		swap(lhs.arcs_,           rhs.arcs_);
+		swap(lhs.current_result_, rhs.current_result_);
+	}
+};
+
+
+/**
+ * \internal
+ *
+ * \brief Calculate ARCSs for a range of read offsets in a single pass.
+ *
+ * Determining the read offset of a rip with an unknown drive offset requires
+ * the ARCSs of every track for every candidate offset. Instead of performing a
+ * Calculation for each offset, the scanner is updated exactly once with the
+ * samples of the entire input.
+ *
+ * The ARCSv1 of a track is linear in the samples: if \f$x_j\f$ is the sample
+ * with 0-based index \f$j\f$ of the input, the ARCSv1 of a track starting at
+ * index \f$s\f$ and read with offset \f$o\f$ is
+ * \f$\sum (j+1) x_j - (s+o) \sum x_j\f$, both sums taken over the samples in
+ * the track's range shifted by \f$o\f$. The scanner therefore accumulates both
+ * sums over the range extended by max_offset() on either side and retains the
+ * samples around the range bounds. From this, the ARCSv1 for any offset is
+ * derived in constant time.
+ *
+ * The ARCSv2 is not linear in the samples since it adds the higher 32 bits of
+ * each product. It is therefore only provided for offset 0.
+ *
+ * The result for offset \c o is the result a Calculation would yield if sample
+ * \c i of each track was taken from input sample \c i + \c o. Samples before
+ * the start or behind the end of the input are considered to be 0.
+ */
+class ARCSOffsetScanner final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] ctx        Context of the input
+	 * \param[in] size       Size of the input
+	 * \param[in] points     Track offsets (as samples)
+	 * \param[in] max_offset Maximal absolute offset to calculate ARCSs for
+	 *
+	 * \throws std::invalid_argument If max_offset is negative or points exceed
+	 * size
+	 */
+	ARCSOffsetScanner(const Context ctx, const AudioSize& size,
+			const Points& points, const int32_t max_offset);
+
+	/**
+	 * \brief Constructor for the maximal offset of NUM_SKIP_SAMPLES::BACK.
+	 *
+	 * \param[in] ctx    Context of the input
+	 * \param[in] size   Size of the input
+	 * \param[in] points Track offsets (as samples)
+	 *
+	 * \throws std::invalid_argument If points exceed size
+	 */
+	ARCSOffsetScanner(const Context ctx, const AudioSize& size,
+			const Points& points);
+
+	/**
+	 * \brief Maximal absolute offset to calculate ARCSs for.
+	 *
+	 * \return Maximal absolute offset
+	 */
+	int32_t max_offset() const noexcept;
+
+	/**
+	 * \brief Total number of tracks.
+	 *
+	 * \return Total number of tracks
+	 */
+	int total_tracks() const noexcept;
+
+	/**
+	 * \brief Total number of samples processed so far.
+	 *
+	 * \return Number of samples processed
+	 */
+	int32_t samples_processed() const noexcept;
+
+	/**
+	 * \brief Returns \c TRUE iff all samples of the input are processed.
+	 *
+	 * \return \c TRUE iff the scanner is completed, otherwise \c FALSE
+	 */
+	bool complete() const noexcept;
+
+	/**
+	 * \brief Update with the next contiguous sequence of samples.
+	 *
+	 * \param[in] start Pointer to the first sample of the sequence
+	 * \param[in] stop  Pointer behind the last sample of the sequence
+	 *
+	 * \throws std::invalid_argument If the sequence exceeds the input size
+	 */
+	void update(const sample_t* start, const sample_t* stop);
+
+	/**
+	 * \brief ARCSv1 of a track read with the specified offset.
+	 *
+	 * \param[in] track  1-based track number
+	 * \param[in] offset Read offset
+	 *
+	 * \return ARCSv1 of the track for the offset
+	 *
+	 * \throws std::out_of_range If track or offset is out of range
+	 * \throws std::logic_error  If the scanner is not complete()
+	 */
+	Checksum arcs1(const int track, const int32_t offset) const;
+
+	/**
+	 * \brief ARCSs of all tracks read with the specified offset.
+	 *
+	 * Each ChecksumSet contains the ARCSv1. For offset \c 0, it additionally
+	 * contains the ARCSv2.
+	 *
+	 * \param[in] offset Read offset
+	 *
+	 * \return ARCSs of all tracks for the offset
+	 *
+	 * \throws std::out_of_range If offset is out of range
+	 * \throws std::logic_error  If the scanner is not complete()
+	 */
+	Checksums result(const int32_t offset) const;
+
+private:
+
+	/**
+	 * \brief Accumulated data of a single track.
+	 */
+	struct TrackWindow
+	{
+		int32_t start  = 0; // index of the first sample of the track
+		int32_t first  = 0; // index of the first sample to calculate
+		int32_t last   = 0; // index behind the last sample to calculate
+		int32_t frames = 0; // number of frames to calculate
+
+		uint32_t sum   = 0; // sum of samples in extended range
+		uint32_t wsum  = 0; // sum of samples * (index+1) in extended range
+		uint32_t arcs2 = 0; // ARCSv2 for offset 0
+
+		std::vector<uint32_t> head   = {}; // samples around first, then sums
+		std::vector<uint32_t> head_w = {}; // weighted sums around first
+		std::vector<uint32_t> tail   = {}; // samples around last, then sums
+		std::vector<uint32_t> tail_w = {}; // weighted sums around last
+	};
+
+	/**
+	 * \brief Convert the retained samples to prefix sums.
+	 */
+	void finish();
+
+	/**
+	 * \brief Maximal absolute offset.
+	 */
+	int32_t max_offset_;
+
+	/**
+	 * \brief Total number of samples in the input.
+	 */
+	int32_t total_samples_;
+
+	/**
+	 * \brief Number of samples processed.
+	 */
+	int32_t processed_;
+
+	/**
+	 * \brief Accumulated data per track.
+	 */
+	std::vector<TrackWindow> tracks_;
+};
+
 // The following using declaratives are intended for testing.
 // For regular use, include header algorithms.hpp.
 
@@ -381,6 +868,15 @@ using Version2 = details::ARCSAlgorithm<checksum::type::ARCS2>;
 using Versions1and2 =
 		details::ARCSAlgorithm<checksum::type::ARCS1,checksum::type::ARCS2>;
 
+/**
+ * \internal
+ *
+ * \brief AccurateRip checksum algorithm version 2 providing also version 1 and
+ * the ARCS of frame 450.
+ */
+using Versions1and2withFrame450 =
+	details::ARCSFrame450Algorithm<checksum::type::ARCS1,checksum::type::ARCS2>;
+
 } // namespace details
 } // namespace accuraterip
 
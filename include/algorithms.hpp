@@ -39,6 +39,18 @@ using V2 = accuraterip::details::Version2;
  */
 using V1andV2 = accuraterip::details::Versions1and2;
 
+/**
+ * \brief AccurateRip checksum algorithm version 2 providing also version 1 and
+ * the ARCS of frame 450 of each track.
+ */
+using V1andV2withFrame450 = accuraterip::details::Versions1and2withFrame450;
+
+/**
+ * \brief Calculate AccurateRip checksums for a range of read offsets in a
+ * single pass.
+ */
+using OffsetScanner = accuraterip::details::ARCSOffsetScanner;
+
 } // namespace accuraterip
 
 /** @} */ // group calc
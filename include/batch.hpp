@@ -0,0 +1,313 @@
+#ifndef __LIBARCSTK_BATCH_HPP__
+#define __LIBARCSTK_BATCH_HPP__
+
+/**
+ * \file
+ *
+ * \brief Batch calculation interface.
+ */
+
+#include <cstddef>          // for size_t
+#include <functional>       // for function
+#include <future>           // for shared_future
+#include <memory>           // for shared_ptr, unique_ptr
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"    // for Algorithm, sample_t
+#endif
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"     // for Checksums
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"     // for AudioSize
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+class ToC;
+
+/** \addtogroup calc */
+/** @{ */
+
+
+/**
+ * \brief Interface: Source of the samples of an audio image.
+ *
+ * A SampleSource provides the samples of an entire audio image in order. The
+ * samples are read block-wise to a buffer owned by the caller.
+ */
+class SampleSource
+{
+public:
+
+	/**
+	 * \brief Virtual default destructor.
+	 */
+	virtual ~SampleSource() noexcept;
+
+	/**
+	 * \brief Read the next samples to a buffer.
+	 *
+	 * Less than \c size samples may be read even if more samples are
+	 * available. Returning 0 indicates that the source is exhausted.
+	 *
+	 * \param[in] buffer Buffer to read the samples to
+	 * \param[in] size   Maximal number of samples to read
+	 *
+	 * \return Number of samples read to \c buffer
+	 */
+	std::size_t read(sample_t* buffer, const std::size_t size);
+
+	/**
+	 * \brief Total number of samples provided by this source.
+	 *
+	 * If the total number of samples is not known in advance, the
+	 * AudioSize returned is <tt>zero()</tt>.
+	 *
+	 * \return Total number of samples
+	 */
+	AudioSize size() const;
+
+private:
+
+	virtual std::size_t do_read(sample_t* buffer, const std::size_t size)
+	= 0;
+
+	virtual AudioSize do_size() const;
+};
+
+
+/**
+ * \brief SampleSource over a contiguous sequence of samples in memory.
+ *
+ * The samples are not owned by the instance, so the caller has to keep them
+ * alive until the source is exhausted.
+ */
+class MemorySampleSource final : public SampleSource
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] start Pointer to the first sample of the sequence
+	 * \param[in] stop  Pointer behind the last sample of the sequence
+	 */
+	MemorySampleSource(const sample_t* start, const sample_t* stop) noexcept;
+
+	MemorySampleSource(const MemorySampleSource& rhs) = default;
+	MemorySampleSource& operator=(const MemorySampleSource& rhs) = default;
+
+private:
+
+	std::size_t do_read(sample_t* buffer, const std::size_t size) final;
+
+	AudioSize do_size() const final;
+
+	/**
+	 * \brief Pointer to the first sample.
+	 */
+	const sample_t* start_;
+
+	/**
+	 * \brief Pointer to the next sample to read.
+	 */
+	const sample_t* current_;
+
+	/**
+	 * \brief Pointer behind the last sample.
+	 */
+	const sample_t* stop_;
+};
+
+
+/**
+ * \brief Processing status of a BatchJob.
+ */
+enum class JobStatus : unsigned
+{
+	QUEUED    = 0, // submitted, waiting for a thread
+	RUNNING   = 1, // currently processed by a thread
+	COMPLETED = 2, // processed, result is available
+	FAILED    = 3  // processing failed, result rethrows the error
+};
+
+
+/**
+ * \brief Callback to notify about a finished BatchJob.
+ *
+ * The callback is called with the id of the job, its final JobStatus and its
+ * result. If the job has failed, the result is empty.
+ *
+ * It is called by the thread that processed the job. Exceptions thrown by the
+ * callback are logged and discarded.
+ */
+using BatchCallback = std::function<void(const std::size_t id,
+		const JobStatus status, const Checksums& result)>;
+
+
+/**
+ * \brief Handle of a job submitted to a BatchCalculator.
+ *
+ * A BatchJob is a cheap, copyable reference to the state of the job. It
+ * remains valid after the BatchCalculator is destroyed.
+ */
+class BatchJob final
+{
+public:
+
+	class State;
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] state State of the job
+	 */
+	explicit BatchJob(std::shared_ptr<State> state) noexcept;
+
+	/**
+	 * \brief Id of the job.
+	 *
+	 * Ids are assigned by the BatchCalculator in order of submission,
+	 * starting with 0.
+	 *
+	 * \return Id of the job
+	 */
+	std::size_t id() const noexcept;
+
+	/**
+	 * \brief Current processing status of the job.
+	 *
+	 * \return Current JobStatus
+	 */
+	JobStatus status() const noexcept;
+
+	/**
+	 * \brief Block until the job is finished.
+	 */
+	void wait() const;
+
+	/**
+	 * \brief Result of the job.
+	 *
+	 * Blocks until the job is finished.
+	 *
+	 * \return Checksums of the job
+	 *
+	 * \throws Whatever caused the job to fail
+	 */
+	Checksums result() const;
+
+	/**
+	 * \brief Future for the result of the job.
+	 *
+	 * \return Future for the result of the job
+	 */
+	std::shared_future<Checksums> future() const noexcept;
+
+private:
+
+	/**
+	 * \brief Internal state of the job.
+	 */
+	std::shared_ptr<State> state_;
+};
+
+
+/**
+ * \brief Perform many Calculations in parallel.
+ *
+ * A BatchCalculator processes jobs, each of which consists of the ToC of an
+ * audio image and a SampleSource for its samples.
+ *
+ * Jobs are processed by a pool of threads. Each thread has its own queue of
+ * jobs and, when its queue is exhausted, steals jobs from the queues of the
+ * other threads. Thus, the threads do not contend for a single queue. Each
+ * thread creates a single Calculation with a clone of the Algorithm passed on
+ * construction and resets it for every job it processes. Likewise, it reuses
+ * its sample buffer for all jobs.
+ *
+ * The result of a job is available by the BatchJob returned on submission or
+ * by an optional BatchCallback.
+ *
+ * The destructor blocks until all submitted jobs are finished.
+ */
+class BatchCalculator final
+{
+	class Impl;
+	std::unique_ptr<Impl> impl_;
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * If \c threads is 0, the number of hardware threads is used.
+	 *
+	 * \param[in] algorithm Prototype of the Algorithm to use for each job
+	 * \param[in] threads   Number of threads to use
+	 *
+	 * \throws std::invalid_argument If \c algorithm is \c nullptr or does not
+	 * support Algorithm::reset()
+	 */
+	explicit BatchCalculator(std::unique_ptr<Algorithm> algorithm,
+			const unsigned threads = 0);
+
+	BatchCalculator(const BatchCalculator& rhs) = delete;
+	BatchCalculator& operator=(const BatchCalculator& rhs) = delete;
+
+	/**
+	 * \brief Destructor.
+	 *
+	 * Blocks until all jobs are finished.
+	 */
+	~BatchCalculator() noexcept;
+
+	/**
+	 * \brief Submit a job.
+	 *
+	 * If the ToC is not complete, the SampleSource must provide its total
+	 * number of samples.
+	 *
+	 * \param[in] toc      ToC of the audio image
+	 * \param[in] source   Source of the samples of the audio image
+	 * \param[in] callback Optional callback to call when the job is finished
+	 *
+	 * \return Handle of the job
+	 *
+	 * \throws std::invalid_argument If \c source is \c nullptr or the ToC is
+	 * not complete and \c source does not provide its size
+	 */
+	BatchJob submit(const ToC& toc, std::unique_ptr<SampleSource> source,
+			BatchCallback callback = nullptr);
+
+	/**
+	 * \brief Block until all submitted jobs are finished.
+	 */
+	void wait();
+
+	/**
+	 * \brief Number of jobs submitted but not yet finished.
+	 *
+	 * \return Number of unfinished jobs
+	 */
+	std::size_t unfinished() const noexcept;
+
+	/**
+	 * \brief Number of threads processing the jobs.
+	 *
+	 * \return Number of threads
+	 */
+	unsigned threads() const noexcept;
+};
+
+/** @} */
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
@@ -7,23 +7,25 @@
  * \brief Calculation interface.
  */
 
+#include <algorithm>        // for copy_n
 #include <chrono>           // for duration
-#include <cstddef>          // for ptrdiff_t
+#include <cstddef>          // for max_align_t, ptrdiff_t, size_t
 #include <cstdint>          // for int32_t
-#include <iterator>         // for advance, input_iterator_tag
+#include <functional>       // for function
+#include <iterator>         // for advance, distance, input_iterator_tag
 #include <memory>           // for make_unique, unique_ptr
+#include <new>              // for new
 #include <string>           // for string
 #include <type_traits>      // for decay_t, enable_if_t, is_same, decay
 #include <typeinfo>         // for type_info
-#include <unordered_set>    // for unordered_set
-#include <utility>          // for declval, move, pair
+#include <utility>          // for declval, forward, move, pair
 #include <vector>           // for vector
 
 #ifndef __LIBARCSTK_CHECKSUM_HPP__
-#include "checksum.hpp"     // for ChecksumSet, Checksums
+#include "checksum.hpp"     // for ChecksumSet, Checksums, ChecksumtypeSet
 #endif
 #ifndef __LIBARCSTK_POLICIES_HPP__
-#include "policies.hpp"     // for Comparable, IteratorValue
+#include "policies.hpp"     // for Comparable
 #endif
 
 /**
@@ -39,6 +41,8 @@ inline namespace v_1_0_0
 {
 
 class AudioSize;
+class CheckpointReader;
+class CheckpointWriter;
 class ToC;
 
 using ToCData = std::vector<AudioSize>; // duplicate of metadata.hpp
@@ -139,6 +143,52 @@ template<typename Iterator>
 using IsSampleIterator =
 	std::enable_if_t<is_iterator_over<Iterator, sample_t>::value>;
 
+/**
+ * \internal
+ * \brief Copy \c n samples starting at \c pos to \c buffer.
+ *
+ * Iterator types that can provide their samples more efficiently than by
+ * dereferencing each position may overload this function in their own
+ * namespace. SampleInputIterator finds the overloads by argument dependent
+ * lookup.
+ *
+ * Each position is visited exactly once, hence this is also valid for
+ * iterators that do not support multiple passes.
+ *
+ * \param[in] pos    Position of the first sample to copy
+ * \param[in] n      Number of samples to copy
+ * \param[in] buffer Buffer for at least \c n samples
+ *
+ * \return Position behind the last sample copied
+ */
+template<typename Iterator>
+Iterator copy_samples(Iterator pos, const std::ptrdiff_t n, sample_t* buffer)
+{
+	for (auto i { n }; i > 0; --i, ++pos, ++buffer)
+	{
+		*buffer = *pos;
+	}
+
+	return pos;
+}
+
+/**
+ * \internal
+ * \brief Copy \c n contiguous samples starting at \c pos to \c buffer.
+ *
+ * \param[in] pos    Pointer to the first sample to copy
+ * \param[in] n      Number of samples to copy
+ * \param[in] buffer Buffer for at least \c n samples
+ *
+ * \return Pointer behind the last sample copied
+ */
+inline const sample_t* copy_samples(const sample_t* pos,
+		const std::ptrdiff_t n, sample_t* buffer)
+{
+	std::copy_n(pos, n, buffer);
+	return pos + n;
+}
+
 /**
  * \brief Type erasing interface for iterators over PCM 32 bit samples.
  *
@@ -149,14 +199,17 @@ using IsSampleIterator =
  * SampleInputIterator can wrap any iterator with a value_type of uint32_t
  * except instances of itself, e.g. it can not be "nested".
  *
- * The type erasure interface only ensures that (most of) the requirements of a
- * <A HREF="https://en.cppreference.com/w/cpp/named_req/InputIterator">
- * LegacyInputIterator</A> are met. Those requirements are sufficient for
- * \link arcstk::v_1_0_0::Calculation::update() updating \endlink a Calculation.
+ * SampleInputIterator may wrap iterators of any category and therefore only
+ * declares to be an input iterator. Nonetheless, the distance between two
+ * instances as well as advancing an instance are delegated to the wrapped
+ * iterator with a single virtual call. They therefore take constant time,
+ * provided that the wrapped iterator is a random access iterator. For other
+ * iterators, these operations take linear time, the distance can only be
+ * determined from an iterator to a subsequent iterator and an instance can
+ * only be advanced forward.
  *
- * Although SampleInputIterator is intended to provide the functionality of
- * an input iterator, it does not provide operator->() and does
- * therefore not completely fulfill the requirements for a LegacyInputIterator.
+ * SampleInputIterator does not provide operator->() and does therefore not
+ * completely fulfill the requirements for a LegacyInputIterator.
  *
  * SampleInputIterator provides iteration over values of type
  * \link arcstk::v_1_0_0::sample_t sample_t\endlink which is defined as a
@@ -171,6 +224,9 @@ public:
 
 	/**
 	 * \brief Iterator category is std::input_iterator_tag.
+	 *
+	 * The wrapped iterator may be of any category, hence no stronger category
+	 * can be guaranteed.
 	 */
 	using iterator_category = std::input_iterator_tag;
 
@@ -224,7 +280,28 @@ private:
 		 *
 		 * \param[in] n Number of positions to advance
 		 */
-		virtual void advance(const int32_t n) noexcept
+		virtual void advance(const difference_type n) noexcept
+		= 0;
+
+		/**
+		 * \brief Distance from \c rhs to the instance.
+		 *
+		 * \param[in] rhs The instance to get the distance from
+		 *
+		 * \return Number of positions from \c rhs to the instance
+		 */
+		virtual difference_type distance_from(const Concept& rhs)
+			const noexcept
+		= 0;
+
+		/**
+		 * \brief Copies \c n samples starting with the current position and
+		 * advances the iterator behind the last sample copied.
+		 *
+		 * \param[in] n      Number of samples to copy
+		 * \param[in] buffer Buffer to copy the samples to
+		 */
+		virtual void copy(const difference_type n, sample_t* buffer) noexcept
 		= 0;
 
 		/**
@@ -257,14 +334,34 @@ private:
 		= 0;
 
 		/**
-		 * \brief Returns a deep copy of the instance
+		 * \brief Creates a deep copy of the instance.
+		 *
+		 * The copy is created in \c buffer if it fits, otherwise on the heap.
+		 *
+		 * \param[in] buffer Buffer to create the copy in
 		 *
 		 * \return A deep copy of the instance
 		 */
-		virtual std::unique_ptr<Concept> clone() const noexcept
+		virtual Concept* copy_to(void* buffer) const noexcept
+		= 0;
+
+		/**
+		 * \brief Moves the instance to \c buffer.
+		 *
+		 * Only to be called on instances that reside in a buffer.
+		 *
+		 * \param[in] buffer Buffer to move the instance to
+		 *
+		 * \return The moved instance
+		 */
+		virtual Concept* move_to(void* buffer) noexcept
 		= 0;
 	};
 
+// Iterator may be a pointer, which is copied as intended
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+
 	/**
 	 * \internal
 	 *
@@ -286,11 +383,22 @@ private:
 			++iterator_;
 		}
 
-		void advance(const int32_t n) noexcept final
+		void advance(const difference_type n) noexcept final
 		{
 			std::advance(iterator_, n);
 		}
 
+		difference_type distance_from(const Concept& rhs) const noexcept final
+		{
+			return std::distance(static_cast<const Model&>(rhs).iterator_,
+					iterator_);
+		}
+
+		void copy(const difference_type n, sample_t* buffer) noexcept final
+		{
+			iterator_ = copy_samples(iterator_, n, buffer);
+		}
+
 		reference dereference() noexcept final
 		{
 			return *iterator_;
@@ -311,9 +419,14 @@ private:
 			return typeid(iterator_);
 		}
 
-		std::unique_ptr<Concept> clone() const noexcept final
+		Concept* copy_to(void* buffer) const noexcept final
+		{
+			return construct<Model>(buffer, *this);
+		}
+
+		Concept* move_to(void* buffer) noexcept final
 		{
-			return std::make_unique<Model>(*this);
+			return construct<Model>(buffer, std::move(*this));
 		}
 
 		friend void swap(Model& lhs, Model& rhs) noexcept
@@ -330,6 +443,8 @@ private:
 		Iterator iterator_;
 	};
 
+#pragma GCC diagnostic pop
+
 public:
 
 	/**
@@ -341,7 +456,8 @@ public:
 	 */
 	template <class Iterator, typename = IsSampleIterator<Iterator> >
 	SampleInputIterator(const Iterator& i)
-		: object_ { std::make_unique<Model<Iterator>>(i) }
+		: buffer_ {}
+		, object_ { construct<Model<Iterator>>(buffer_, i) }
 	{
 		// empty
 	}
@@ -352,7 +468,8 @@ public:
 	 * \param[in] rhs Instance to copy
 	 */
 	SampleInputIterator(const SampleInputIterator& rhs)
-		: object_ { rhs.object_->clone() }
+		: buffer_ {}
+		, object_ { rhs.object_->copy_to(buffer_) }
 	{
 		// empty
 	}
@@ -363,15 +480,19 @@ public:
 	 * \param[in] rhs Instance to move
 	 */
 	SampleInputIterator(SampleInputIterator&& rhs) noexcept
-		: object_ { std::move(rhs.object_) }
+		: buffer_ {}
+		, object_ { nullptr }
 	{
-		// empty
+		this->take(rhs);
 	}
 
 	/**
 	 * \brief Destructor
 	 */
-	~SampleInputIterator() noexcept = default;
+	~SampleInputIterator() noexcept
+	{
+		this->destroy();
+	}
 
 	/**
 	 * \brief Dereferences the iterator to the sample pointed to.
@@ -426,8 +547,9 @@ public:
 	friend void swap(SampleInputIterator& lhs, SampleInputIterator& rhs)
 		noexcept
 	{
-		using std::swap;
-		swap(lhs.object_, rhs.object_);
+		SampleInputIterator tmp { std::move(lhs) };
+		lhs.take(rhs);
+		rhs.take(tmp);
 	} // required by LegacyIterator
 
 
@@ -438,25 +560,167 @@ public:
 	}
 
 
+	/**
+	 * \brief Copy \c n samples starting with the current position to
+	 * \c buffer.
+	 *
+	 * This requires only a single virtual call for the entire block of
+	 * samples. Hence, copying blocks of samples to a contiguous buffer and
+	 * processing the buffer is much faster than dereferencing and incrementing
+	 * the iterator for each sample. The iterator is advanced behind the last
+	 * sample copied, hence each sample is visited exactly once.
+	 *
+	 * \param[in] n      Number of samples to copy
+	 * \param[in] buffer Buffer to copy the samples to, at least of size \c n
+	 */
+	void copy(const difference_type n, sample_t* buffer) noexcept
+	{
+		object_->copy(n, buffer);
+	}
+
+	/**
+	 * \brief Advance iterator by \c amount positions.
+	 *
+	 * The \c amount must not be negative.
+	 *
+	 * \param[in] amount Number of positions to advance
+	 *
+	 * \return Advanced iterator
+	 */
+	SampleInputIterator& operator += (const difference_type amount) noexcept
+	{
+		object_->advance(amount);
+		return *this;
+	}
+
+
 	friend SampleInputIterator operator + (SampleInputIterator lhs,
-			const int32_t amount) noexcept
+			const difference_type amount) noexcept
 	{
 		lhs.object_->advance(amount);
 		return lhs;
 	}
 
-	friend SampleInputIterator operator + (const int32_t amount,
+	friend SampleInputIterator operator + (const difference_type amount,
 			SampleInputIterator lhs) noexcept
 	{
 		return lhs + amount;
 	}
 
+	/**
+	 * \brief Number of positions from \c rhs to \c lhs.
+	 *
+	 * Unless the wrapped iterator is a random access iterator, \c rhs must
+	 * not be behind \c lhs.
+	 *
+	 * \param[in] lhs Left hand side of the operation
+	 * \param[in] rhs Right hand side of the operation
+	 *
+	 * \return Number of positions from \c rhs to \c lhs
+	 */
+	friend difference_type operator - (const SampleInputIterator& lhs,
+			const SampleInputIterator& rhs) noexcept
+	{
+		return lhs.object_->distance_from(*rhs.object_);
+	}
+
 private:
 
 	/**
-	 * \brief Internal representation of wrapped object
+	 * \brief Size of the internal buffer for wrapped objects.
+	 *
+	 * Sufficient for wrapping SampleIterators, pointers and the iterators of
+	 * standard containers without heap allocation.
+	 */
+	static constexpr std::size_t BUFFER_SIZE { 4 * sizeof(void*) };
+
+	/**
+	 * \brief Construct an object in \c buffer if it fits, otherwise on the
+	 * heap.
+	 *
+	 * \tparam M    Type of the object to construct
+	 * \tparam Args Types of the constructor arguments
+	 *
+	 * \param[in] buffer Buffer to construct the object in
+	 * \param[in] args   Constructor arguments
+	 *
+	 * \return The constructed object
+	 */
+	template <class M, class... Args>
+	static Concept* construct(void* buffer, Args&&... args) noexcept
+	{
+		if (sizeof(M) <= BUFFER_SIZE
+				&& alignof(M) <= alignof(std::max_align_t))
+		{
+			return new (buffer) M(std::forward<Args>(args)...);
+		}
+
+		return new M(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * \brief TRUE iff the wrapped object resides in the internal buffer.
+	 *
+	 * \return TRUE iff the wrapped object resides in the internal buffer
+	 */
+	bool in_buffer() const noexcept
+	{
+		return static_cast<const void*>(object_)
+			== static_cast<const void*>(buffer_);
+	}
+
+	/**
+	 * \brief Destroy the wrapped object.
+	 */
+	void destroy() noexcept
+	{
+		if (!object_)
+		{
+			return;
+		}
+
+		if (in_buffer())
+		{
+			object_->~Concept();
+		} else
+		{
+			delete object_;
+		}
+
+		object_ = nullptr;
+	}
+
+	/**
+	 * \brief Take the wrapped object of \c rhs, leaving \c rhs empty.
+	 *
+	 * The instance is expected to be empty.
+	 *
+	 * \param[in] rhs Instance to take the wrapped object from
+	 */
+	void take(SampleInputIterator& rhs) noexcept
+	{
+		if (rhs.in_buffer())
+		{
+			object_ = rhs.object_->move_to(buffer_);
+			rhs.destroy();
+		} else
+		{
+			object_ = rhs.object_;
+			rhs.object_ = nullptr;
+		}
+	}
+
+	/**
+	 * \brief Internal buffer for wrapped objects that are small enough.
+	 */
+	alignas(std::max_align_t) unsigned char buffer_[BUFFER_SIZE];
+
+	/**
+	 * \brief Internal representation of wrapped object.
+	 *
+	 * Either resides in buffer_ or on the heap.
 	 */
-	std::unique_ptr<Concept> object_;
+	Concept* object_;
 };
 
 
@@ -514,6 +778,24 @@ std::string to_string(const Context& c) noexcept;
  */
 bool any(const Context& c) noexcept;
 
+/**
+ * \brief Level of time measurement in a Calculation.
+ *
+ * Measuring time requires to read a clock before and after each measured
+ * operation. On x86 CPUs with an invariant time stamp counter, the counter is
+ * read instead of a system clock which is considerably cheaper. However, with
+ * small blocks of samples the clock reads may still reduce the throughput.
+ *
+ * If the library is compiled with \c LIBARCSTK_NO_TIMING defined, no time is
+ * measured regardless of the level.
+ */
+enum class Timing : unsigned
+{
+	OFF    = 0, // do not measure any time
+	COARSE = 1, // measure each Calculation::update() as a whole
+	FINE   = 2  // additionally measure each update of the Algorithm
+};
+
 /**
  * \brief Settings for a Calculation.
  */
@@ -524,6 +806,16 @@ class Settings final : public Comparable<Settings>
 	 */
 	Context context_;
 
+	/**
+	 * \brief Internal number of threads.
+	 */
+	unsigned threads_;
+
+	/**
+	 * \brief Internal level of time measurement.
+	 */
+	Timing timing_;
+
 public:
 
 	/**
@@ -554,27 +846,63 @@ public:
 	 */
 	Context context() const;
 
+	/**
+	 * \brief Set the number of threads to calculate contiguous sample blocks.
+	 *
+	 * Updating by a contiguous block of samples is split in up to \c threads
+	 * shards of consecutive samples that are processed in parallel. Blocks that
+	 * are too small to profit from parallel processing are not split.
+	 *
+	 * A value of \c 0 indicates to use as many threads as the hardware
+	 * supports. The default is \c 1, which means to process any block in the
+	 * calling thread.
+	 *
+	 * \param[in] threads Maximum number of threads to use
+	 */
+	void set_threads(const unsigned threads);
+
+	/**
+	 * \brief Number of threads to calculate contiguous sample blocks.
+	 *
+	 * \return Maximum number of threads to use, \c 0 means hardware dependent
+	 */
+	unsigned threads() const;
+
+	/**
+	 * \brief Set the level of time measurement.
+	 *
+	 * With Timing::OFF, Calculation::update_time_elapsed() and
+	 * Calculation::algo_time_elapsed() will remain zero. With Timing::COARSE,
+	 * only Calculation::update_time_elapsed() is measured. The default is
+	 * Timing::FINE.
+	 *
+	 * \param[in] timing Level of time measurement
+	 */
+	void set_timing(const Timing timing);
+
+	/**
+	 * \brief Level of time measurement.
+	 *
+	 * \return Level of time measurement
+	 */
+	Timing timing() const;
+
 	friend void swap(Settings& lhs, Settings& rhs) noexcept
 	{
 		using std::swap;
 		swap(lhs.context_, rhs.context_);
+		swap(lhs.threads_, rhs.threads_);
+		swap(lhs.timing_,  rhs.timing_);
 	}
 
 	friend bool operator == (const Settings& lhs, const Settings& rhs) noexcept
 	{
-		return lhs.context_ == rhs.context_;
+		return lhs.context_ == rhs.context_ && lhs.threads_ == rhs.threads_
+			&& lhs.timing_ == rhs.timing_;
 	}
 };
 
 
-/**
- * \brief Set of checksum types.
- *
- * Guaranteed to be iterable and duplicate-free.
- */
-using ChecksumtypeSet = std::unordered_set<checksum::type>;
-
-
 /**
  * \brief List of split points within a range of samples.
  *
@@ -641,6 +969,20 @@ public:
 	std::pair<int32_t,int32_t> range(const AudioSize& size,
 			const Points& points) const;
 
+	/**
+	 * \brief Prepare the instance for an input of the specified size and
+	 * offset points.
+	 *
+	 * Called on construction of a Calculation and whenever the size of its
+	 * input is updated, which may happen after the first update(). Hence, an
+	 * implementation must not change the position of the instance within the
+	 * input.
+	 *
+	 * \param[in] size   The input size of samples to process
+	 * \param[in] points The offset points in number of PCM samples
+	 */
+	void prepare(const AudioSize& size, const Points& points);
+
 	/**
 	 * \brief Update with a sequence of samples.
 	 *
@@ -649,6 +991,18 @@ public:
 	 */
 	void update(SampleInputIterator start, SampleInputIterator stop);
 
+	/**
+	 * \brief Update with a contiguous sequence of samples.
+	 *
+	 * This bypasses the type erasure of SampleInputIterator and is therefore
+	 * the preferred way to update with samples that reside in a contiguous
+	 * buffer.
+	 *
+	 * \param[in] start Pointer to the first sample of the sequence
+	 * \param[in] stop  Pointer behind the last sample of the sequence
+	 */
+	void update(const sample_t* start, const sample_t* stop);
+
 	/**
 	 * \brief Mark current track as finished.
 	 *
@@ -681,6 +1035,69 @@ public:
 	 */
 	std::unique_ptr<Algorithm> clone() const;
 
+	/**
+	 * \brief Continue the calculation within a track.
+	 *
+	 * Lets the next sample passed to update() be the sample with 0-based index
+	 * \c index within track \c t. This is required for calculations on a
+	 * sub-range of the input that starts within a track.
+	 *
+	 * \param[in] t     1-based number of the track
+	 * \param[in] index 0-based index of the next sample within track \c t
+	 *
+	 * \throws std::logic_error If the algorithm does not support partial
+	 * calculations
+	 */
+	void seek(const int t, const int32_t index);
+
+	/**
+	 * \brief Reset the instance to its initial state.
+	 *
+	 * Discards the state of the current calculation, which lets the instance
+	 * be reused for another input. The Settings are kept but have to be set
+	 * again to set up the instance.
+	 *
+	 * \throws std::logic_error If the algorithm does not support to be reset
+	 */
+	void reset();
+
+	/**
+	 * \brief Merge the checksums of two adjacent parts of a track.
+	 *
+	 * \param[in] lhs     Checksums of the first part of the track
+	 * \param[in] rhs     Checksums of the subsequent part of the track
+	 * \param[in] samples Number of samples in the subsequent part
+	 *
+	 * \return Checksums of both parts
+	 *
+	 * \throws std::logic_error If the algorithm does not support partial
+	 * calculations
+	 */
+	ChecksumSet merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+			const int32_t samples) const;
+
+	/**
+	 * \brief Write the current state of the algorithm to a checkpoint.
+	 *
+	 * \param[in,out] out Writer to write the state to
+	 *
+	 * \throws std::logic_error If the algorithm does not support checkpoints
+	 */
+	void save(CheckpointWriter& out) const;
+
+	/**
+	 * \brief Restore the state of the algorithm from a checkpoint.
+	 *
+	 * The algorithm has to be set up with the same settings as the algorithm
+	 * the state was saved from.
+	 *
+	 * \param[in,out] in Reader to read the state from
+	 *
+	 * \throws std::logic_error If the algorithm does not support checkpoints
+	 * \throws std::invalid_argument If the state could not be read
+	 */
+	void restore(CheckpointReader& in);
+
 protected:
 
 	/**
@@ -690,6 +1107,27 @@ protected:
 	 */
 	void base_swap(Algorithm& rhs);
 
+	/**
+	 * \brief Implementation of update() with a sequence of samples.
+	 *
+	 * \param[in] begin Iterator pointing to the first sample of the sequence
+	 * \param[in] end   Iterator pointing behind the last sample of the sequence
+	 */
+	virtual void do_update(SampleInputIterator begin, SampleInputIterator end)
+	= 0;
+
+	/**
+	 * \brief Implementation of update() with a contiguous sequence of samples.
+	 *
+	 * The default implementation passes the samples to the overload for
+	 * SampleInputIterators. A subclass that only overrides the latter can make
+	 * this overload visible by <tt>using Algorithm::do_update;</tt>.
+	 *
+	 * \param[in] begin Pointer to the first sample of the sequence
+	 * \param[in] end   Pointer behind the last sample of the sequence
+	 */
+	virtual void do_update(const sample_t* begin, const sample_t* end);
+
 private:
 
 	virtual void do_setup(const Settings* s)
@@ -699,8 +1137,7 @@ private:
 			const Points& points) const
 	= 0;
 
-	virtual void do_update(SampleInputIterator begin, SampleInputIterator end)
-	= 0;
+	virtual void do_prepare(const AudioSize& size, const Points& points);
 
 	virtual void do_track_finished(const int t, const AudioSize& length)
 	= 0;
@@ -714,6 +1151,17 @@ private:
 	virtual std::unique_ptr<Algorithm> do_clone() const
 	= 0;
 
+	virtual void do_seek(const int t, const int32_t index);
+
+	virtual void do_reset();
+
+	virtual ChecksumSet do_merge(const ChecksumSet& lhs,
+			const ChecksumSet& rhs, const int32_t samples) const;
+
+	virtual void do_save(CheckpointWriter& out) const;
+
+	virtual void do_restore(CheckpointReader& in);
+
 	/**
 	 * \brief Internal settings of the algorithm.
 	 */
@@ -723,6 +1171,20 @@ private:
 #pragma GCC diagnostic pop
 
 
+/**
+ * \brief Callback to notify about a finished track.
+ *
+ * The callback is called with the 1-based number of the track and its
+ * checksums. It is called by the thread that called Calculation::update().
+ * Exceptions thrown by the callback are passed to the caller of update().
+ * In this case, update() returns immediately after the track notified, leaving
+ * the rest of the block unprocessed. The calculation can be continued by
+ * passing the samples from Calculation::current_offset() on.
+ */
+using TrackCallback = std::function<void(const int track,
+		const ChecksumSet& checksums)>;
+
+
 /**
  * \brief Perform checksums calculation.
  *
@@ -774,6 +1236,32 @@ public:
 	Calculation(const Settings& settings, std::unique_ptr<Algorithm> algorithm,
 			const ToCData& toc);
 
+	/**
+	 * \brief Constructor for a partial calculation.
+	 *
+	 * The Calculation processes only the samples from index \c first to index
+	 * \c last of the input. It expects to be updated with these samples only.
+	 * Partial calculations of adjacent sub-ranges can be merged to the
+	 * Checksums of the entire input.
+	 *
+	 * \param[in] settings  The settings for the calculation
+	 * \param[in] algorithm The algorithm to use for calculating
+	 * \param[in] size      Size of the entire input
+	 * \param[in] points    Track offsets (as samples)
+	 * \param[in] first     0-based index of the first sample to process
+	 * \param[in] last      0-based index of the last sample to process
+	 *
+	 * \throws std::invalid_argument If \c size is zero or the sub-range is
+	 * illegal or contains no samples to calculate
+	 * \throws std::logic_error If the algorithm does not support partial
+	 * calculations
+	 *
+	 * \see merge()
+	 */
+	Calculation(const Settings& settings, std::unique_ptr<Algorithm> algorithm,
+			const AudioSize& size, const Points& points, const int32_t first,
+			const int32_t last);
+
 	/**
 	 * \brief Copy constructor.
 	 *
@@ -872,9 +1360,31 @@ public:
 	 */
 	int32_t samples_todo() const noexcept;
 
+	/**
+	 * \brief Returns the 0-based index of the next sample expected by update().
+	 *
+	 * This is the number of samples passed to update() so far, including the
+	 * samples not processed by the Algorithm.
+	 *
+	 * \return Index of the next sample expected
+	 */
+	int32_t current_offset() const noexcept;
+
+	/**
+	 * \brief Returns the sub-range of the input this instance processes.
+	 *
+	 * For a Calculation on the entire input, the last sample is the maximum
+	 * value of \c int32_t.
+	 *
+	 * \return 0-based indices of the first and the last sample
+	 */
+	std::pair<int32_t, int32_t> subrange() const noexcept;
+
 	/**
 	 * \brief Amount of time elapsed so far by update().
 	 *
+	 * Requires Timing::COARSE or Timing::FINE in the Settings.
+	 *
 	 * \return Amount of time elapsed so far by update().
 	 */
 	std::chrono::duration<float> update_time_elapsed() const noexcept;
@@ -882,6 +1392,8 @@ public:
 	/**
 	 * \brief Amount of time elapsed so far by the algorithm instance.
 	 *
+	 * Requires Timing::FINE in the Settings.
+	 *
 	 * \return Amount of time elapsed so far by the algorithm instance.
 	 */
 	std::chrono::duration<float> algo_time_elapsed() const noexcept;
@@ -905,10 +1417,25 @@ public:
 	 */
 	void update(SampleInputIterator start, SampleInputIterator stop);
 
+	/**
+	 * \brief Update with a contiguous sequence of samples.
+	 *
+	 * Equivalent to update(SampleInputIterator, SampleInputIterator) but
+	 * avoids the per-sample virtual dispatch of SampleInputIterator. Prefer
+	 * this overload whenever the samples reside in a contiguous buffer.
+	 *
+	 * \param[in] start Pointer to the first sample of the sequence
+	 * \param[in] stop  Pointer behind the last sample of the sequence
+	 */
+	void update(const sample_t* start, const sample_t* stop);
+
 	/**
 	 * \brief Update the instance with a new AudioSize.
 	 *
 	 * This can be done safely at any time before the last call of update().
+	 * The legal range of samples is recomputed from the updated AudioSize.
+	 * As long as the size is unknown, the samples are calculated as if the
+	 * input had the maximal size of a CDDA disc.
 	 *
 	 * \param[in] audiosize The updated AudioSize
 	 */
@@ -921,6 +1448,78 @@ public:
 	 */
 	Checksums result() const noexcept;
 
+	/**
+	 * \brief Move the resulting Checksums out of the Calculation.
+	 *
+	 * Avoids copying the result. Afterwards, result() and take_result() will
+	 * not return the Checksums taken.
+	 *
+	 * \return The computed Checksums
+	 */
+	Checksums take_result() noexcept;
+
+	/**
+	 * \brief Register a callback to notify about each finished track.
+	 *
+	 * The callback is called by update() as soon as a track is finished, thus
+	 * the Checksums of a track can be processed while the subsequent tracks are
+	 * still being calculated. Every track is notified before any subsequent
+	 * samples are processed, hence if the callback throws, no track already
+	 * finished remains unnotified. A previously registered callback is replaced.
+	 * Passing an empty callback removes the registered callback.
+	 *
+	 * \param[in] callback Callback to call for each finished track
+	 */
+	void set_track_callback(TrackCallback callback);
+
+	/**
+	 * \brief Save the current state of the calculation.
+	 *
+	 * The checkpoint is a versioned binary representation of the counters,
+	 * the Checksums of the finished tracks and the state of the Algorithm. It
+	 * does not contain the elapsed times.
+	 *
+	 * \return Checkpoint of the current state
+	 *
+	 * \throws std::logic_error If the Algorithm does not support checkpoints
+	 */
+	std::vector<uint8_t> checkpoint() const;
+
+	/**
+	 * \brief Restore the state of the calculation from a checkpoint.
+	 *
+	 * The instance has to be created with the same type of Algorithm, the same
+	 * Context, the same track offsets and the same sub-range of samples as the
+	 * Calculation the checkpoint was created from. If the total number of
+	 * samples was updated before the checkpoint was created, it is restored as
+	 * well.
+	 *
+	 * After the restore, the calculation is to be continued by passing the
+	 * samples from current_offset() on.
+	 *
+	 * \param[in] checkpoint Checkpoint created by checkpoint()
+	 *
+	 * \throws std::invalid_argument If the checkpoint is invalid or does not
+	 * match this instance
+	 * \throws std::logic_error If the Algorithm does not support checkpoints
+	 */
+	void restore(const std::vector<uint8_t>& checkpoint);
+
+	/**
+	 * \brief Reset the instance for calculating another input.
+	 *
+	 * The Settings, the Algorithm and the track callback are kept while the
+	 * state and the result of the current calculation are discarded. A partial
+	 * calculation is reset to a calculation of the entire input. This avoids
+	 * to create a new Calculation and Algorithm for each input.
+	 *
+	 * \param[in] size   Size of the expected input
+	 * \param[in] points Track offsets (as samples)
+	 *
+	 * \throws std::logic_error If the Algorithm does not support to be reset
+	 */
+	void reset(const AudioSize& size, const Points& points);
+
 	/**
 	 * \brief Swap the instance with another instance.
 	 *
@@ -932,6 +1531,8 @@ public:
 	{
 		lhs.swap(rhs);
 	}
+
+	friend Checksums merge(const std::vector<const Calculation*>& partials);
 };
 
 
@@ -947,6 +1548,57 @@ public:
 std::unique_ptr<Calculation> make_calculation(
 		std::unique_ptr<Algorithm> algorithm, const ToC& toc);
 
+/**
+ * \brief Create a partial Calculation from an Algorithm and a ToC.
+ *
+ * The Calculation processes only the samples from index \c first to index
+ * \c last of the input. This allows to calculate a single input on multiple
+ * processes or nodes and to merge the results.
+ *
+ * \param[in] algorithm The algorithm to use for calculating
+ * \param[in] toc       Complete ToC to perform calculation for
+ * \param[in] first     0-based index of the first sample to process
+ * \param[in] last      0-based index of the last sample to process
+ *
+ * \throws std::invalid_argument If the ToC is not complete or the sub-range
+ * is illegal
+ * \throws std::logic_error If the algorithm does not support partial
+ * calculations
+ *
+ * \see merge()
+ */
+std::unique_ptr<Calculation> make_calculation(
+		std::unique_ptr<Algorithm> algorithm, const ToC& toc,
+		const int32_t first, const int32_t last);
+
+/**
+ * \brief Merge partial calculations to the Checksums of the entire input.
+ *
+ * The partial calculations have to be complete and must use the same type of
+ * Algorithm on the same input. Their sub-ranges must be adjacent and cover
+ * the entire input, but may be passed in any order.
+ *
+ * The Checksums of parts of the same track are merged by the Algorithm. For the
+ * AccurateRip checksums, this is just the sum of the parts. A CRC32 of the
+ * first part is combined with the CRC32 of the subsequent part.
+ *
+ * Partial calculations performed on other nodes are transferred as
+ * checkpoints: the node calculating a sub-range passes its checkpoint() to the
+ * merging node, which restores it into a partial Calculation with the same
+ * Algorithm, ToC and sub-range. The restored Calculation is then passed to
+ * merge(). Restoring a checkpoint into a Calculation with another sub-range is
+ * rejected.
+ *
+ * \param[in] partials Complete partial calculations
+ *
+ * \return Checksums of the entire input
+ *
+ * \throws std::invalid_argument If the partial calculations can not be merged
+ * \throws std::logic_error If the algorithm does not support partial
+ * calculations
+ */
+Checksums merge(const std::vector<const Calculation*>& partials);
+
 /** @} */
 
 } // namespace v_1_0_0
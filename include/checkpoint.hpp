@@ -0,0 +1,195 @@
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#define __LIBARCSTK_CHECKPOINT_HPP__
+
+/**
+ * \file
+ *
+ * \brief Binary representation of the state of a Calculation.
+ */
+
+#include <cstddef>          // for size_t
+#include <cstdint>          // for int32_t, uint8_t, uint32_t, uint64_t
+#include <vector>           // for vector
+
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"     // for ChecksumSet
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+/** \addtogroup calc */
+/** @{ */
+
+/**
+ * \brief Version of the checkpoint format.
+ *
+ * A checkpoint of another version can not be restored.
+ */
+constexpr uint32_t CHECKPOINT_VERSION { 2 };
+
+
+/**
+ * \brief Writes the state of a Calculation to a checkpoint.
+ *
+ * All values are written in little endian byte order.
+ *
+ * \see Calculation::checkpoint()
+ */
+class CheckpointWriter final
+{
+public:
+
+	/**
+	 * \brief Default constructor.
+	 */
+	CheckpointWriter();
+
+	/**
+	 * \brief Append an unsigned 32 bit integer.
+	 *
+	 * \param[in] value Value to append
+	 */
+	void write_u32(const uint32_t value);
+
+	/**
+	 * \brief Append an unsigned 64 bit integer.
+	 *
+	 * \param[in] value Value to append
+	 */
+	void write_u64(const uint64_t value);
+
+	/**
+	 * \brief Append a signed 32 bit integer.
+	 *
+	 * \param[in] value Value to append
+	 */
+	void write_i32(const int32_t value);
+
+	/**
+	 * \brief Append a ChecksumSet.
+	 *
+	 * \param[in] checksums ChecksumSet to append
+	 */
+	void write(const ChecksumSet& checksums);
+
+	/**
+	 * \brief Bytes written so far.
+	 *
+	 * \return Bytes written so far
+	 */
+	const std::vector<uint8_t>& data() const noexcept;
+
+	/**
+	 * \brief Move the bytes written out of the instance.
+	 *
+	 * \return Bytes written
+	 */
+	std::vector<uint8_t> release() noexcept;
+
+private:
+
+	/**
+	 * \brief Bytes written.
+	 */
+	std::vector<uint8_t> data_;
+};
+
+
+/**
+ * \brief Reads the state of a Calculation from a checkpoint.
+ *
+ * The reader does not own the checkpoint data.
+ *
+ * \see Calculation::restore()
+ */
+class CheckpointReader final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] data Pointer to the first byte of the checkpoint
+	 * \param[in] size Size of the checkpoint in bytes
+	 */
+	CheckpointReader(const uint8_t* data, const std::size_t size);
+
+	CheckpointReader(const CheckpointReader& rhs) = default;
+	CheckpointReader& operator=(const CheckpointReader& rhs) = default;
+
+	/**
+	 * \brief Read an unsigned 32 bit integer.
+	 *
+	 * \return Value read
+	 *
+	 * \throws std::invalid_argument If the checkpoint is exhausted
+	 */
+	uint32_t read_u32();
+
+	/**
+	 * \brief Read an unsigned 64 bit integer.
+	 *
+	 * \return Value read
+	 *
+	 * \throws std::invalid_argument If the checkpoint is exhausted
+	 */
+	uint64_t read_u64();
+
+	/**
+	 * \brief Read a signed 32 bit integer.
+	 *
+	 * \return Value read
+	 *
+	 * \throws std::invalid_argument If the checkpoint is exhausted
+	 */
+	int32_t read_i32();
+
+	/**
+	 * \brief Read a ChecksumSet.
+	 *
+	 * \return ChecksumSet read
+	 *
+	 * \throws std::invalid_argument If the checkpoint is exhausted or contains
+	 * an unknown checksum type
+	 */
+	ChecksumSet read_checksums();
+
+	/**
+	 * \brief Number of bytes not yet read.
+	 *
+	 * \return Number of bytes not yet read
+	 */
+	std::size_t remaining() const noexcept;
+
+private:
+
+	/**
+	 * \brief Ensure that at least \c n bytes are not yet read.
+	 *
+	 * \param[in] n Number of bytes to read next
+	 *
+	 * \throws std::invalid_argument If less than \c n bytes remain
+	 */
+	void require(const std::size_t n) const;
+
+	/**
+	 * \brief Next byte to read.
+	 */
+	const uint8_t* pos_;
+
+	/**
+	 * \brief Behind the last byte of the checkpoint.
+	 */
+	const uint8_t* end_;
+};
+
+/** @} */
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
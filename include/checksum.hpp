@@ -8,14 +8,18 @@
  */
 
 #include <array>            // for array
+#include <cstddef>          // for size_t, ptrdiff_t
 #include <cstdint>          // for int32_t, uint32_t
 #include <initializer_list> // for initializer_list
 #include <iomanip>          // for setfill, setw
+#include <iterator>         // for forward_iterator_tag
 #include <ostream>          // for ostream
 #include <sstream>          // for ostringstream
 #include <set>              // for set
-#include <unordered_map>    // for unordered_map
-#include <utility>          // for pair
+#include <tuple>            // for tuple_size
+#include <type_traits>      // for underlying_type_t, conditional_t
+#include <unordered_set>    // for unordered_set
+#include <utility>          // for pair, index_sequence
 #include <string>           // for string
 #include <vector>           // for vector
 
@@ -151,14 +155,26 @@ namespace checksum
 /**
  * \brief Pre-defined checksum types.
  *
- * ARCS1 is AccurateRip v1 and ARCS2 is AccurateRip v2.
+ * ARCS1 is AccurateRip v1 and ARCS2 is AccurateRip v2. FRAME450 is the
+ * AccurateRip v1 checksum of frame 450 of a track that AccurateRip uses for
+ * offset detection.
+ *
+ * CRC32 is the CRC32 of the track as EAC reports it as "copy CRC". CRC32ns is
+ * the same CRC32 with every 16 bit sample of value 0 skipped, as EAC reports
+ * it for "without null samples". CTDB is the CRC32 of the disc as used by the
+ * CUETools database: it omits the first and the last 10 frames of the disc
+ * and is accumulated over the tracks. Since it is the checksum of the disc, it
+ * is only reported for the last track.
  */
 enum class type : unsigned int
 {
-	ARCS1   = 1,
-	ARCS2   = 2
-	//THIRD_TYPE  = 4,
-	//FOURTH_TYPE = 8 ...
+	ARCS1    = 1,
+	ARCS2    = 2,
+	FRAME450 = 4,
+	CRC32    = 8,
+	CRC32ns  = 16,
+	CTDB     = 32
+	//SEVENTH_TYPE = 64 ...
 };
 
 
@@ -168,11 +184,14 @@ enum class type : unsigned int
  * The order of the types is identical to the total order of numeric values the
  * types have in enum class checksum::type.
  */
-static const std::array<type, 2> types = {
+static const std::array<type, 6> types = {
 	type::ARCS1,
-	type::ARCS2
-	// type::THIRD_TYPE,
-	// type::FOURTH_TYPE ...
+	type::ARCS2,
+	type::FRAME450,
+	type::CRC32,
+	type::CRC32ns,
+	type::CTDB
+	// type::SEVENTH_TYPE ...
 };
 
 
@@ -185,9 +204,321 @@ static const std::array<type, 2> types = {
  */
 std::string type_name(const type t);
 
+/**
+ * \brief Number of predefined checksum types.
+ */
+constexpr std::size_t number_of_types { std::tuple_size<decltype(types)>::value };
+
 } // namespace checksum
 
 
+/**
+ * \brief Set of checksum types.
+ *
+ * Guaranteed to be iterable and duplicate-free. The types are represented as a
+ * bitmask of their numeric values, hence the set does not allocate and
+ * iterates the types in the order of their numeric values.
+ *
+ * The interface follows std::unordered_set and a ChecksumtypeSet converts from
+ * and to std::unordered_set<checksum::type> implicitly.
+ *
+ * \note The class does not derive from Comparable to avoid the virtual
+ * destructor, thus an instance has the size of its bitmask.
+ */
+class ChecksumtypeSet final
+{
+public:
+
+	/**
+	 * \brief Value type of the ChecksumtypeSet.
+	 */
+	using value_type = checksum::type;
+
+	/**
+	 * \brief Size type (unsigned integral type).
+	 */
+	using size_type  = std::size_t;
+
+	/**
+	 * \brief Bitmask type of the ChecksumtypeSet.
+	 */
+	using mask_type  = std::underlying_type_t<checksum::type>;
+
+	/**
+	 * \brief Forward iterator over the types in a ChecksumtypeSet.
+	 *
+	 * Dereferencing yields the type by value.
+	 */
+	class const_iterator final
+	{
+		/**
+		 * \brief Types not yet visited.
+		 */
+		mask_type remaining_;
+
+	public:
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = checksum::type;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const checksum::type*;
+		using reference         = checksum::type;
+
+		/**
+		 * \brief Constructor.
+		 *
+		 * \param[in] remaining Bitmask of types not yet visited
+		 */
+		explicit const_iterator(const mask_type remaining) noexcept
+			: remaining_ { remaining }
+		{
+			// empty
+		}
+
+		reference operator * () const noexcept
+		{
+			// Lowest bit set
+			return static_cast<checksum::type>(remaining_ & (~remaining_ + 1));
+		}
+
+		const_iterator& operator ++ () noexcept
+		{
+			remaining_ &= remaining_ - 1; // Clear lowest bit set
+			return *this;
+		}
+
+		const_iterator operator ++ (int) noexcept
+		{
+			const auto prev { *this };
+			++(*this);
+			return prev;
+		}
+
+		friend bool operator == (const const_iterator& lhs,
+				const const_iterator& rhs) noexcept
+		{
+			return lhs.remaining_ == rhs.remaining_;
+		}
+
+		friend bool operator != (const const_iterator& lhs,
+				const const_iterator& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+	};
+
+	/**
+	 * \brief Iterator type, identical to const_iterator.
+	 */
+	using iterator = const_iterator;
+
+	/**
+	 * \brief Constructor for an empty set.
+	 */
+	ChecksumtypeSet() noexcept;
+
+	/**
+	 * \brief Constructor for a known set of types.
+	 *
+	 * \param[in] types Types to contain
+	 */
+	ChecksumtypeSet(std::initializer_list<checksum::type> types) noexcept;
+
+	/**
+	 * \brief Constructor for the types in a range.
+	 *
+	 * \param[in] first Iterator to the first type to contain
+	 * \param[in] last  Iterator behind the last type to contain
+	 */
+	template <typename InputIt>
+	ChecksumtypeSet(InputIt first, InputIt last)
+		: mask_ { 0 }
+	{
+		this->insert(first, last);
+	}
+
+	/**
+	 * \brief Converting constructor for a std::unordered_set of types.
+	 *
+	 * \param[in] types Types to contain
+	 */
+	ChecksumtypeSet(const std::unordered_set<checksum::type>& types) noexcept;
+
+	/**
+	 * \brief Convert to a std::unordered_set of the types contained.
+	 *
+	 * \return The types contained in the instance
+	 */
+	operator std::unordered_set<checksum::type>() const;
+
+	/**
+	 * \brief Returns the number of types contained in the instance.
+	 *
+	 * \return Number of types contained in the instance
+	 */
+	size_type size() const noexcept;
+
+	/**
+	 * \brief Returns \c TRUE iff the instance contains no types, otherwise
+	 * \c FALSE.
+	 *
+	 * \return \c TRUE iff instance contains no types, otherwise \c FALSE
+	 */
+	bool empty() const noexcept;
+
+	/**
+	 * \brief Returns \c TRUE iff the instance contains \c type.
+	 *
+	 * \param[in] type The type to lookup
+	 *
+	 * \return \c TRUE iff \c type is present in the instance, otherwise \c FALSE
+	 */
+	bool contains(const checksum::type type) const noexcept;
+
+	/**
+	 * \brief Returns the number of occurrences of \c type.
+	 *
+	 * \param[in] type The type to lookup
+	 *
+	 * \return 1 iff \c type is present in the instance, otherwise 0
+	 */
+	size_type count(const checksum::type type) const noexcept;
+
+	/**
+	 * \brief Find a type in the instance.
+	 *
+	 * \param[in] type The type to lookup
+	 *
+	 * \return Iterator to \c type iff present, otherwise end()
+	 */
+	const_iterator find(const checksum::type type) const noexcept;
+
+	/**
+	 * \brief Inserts a type to the instance.
+	 *
+	 * \param[in] type The type to insert
+	 *
+	 * \return Pair with an iterator to the type and a flag that is \c TRUE iff
+	 * the type was inserted
+	 */
+	std::pair<const_iterator, bool> insert(const checksum::type type) noexcept;
+
+	/**
+	 * \brief Inserts the types in a range to the instance.
+	 *
+	 * \param[in] first Iterator to the first type to insert
+	 * \param[in] last  Iterator behind the last type to insert
+	 */
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+		{
+			this->insert(*first);
+		}
+	}
+
+	/**
+	 * \brief Inserts a sequence of types to the instance.
+	 *
+	 * \param[in] types The types to insert
+	 */
+	void insert(std::initializer_list<checksum::type> types) noexcept;
+
+	/**
+	 * \brief Inserts a type to the instance.
+	 *
+	 * Identical to insert() since a type is constructed by its value.
+	 *
+	 * \param[in] type The type to insert
+	 *
+	 * \return Pair with an iterator to the type and a flag that is \c TRUE iff
+	 * the type was inserted
+	 */
+	std::pair<const_iterator, bool> emplace(const checksum::type type) noexcept;
+
+	/**
+	 * \brief Erases a type from the instance.
+	 *
+	 * \param[in] type The type to erase
+	 *
+	 * \return Number of types erased
+	 */
+	size_type erase(const checksum::type type) noexcept;
+
+	/**
+	 * \brief Erases the type at the specified position from the instance.
+	 *
+	 * \param[in] pos Iterator to the type to erase
+	 *
+	 * \return Iterator to the type following the type erased
+	 */
+	const_iterator erase(const_iterator pos) noexcept;
+
+	/**
+	 * \brief Erases all types contained in the instance.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * \brief Bitmask of the types contained in the instance.
+	 *
+	 * \return Bitwise OR of the numeric values of the types contained
+	 */
+	mask_type mask() const noexcept;
+
+	/**
+	 * \brief Obtain an iterator to the first type.
+	 *
+	 * \return Iterator to the first type
+	 */
+	const_iterator cbegin() const noexcept;
+
+	/**
+	 * \brief Obtain an iterator pointing behind the last type.
+	 *
+	 * \return Iterator pointing behind the last type
+	 */
+	const_iterator cend() const noexcept;
+
+	/**
+	 * \copydoc cbegin()
+	 */
+	const_iterator begin() const noexcept;
+
+	/**
+	 * \copydoc cend()
+	 */
+	const_iterator end() const noexcept;
+
+
+	friend bool operator == (const ChecksumtypeSet& lhs,
+			const ChecksumtypeSet& rhs) noexcept
+	{
+		return lhs.mask_ == rhs.mask_;
+	}
+
+	friend bool operator != (const ChecksumtypeSet& lhs,
+			const ChecksumtypeSet& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+	friend void swap(ChecksumtypeSet& lhs, ChecksumtypeSet& rhs) noexcept
+	{
+		using std::swap;
+		swap(lhs.mask_, rhs.mask_);
+	}
+
+private:
+
+	/**
+	 * \brief Bitwise OR of the numeric values of the types contained.
+	 */
+	mask_type mask_;
+};
+
+
 /**
  * \brief A set of Checksum instances of different types for a single track.
  *
@@ -212,11 +543,151 @@ private:
 	 */
 	using key_type = checksum::type;
 
+	/**
+	 * \internal
+	 * \brief Type of an entry in the internal storage of the ChecksumSet.
+	 */
+	using entry_type = std::pair<const key_type, value_type>;
+
 	/**
 	 * \internal
 	 * \brief Type of the internal storage of the ChecksumSet.
+	 *
+	 * Each predefined type has a fixed entry in the order of the numeric
+	 * values of the types, hence the key of an entry is never modified. The
+	 * entries of the types not present are skipped by the iterators.
 	 */
-	using storage_type = std::unordered_map<key_type, value_type>;
+	using storage_type = std::array<entry_type, checksum::number_of_types>;
+
+	/**
+	 * \internal
+	 * \brief Forward iterator over the entries of the types present.
+	 *
+	 * \tparam is_const Iff \c TRUE, the Checksums are not modifiable
+	 */
+	template <bool is_const>
+	class Iterator final
+	{
+		// Befriend the converse version of the type: const_iterator can access
+		// private members of iterator (and vice versa)
+		friend Iterator<not is_const>;
+
+	public:
+
+		using iterator_category = std::forward_iterator_tag;
+
+		using value_type        = entry_type;
+
+		using difference_type   = std::ptrdiff_t;
+
+		using pointer           = std::conditional_t<is_const,
+								const entry_type*, entry_type*>;
+
+		using reference         = std::conditional_t<is_const,
+								const entry_type&, entry_type&>;
+
+		/**
+		 * \brief Constructor.
+		 *
+		 * \param[in] entries   Internal storage to iterate
+		 * \param[in] remaining Bitmask of types not yet visited
+		 */
+		Iterator(pointer entries, const ChecksumtypeSet::mask_type remaining)
+			noexcept
+			: entries_   { entries   }
+			, remaining_ { remaining }
+		{
+			// empty
+		}
+
+		/**
+		 * \brief Construct a constant Iterator from a non-constant Iterator.
+		 *
+		 * \param[in] rhs The non-constant Iterator
+		 */
+		Iterator(const Iterator<false>& rhs) noexcept
+			: entries_   { rhs.entries_   } // works due to friendship
+			, remaining_ { rhs.remaining_ }
+		{
+			// empty
+		}
+
+		/**
+		 * \brief Assign a non-constant Iterator to a constant Iterator.
+		 *
+		 * \param[in] rhs The non-constant Iterator
+		 */
+		Iterator& operator = (const Iterator<false>& rhs) noexcept
+		{
+			entries_   = rhs.entries_;
+			remaining_ = rhs.remaining_;
+			return *this;
+		}
+
+		reference operator * () const noexcept
+		{
+			return entries_[this->position()];
+		}
+
+		pointer operator -> () const noexcept
+		{
+			return entries_ + this->position();
+		}
+
+		Iterator& operator ++ () noexcept
+		{
+			remaining_ &= remaining_ - 1; // Clear lowest bit set
+			return *this;
+		}
+
+		Iterator operator ++ (int) noexcept
+		{
+			const auto prev { *this };
+			++(*this);
+			return prev;
+		}
+
+		friend bool operator == (const Iterator& lhs, const Iterator& rhs)
+			noexcept
+		{
+			return lhs.remaining_ == rhs.remaining_;
+		}
+
+		friend bool operator != (const Iterator& lhs, const Iterator& rhs)
+			noexcept
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+
+		/**
+		 * \brief Position of the current entry in the storage.
+		 *
+		 * \return Number of the lowest bit set in the remaining types
+		 */
+		std::size_t position() const noexcept
+		{
+			auto pos = std::size_t { 0 };
+
+			for (auto mask { remaining_ }; (mask & 1u) == 0; mask >>= 1)
+			{
+				++pos;
+			}
+
+			return pos;
+		}
+
+		/**
+		 * \brief Internal storage iterated.
+		 */
+		pointer entries_;
+
+		/**
+		 * \brief Types not yet visited.
+		 */
+		ChecksumtypeSet::mask_type remaining_;
+	};
 
 	/**
 	 * \internal
@@ -224,6 +695,22 @@ private:
 	 */
 	storage_type set_;
 
+	/**
+	 * \internal
+	 * \brief Bitmask of the types present.
+	 */
+	ChecksumtypeSet::mask_type mask_;
+
+	/**
+	 * \internal
+	 * \brief Position of the entry for \c type in the storage.
+	 *
+	 * \param[in] type Type to get the position for
+	 *
+	 * \return Position of the entry for \c type
+	 */
+	static std::size_t index(const key_type type) noexcept;
+
 	/**
 	 * \internal
 	 * \brief Track length as number of LBA frames.
@@ -234,13 +721,16 @@ public:
 
 	/**
 	 * \brief Unspecified forward iterator type.
+	 *
+	 * Dereferencing yields a pair with the type as constant key and the
+	 * Checksum as value.
 	 */
-	using iterator       = storage_type::iterator;
+	using iterator       = Iterator<false>;
 
 	/**
 	 * \brief Unspecified forward iterator type.
 	 */
-	using const_iterator = storage_type::const_iterator;
+	using const_iterator = Iterator<true>;
 
 	/**
 	 * \brief Size type (unsigned integral type)
@@ -270,6 +760,19 @@ public:
 				std::pair<const checksum::type, value_type>> sums);
 	//NOTE We do not expose key_type. If key is not of key_type, it just breaks.
 
+	// copy
+	ChecksumSet(const ChecksumSet& rhs);
+	ChecksumSet& operator = (const ChecksumSet& rhs);
+
+	// move
+	ChecksumSet(ChecksumSet&& rhs) noexcept;
+	ChecksumSet& operator = (ChecksumSet&& rhs) noexcept;
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~ChecksumSet() noexcept;
+
 	/**
 	 * \brief Length (in LBA frames) of this track.
 	 *
@@ -436,16 +939,19 @@ public:
 
 
 	friend bool operator == (const ChecksumSet& lhs, const ChecksumSet& rhs)
-		noexcept
-	{
-		return lhs.length_ == rhs.length_ && lhs.set_ == rhs.set_;
-	}
+		noexcept;
 
 	friend void swap(ChecksumSet& lhs, ChecksumSet& rhs) noexcept
 	{
 		using std::swap;
 		swap(lhs.length_, rhs.length_);
-		swap(lhs.set_,    rhs.set_);
+		swap(lhs.mask_,   rhs.mask_);
+
+		// The keys are fixed, hence only the Checksums are swapped
+		for (auto i = std::size_t { 0 }; i < lhs.set_.size(); ++i)
+		{
+			swap(lhs.set_[i].second, rhs.set_[i].second);
+		}
 	}
 };
 
@@ -480,5 +986,23 @@ extern const Checksums EmptyChecksums;
 } // namespace v_1_0_0
 } // namespace arcstk
 
+
+namespace std
+{
+
+/**
+ * \brief Hash for ChecksumtypeSet.
+ */
+template <>
+struct hash<arcstk::ChecksumtypeSet>
+{
+	std::size_t operator()(const arcstk::ChecksumtypeSet& types) const noexcept
+	{
+		return std::hash<arcstk::ChecksumtypeSet::mask_type>{}(types.mask());
+	}
+};
+
+} // namespace std
+
 #endif
 
@@ -0,0 +1,314 @@
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#define __LIBARCSTK_COMPOSITE_HPP__
+
+/**
+ * \file
+ *
+ * \brief Algorithm for calculating multiple types of checksums in one pass.
+ */
+
+#include <cstdint>          // for int32_t, uint32_t
+#include <memory>           // for unique_ptr
+#include <utility>          // for pair
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"    // for Algorithm, ChecksumtypeSet, Points, ...
+#endif
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"     // for ChecksumSet, checksum::type
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+/** \addtogroup calc */
+/** @{ */
+
+namespace details
+{
+namespace crc
+{
+
+/**
+ * \internal
+ *
+ * \brief Accumulates the CRC32 based checksums of a track and of the disc.
+ *
+ * Only the types CRC32, CRC32ns and CTDB are considered, other types are
+ * ignored.
+ */
+class CRCAccumulator final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] types Checksum types to calculate
+	 */
+	explicit CRCAccumulator(const ChecksumtypeSet& types);
+
+	/**
+	 * \brief Returns TRUE iff no CRC type is calculated.
+	 *
+	 * \return TRUE iff no CRC type is calculated
+	 */
+	bool empty() const noexcept;
+
+	/**
+	 * \brief Update with a contiguous sequence of samples.
+	 *
+	 * \param[in] start Pointer to the first sample of the sequence
+	 * \param[in] stop  Pointer behind the last sample of the sequence
+	 * \param[in] disc  TRUE iff the sequence is covered by the CTDB checksum
+	 */
+	void update(const sample_t* start, const sample_t* stop, const bool disc)
+		noexcept;
+
+	/**
+	 * \brief Add the checksums of the current track to a ChecksumSet and
+	 * start the next track.
+	 *
+	 * The CTDB CRC is a checksum of the disc, hence it is added only for the
+	 * last track.
+	 *
+	 * \param[in,out] checksums ChecksumSet to add the checksums to
+	 * \param[in]     last      TRUE iff the current track is the last track
+	 */
+	void track_finished(ChecksumSet& checksums, const bool last);
+
+	/**
+	 * \brief Returns TRUE iff the checksums of parts of a track can be merged.
+	 *
+	 * The CRC32ns depends on the number of non-null samples of each part and
+	 * the CTDB CRC spans the entire disc, hence they cannot be merged.
+	 *
+	 * \return TRUE iff no CRC32ns and no CTDB is calculated
+	 */
+	bool mergeable() const noexcept;
+
+	/**
+	 * \brief Add the merged checksums of two adjacent parts of a track to a
+	 * ChecksumSet.
+	 *
+	 * \param[in]     lhs     Checksums of the first part of the track
+	 * \param[in]     rhs     Checksums of the subsequent part of the track
+	 * \param[in]     samples Number of samples in the subsequent part
+	 * \param[in,out] merged  ChecksumSet to add the merged checksums to
+	 *
+	 * \throws std::logic_error If the checksums cannot be merged
+	 */
+	void merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+			const int32_t samples, ChecksumSet& merged) const;
+
+	/**
+	 * \brief Reset the instance to its initial state.
+	 */
+	void reset() noexcept;
+
+	/**
+	 * \brief Write the state of this instance to a checkpoint.
+	 *
+	 * \param[in,out] out Writer to write the state to
+	 */
+	void save(CheckpointWriter& out) const;
+
+	/**
+	 * \brief Restore the state of this instance from a checkpoint.
+	 *
+	 * \param[in,out] in Reader to read the state from
+	 */
+	void restore(CheckpointReader& in);
+
+private:
+
+	bool crc32_;             // TRUE iff CRC32 is calculated
+	bool crc32ns_;           // TRUE iff CRC32ns is calculated
+	bool ctdb_;              // TRUE iff CTDB is calculated
+	uint32_t track_crc_;     // CRC32 of the current track
+	uint32_t track_crc_ns_;  // CRC32ns of the current track
+	uint32_t disc_crc_;      // CTDB CRC of the disc so far
+};
+
+} // namespace crc
+} // namespace details
+
+
+/**
+ * \brief Algorithm calculating an arbitrary set of checksum types.
+ *
+ * A CompositeAlgorithm calculates any combination of the AccurateRip checksums
+ * and the CRC32 based checksums in a single pass over the input. Each block
+ * of samples is passed to the AccurateRip algorithm for the requested ARCS
+ * types and to the CRC32 calculation for the requested CRC types. The CRC32
+ * of the track and the CTDB CRC are derived from a single CRC calculation over
+ * each block. The CRC32 with and without null samples are calculated in the
+ * same loop.
+ *
+ * Since the CRC types cover the complete tracks, the range of a Calculation
+ * with a CompositeAlgorithm is not shortened according to the Context if
+ * CRC types are requested. The AccurateRip checksums are nonetheless
+ * calculated over the range the Context implies. The track lengths in the
+ * result then are the complete lengths of the tracks.
+ *
+ * Partial calculations are supported for the ARCS types except FRAME450 and
+ * for CRC32. The CRC32 of adjacent parts of a track is combined from the CRC32
+ * of each part. For CRC32ns, CTDB and FRAME450, seek() and merge() throw.
+ */
+class CompositeAlgorithm final : public Algorithm
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] types Checksum types to calculate
+	 *
+	 * \throws std::invalid_argument If \c types is empty
+	 */
+	explicit CompositeAlgorithm(const ChecksumtypeSet& types);
+
+	/**
+	 * \brief Copy constructor.
+	 *
+	 * \param[in] rhs Instance to copy
+	 */
+	CompositeAlgorithm(const CompositeAlgorithm& rhs);
+
+	/**
+	 * \brief Copy assignment.
+	 *
+	 * \param[in] rhs Right hand side of the assignment
+	 *
+	 * \return This instance with the values of \c rhs
+	 */
+	CompositeAlgorithm& operator=(const CompositeAlgorithm& rhs);
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~CompositeAlgorithm() noexcept override;
+
+private:
+
+	void do_setup(const Settings* s) final;
+
+	std::pair<int32_t, int32_t> do_range(const AudioSize& size,
+			const Points& points) const final;
+
+	void do_prepare(const AudioSize& size, const Points& points) final;
+
+	void do_update(SampleInputIterator start, SampleInputIterator stop) final;
+
+	void do_update(const sample_t* start, const sample_t* stop) final;
+
+	void do_track_finished(const int t, const AudioSize& length) final;
+
+	ChecksumSet do_result() const final;
+
+	ChecksumtypeSet do_types() const final;
+
+	std::unique_ptr<Algorithm> do_clone() const final;
+
+	void do_seek(const int t, const int32_t index) final;
+
+	void do_reset() final;
+
+	ChecksumSet do_merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+			const int32_t samples) const final;
+
+	void do_save(CheckpointWriter& out) const final;
+
+	void do_restore(CheckpointReader& in) final;
+
+	/**
+	 * \brief Checksum types requested.
+	 */
+	ChecksumtypeSet types_;
+
+	/**
+	 * \brief Algorithm for the requested ARCS types, if any.
+	 */
+	std::unique_ptr<Algorithm> arcs_;
+
+	/**
+	 * \brief Accumulator for the requested CRC types.
+	 */
+	details::crc::CRCAccumulator crcs_;
+
+	/**
+	 * \brief Range of the entire calculation and of its parts.
+	 */
+	struct Ranges final
+	{
+		std::pair<int32_t, int32_t> total; // range of the calculation
+		std::pair<int32_t, int32_t> arcs;  // range to pass to the ARCS algo
+		std::pair<int32_t, int32_t> disc;  // range covered by CTDB
+	};
+
+	/**
+	 * \brief Determine the ranges for an input.
+	 *
+	 * \param[in] size   The input size of samples to process
+	 * \param[in] points The offset points in number of PCM samples
+	 *
+	 * \return Ranges for the input
+	 */
+	Ranges ranges(const AudioSize& size, const Points& points) const;
+
+	/**
+	 * \brief Range of samples to pass to the ARCS algorithm.
+	 *
+	 * The range depends on the size of the input and is therefore updated on
+	 * every call of prepare().
+	 */
+	std::pair<int32_t, int32_t> arcs_range_;
+
+	/**
+	 * \brief Range of samples covered by the CTDB checksum.
+	 *
+	 * Updated on every call of prepare().
+	 */
+	std::pair<int32_t, int32_t> disc_range_;
+
+	/**
+	 * \brief Offset points of the input.
+	 *
+	 * Updated on every call of prepare().
+	 */
+	Points points_;
+
+	/**
+	 * \brief Number of the last track of the input.
+	 */
+	int last_track_;
+
+	/**
+	 * \brief 0-based index of the next sample in the input.
+	 *
+	 * Determined by prepare() until the first update() or seek(), then
+	 * advanced by update().
+	 */
+	int32_t index_;
+
+	/**
+	 * \brief TRUE iff the instance has been updated with samples or has been
+	 * positioned by seek().
+	 */
+	bool started_;
+
+	/**
+	 * \brief Current result of performing the algorithm.
+	 */
+	ChecksumSet current_result_;
+};
+
+/** @} */
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
@@ -11,8 +11,10 @@
 #include "policies.hpp"     // for Comparable, IteratorElement
 #endif
 
-#include <cstddef>          // for size_t, nullptr
-#include <cstdint>          // for uint32_t
+#include <algorithm>        // for copy_n, min
+#include <array>            // for array
+#include <cstddef>          // for size_t, nullptr, ptrdiff_t
+#include <cstdint>          // for uint32_t, uint8_t
 #include <initializer_list> // for initializer_list
 #include <istream>          // for istream
 #include <iterator>         // for forward_iterator_tag
@@ -20,6 +22,7 @@
 #include <stdexcept>        // for runtime_error
 #include <string>           // for string
 #include <tuple>            // for tuple
+#include <type_traits>      // for enable_if_t, is_pointer
 #include <utility>          // for pair
 
 namespace arcstk
@@ -40,6 +43,9 @@ class Checksum;
  *
  * Functions parse_stream() and parse_file() can parse a stream to a DBAR
  * object, which provdes access to all values by their respective indices.
+ * Function parse_buffer() parses input that is already in memory. Its template
+ * overloads accept any handler types and dispatch the parse events statically.
+ * A DBARPushParser parses input that arrives in chunks.
  *
  * A DBARBlockHeader is a representation of the header of a block within a DBAR
  * file. A DBARTriplet represents the three values each block contains for each
@@ -1029,6 +1035,510 @@ uint32_t parse_stream(std::istream& in, ParseHandler* p,
 uint32_t parse_file(const std::string& filename, ParseHandler* p,
 		ParseErrorHandler* e);
 
+/**
+ * \brief Parse a buffer.
+ *
+ * The buffer is expected to contain the complete input. This is the fastest
+ * way to parse input that is already in memory, e.g. a received response.
+ *
+ * \param[in] data Pointer to the first byte
+ * \param[in] size Number of bytes
+ * \param[in] p    Handler for parse events
+ * \param[in] e    Handler for parse errors
+ *
+ * \return Total number of bytes parsed
+ */
+uint32_t parse_buffer(const uint8_t* data, const std::size_t size,
+		ParseHandler* p, ParseErrorHandler* e);
+
+namespace details
+{
+
+/**
+ * \internal
+ * \brief Size of bytes of a dBAR block header
+ */
+static constexpr int BLOCK_HEADER_BYTES { 13 };
+
+/**
+ * \internal
+ * \brief Size in bytes of a dBAR triplet
+ */
+static constexpr int TRIPLET_BYTES { 9 };
+
+/**
+ * \internal
+ * \brief Indicates an invalid ARCS value.
+ */
+static constexpr uint32_t UNPARSED_ARCS = 0;
+
+/**
+ * \internal
+ * \brief Indicates an invalid confidence value.
+ */
+static constexpr unsigned UNPARSED_CONFIDENCE = 0;
+
+/**
+ * \internal
+ * \brief Service method: Interpret the 4 bytes starting at \c bytes as a 32 bit
+ * unsigned integer with little endian storage.
+ *
+ * The bytes are not required to be aligned.
+ *
+ * \param[in] bytes Pointer to the least significant byte
+ *
+ * \return The bytes as 32 bit unsigned integer
+ */
+inline uint32_t le_bytes_to_uint32(const uint8_t* bytes) noexcept
+{
+	return  static_cast<uint32_t>(bytes[3]) << 24 |
+			static_cast<uint32_t>(bytes[2]) << 16 |
+			static_cast<uint32_t>(bytes[1]) <<  8 |
+			static_cast<uint32_t>(bytes[0]);
+}
+
+/**
+ * \internal
+ * \brief Defined iff \c H is not a pointer type.
+ *
+ * Keeps the parse_buffer() templates from competing with the overload for
+ * pointers to ParseHandler and ParseErrorHandler.
+ *
+ * \tparam H Handler type to test
+ */
+template <typename H>
+using IsHandlerType = std::enable_if_t<!std::is_pointer<H>::value>;
+
+/**
+ * \internal
+ * \brief Decoder for dBAR records.
+ *
+ * The decoder keeps the state of parsing between consecutive chunks of the
+ * input. It is the single implementation of the record format: parse_buffer()
+ * feeds the complete input as a single chunk, DBARPushParser and the stream
+ * parsers feed each chunk as it arrives.
+ *
+ * Complete records within a chunk are decoded without copying, consecutive
+ * complete triplets without further bounds checks. A record that is split
+ * between chunks is kept until its remaining bytes are fed.
+ *
+ * The handlers are passed to each call and dispatched statically. Their
+ * requirements are documented on parse_buffer(). All calls for the same input
+ * must pass the same handlers.
+ */
+class DBARDecoder final
+{
+	/**
+	 * \brief Bytes of the current record that is split between chunks.
+	 */
+	std::array<uint8_t, BLOCK_HEADER_BYTES> record_;
+
+	/**
+	 * \brief Number of bytes in \c record_.
+	 */
+	std::size_t record_bytes_;
+
+	/**
+	 * \brief Number of triplets still expected in the current block.
+	 *
+	 * If it is \c 0, the next record is a header.
+	 */
+	unsigned tracks_left_;
+
+	/**
+	 * \brief Total number of bytes parsed.
+	 */
+	unsigned byte_counter_;
+
+	/**
+	 * \brief 1-based number of the current block.
+	 */
+	unsigned block_counter_;
+
+	/**
+	 * \brief Number of bytes parsed in the current block.
+	 */
+	unsigned block_byte_counter_;
+
+	/**
+	 * \brief TRUE iff start_input() was passed to the handler.
+	 */
+	bool started_;
+
+	/**
+	 * \brief TRUE iff finish() was called.
+	 */
+	bool finished_;
+
+	/**
+	 * \brief Pass start_input() to the handler if not yet done.
+	 *
+	 * \param[in] p Handler for parse events
+	 */
+	template <class H>
+	void start(H& p);
+
+	/**
+	 * \brief Count \c n bytes as parsed.
+	 *
+	 * \param[in] n Number of bytes parsed
+	 */
+	void consumed(const std::size_t n) noexcept;
+
+	/**
+	 * \brief Pass the complete header at \c record to the handler.
+	 *
+	 * \param[in] p      Handler for parse events
+	 * \param[in] record First byte of a complete header
+	 */
+	template <class H>
+	void header(H& p, const uint8_t* record);
+
+	/**
+	 * \brief Pass the complete triplet at \c record to the handler.
+	 *
+	 * \param[in] p      Handler for parse events
+	 * \param[in] record First byte of a complete triplet
+	 */
+	template <class H>
+	void triplet(H& p, const uint8_t* record);
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 */
+	DBARDecoder();
+
+	/**
+	 * \brief Decode the next chunk of the input.
+	 *
+	 * \param[in] data Pointer to the first byte of the chunk
+	 * \param[in] size Number of bytes in the chunk
+	 * \param[in] p    Handler for parse events
+	 */
+	template <class H>
+	void feed(const uint8_t* data, const std::size_t size, H& p);
+
+	/**
+	 * \brief Report the end of the input.
+	 *
+	 * If the input ends within a block, the values read completely before are
+	 * passed to \c p and the error is reported to \c e. Calling finish() more
+	 * than once has no effect.
+	 *
+	 * \param[in] p Handler for parse events
+	 * \param[in] e Handler for parse errors
+	 *
+	 * \return Total number of bytes parsed
+	 */
+	template <class H, class E>
+	uint32_t finish(H& p, E& e);
+
+	/**
+	 * \brief Returns TRUE iff the input fed so far ends with a complete block.
+	 *
+	 * \return TRUE iff no block is pending, otherwise FALSE
+	 */
+	bool block_complete() const noexcept;
+
+	/**
+	 * \brief Total number of bytes parsed so far.
+	 *
+	 * \return Total number of bytes parsed so far
+	 */
+	uint32_t bytes_parsed() const noexcept;
+
+	/**
+	 * \brief Returns TRUE iff finish() was called.
+	 *
+	 * \return TRUE iff finish() was called, otherwise FALSE
+	 */
+	bool finished() const noexcept;
+};
+
+
+inline DBARDecoder::DBARDecoder()
+	: record_             { /* zeros */ }
+	, record_bytes_       { 0 }
+	, tracks_left_        { 0 }
+	, byte_counter_       { 0 }
+	, block_counter_      { 0 }
+	, block_byte_counter_ { 0 }
+	, started_            { false }
+	, finished_           { false }
+{
+	// empty
+}
+
+
+template <class H>
+void DBARDecoder::start(H& p)
+{
+	if (!started_)
+	{
+		started_ = true;
+		p.start_input();
+	}
+}
+
+
+inline void DBARDecoder::consumed(const std::size_t n) noexcept
+{
+	byte_counter_       += static_cast<unsigned>(n);
+	block_byte_counter_ += static_cast<unsigned>(n);
+}
+
+
+template <class H>
+void DBARDecoder::header(H& p, const uint8_t* record)
+{
+	p.header(record[0],
+			le_bytes_to_uint32(record + 1),
+			le_bytes_to_uint32(record + 5),
+			le_bytes_to_uint32(record + 9));
+
+	tracks_left_ = record[0];
+
+	if (tracks_left_ == 0)
+	{
+		p.end_block();
+	}
+}
+
+
+template <class H>
+void DBARDecoder::triplet(H& p, const uint8_t* record)
+{
+	p.triplet(
+			le_bytes_to_uint32(record + 1),
+			record[0],
+			le_bytes_to_uint32(record + 5));
+
+	--tracks_left_;
+
+	if (tracks_left_ == 0)
+	{
+		p.end_block();
+	}
+}
+
+
+template <class H>
+void DBARDecoder::feed(const uint8_t* data, const std::size_t size, H& p)
+{
+	this->start(p);
+
+	if (!data)
+	{
+		return;
+	}
+
+	const auto end { data + size };
+	auto pos { data };
+
+	while (pos < end)
+	{
+		if (tracks_left_ == 0 && record_bytes_ == 0)
+		{
+			++block_counter_;
+			block_byte_counter_ = 0;
+
+			p.start_block();
+		}
+
+		const auto available { static_cast<std::size_t>(end - pos) };
+
+		if (record_bytes_ == 0)
+		{
+			// Complete records in the chunk are decoded in place
+
+			if (tracks_left_ == 0 && available >= BLOCK_HEADER_BYTES)
+			{
+				this->header(p, pos);
+				pos += BLOCK_HEADER_BYTES;
+				this->consumed(BLOCK_HEADER_BYTES);
+				continue;
+			}
+
+			const auto complete_tracks { std::min(
+					static_cast<std::size_t>(tracks_left_),
+					available / TRIPLET_BYTES) };
+
+			for (auto trk = std::size_t { 0 }; trk < complete_tracks; ++trk)
+			{
+				this->triplet(p, pos);
+				pos += TRIPLET_BYTES;
+			}
+
+			this->consumed(complete_tracks * TRIPLET_BYTES);
+
+			if (complete_tracks > 0)
+			{
+				continue;
+			}
+		}
+
+		// Record is split between chunks, collect its bytes
+
+		const auto record_size { static_cast<std::size_t>(
+				tracks_left_ > 0 ? TRIPLET_BYTES : BLOCK_HEADER_BYTES) };
+
+		const auto n { std::min(record_size - record_bytes_, available) };
+
+		std::copy_n(pos, n, record_.begin() + record_bytes_);
+		record_bytes_ += n;
+		pos += n;
+
+		this->consumed(n);
+
+		if (record_bytes_ < record_size)
+		{
+			break; // wait for the next chunk
+		}
+
+		record_bytes_ = 0;
+
+		if (tracks_left_ == 0)
+		{
+			this->header(p, record_.data());
+		} else
+		{
+			this->triplet(p, record_.data());
+		}
+	}
+}
+
+
+template <class H, class E>
+uint32_t DBARDecoder::finish(H& p, E& e)
+{
+	if (finished_)
+	{
+		return byte_counter_;
+	}
+
+	this->start(p);
+	finished_ = true;
+
+	if (tracks_left_ == 0 && record_bytes_ > 0)
+	{
+		// Input ends within a header. Pass the values read completely before
+		// the error to the content handler
+
+		p.header(record_[0],
+				record_bytes_ > 4 ? le_bytes_to_uint32(&record_[1]) : 0,
+				record_bytes_ > 8 ? le_bytes_to_uint32(&record_[5]) : 0,
+				0);
+
+		e.on_error(byte_counter_, block_counter_, block_byte_counter_);
+	} else if (tracks_left_ > 0)
+	{
+		// Input ends within the triplets of a block. If at least the
+		// confidence value is available, pass it. The client will know that 0
+		// is not a valid ARCS for a non-silent track.
+
+		if (record_bytes_ > 0)
+		{
+			p.triplet(
+					record_bytes_ > 4 ? le_bytes_to_uint32(&record_[1])
+						: UNPARSED_ARCS,
+					record_[0],
+					UNPARSED_ARCS);
+		}
+
+		e.on_error(byte_counter_, block_counter_, block_byte_counter_);
+
+		p.end_block();
+	}
+
+	p.end_input();
+
+	return byte_counter_;
+}
+
+
+inline bool DBARDecoder::block_complete() const noexcept
+{
+	return tracks_left_ == 0 && record_bytes_ == 0;
+}
+
+
+inline uint32_t DBARDecoder::bytes_parsed() const noexcept
+{
+	return byte_counter_;
+}
+
+
+inline bool DBARDecoder::finished() const noexcept
+{
+	return finished_;
+}
+
+} // namespace details
+
+/**
+ * \brief Parse a buffer with handlers whose types are known at compile time.
+ *
+ * The handler types are not required to be subclasses of ParseHandler or
+ * ParseErrorHandler. The calls to the handlers are dispatched statically and
+ * can be inlined into the decode loop. This is the fastest way to extract some
+ * values from large amounts of dBAR data. The other parse functions use the
+ * same details::DBARDecoder.
+ *
+ * Type \c H must provide the public member functions \c start_input(),
+ * \c start_block(), \c header(uint8_t, uint32_t, uint32_t, uint32_t),
+ * \c triplet(uint32_t, uint8_t, uint32_t), \c end_block() and
+ * \c end_input(). They are called like the corresponding member functions of
+ * ParseHandler, hence a ParseHandler is also a valid \c H.
+ *
+ * Type \c E must provide a public member function
+ * \c on_error(unsigned, unsigned, unsigned) that is called like
+ * ParseErrorHandler::on_error(). If it returns, parsing stops.
+ *
+ * \tparam H Type of the handler for parse events
+ * \tparam E Type of the handler for parse errors
+ *
+ * \param[in] data Pointer to the first byte
+ * \param[in] size Number of bytes
+ * \param[in] p    Handler for parse events
+ * \param[in] e    Handler for parse errors
+ *
+ * \return Total number of bytes parsed
+ */
+template <class H, class E, typename = details::IsHandlerType<H>>
+uint32_t parse_buffer(const uint8_t* data, const std::size_t size, H& p,
+		E& e)
+{
+	auto decoder = details::DBARDecoder {};
+	decoder.feed(data, size, p);
+	return decoder.finish(p, e);
+}
+
+/**
+ * \brief Parse a buffer with a handler whose type is known at compile time.
+ *
+ * Parse errors are reported by a DBARErrorHandler.
+ *
+ * \tparam H Type of the handler for parse events
+ *
+ * \param[in] data Pointer to the first byte
+ * \param[in] size Number of bytes
+ * \param[in] p    Handler for parse events
+ *
+ * \throws StreamParseException If the input is incomplete
+ *
+ * \return Total number of bytes parsed
+ *
+ * \see parse_buffer(const uint8_t*, const std::size_t, H&, E&)
+ */
+template <class H, typename = details::IsHandlerType<H>>
+uint32_t parse_buffer(const uint8_t* data, const std::size_t size, H& p)
+{
+	auto e = DBARErrorHandler {};
+	return parse_buffer(data, size, p, e);
+}
+
 /**
  * \brief Read an AccurateRip response file to a DBAR object.
  *
@@ -1038,6 +1548,276 @@ uint32_t parse_file(const std::string& filename, ParseHandler* p,
  */
 DBAR load_file(const std::string& filename);
 
+
+/**
+ * \brief Incremental parser for dBAR input that arrives in chunks.
+ *
+ * The input is passed to feed() in chunks of arbitrary size as it arrives.
+ * The parse events are passed to the ParseHandler as soon as the respective
+ * record is complete. A header or triplet that is split between chunks is kept
+ * until its remaining bytes are fed. Hence, the parser neither needs the
+ * complete input nor blocks while waiting for it. Complete records within a
+ * chunk are decoded without copying.
+ *
+ * After the last chunk, finish() must be called to report the end of the
+ * input. If the input ends within a block, the values read so far are passed to
+ * the ParseHandler and the error is reported like parse_stream() would report
+ * it.
+ *
+ * \see parse_stream()
+ */
+class DBARPushParser final
+{
+	/**
+	 * \brief Handler for parse events.
+	 */
+	ParseHandler* p_;
+
+	/**
+	 * \brief Handler for parse errors, may be \c nullptr.
+	 */
+	ParseErrorHandler* e_;
+
+	/**
+	 * \brief Decoder for the chunks fed.
+	 */
+	details::DBARDecoder decoder_;
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] p Handler for parse events
+	 * \param[in] e Handler for parse errors, may be \c nullptr
+	 *
+	 * \throws std::invalid_argument If \c p is \c nullptr
+	 */
+	DBARPushParser(ParseHandler* p, ParseErrorHandler* e);
+
+	DBARPushParser(const DBARPushParser& rhs) = delete;
+	DBARPushParser& operator= (const DBARPushParser& rhs) = delete;
+
+	/**
+	 * \brief Parse the next chunk of the input.
+	 *
+	 * \param[in] data Pointer to the first byte of the chunk
+	 * \param[in] size Number of bytes in the chunk
+	 *
+	 * \throws std::logic_error If finish() was already called
+	 */
+	void feed(const uint8_t* data, const std::size_t size);
+
+	/**
+	 * \brief Report the end of the input.
+	 *
+	 * Reports an error if the input ends within a block. Calling finish() more
+	 * than once has no effect.
+	 *
+	 * \throws StreamParseException If the input ends within a block and no
+	 * ParseErrorHandler was passed
+	 *
+	 * \return Total number of bytes parsed
+	 */
+	uint32_t finish();
+
+	/**
+	 * \brief Returns TRUE iff the input fed so far ends with a complete block.
+	 *
+	 * \return TRUE iff no block is pending, otherwise FALSE
+	 */
+	bool block_complete() const noexcept;
+
+	/**
+	 * \brief Total number of bytes parsed so far.
+	 *
+	 * \return Total number of bytes parsed so far
+	 */
+	uint32_t bytes_parsed() const noexcept;
+};
+
+
+/**
+ * \brief Read-only view on the raw content of a dBAR file.
+ *
+ * A DBARView provides the values of a dBAR file without parsing them into a
+ * DBAR. On construction, the file is memory-mapped and only the byte offset of
+ * each block is recorded. Headers and triplets are decoded from the mapped
+ * bytes on access. Constructing a DBARView therefore costs page faults instead
+ * of a parse and a copy, and its memory footprint does not depend on the
+ * number of triplets.
+ *
+ * On platforms without memory mapping and for files that are not regular
+ * files, the content is read into a buffer owned by the view instead.
+ *
+ * A DBARView can also be constructed on a buffer owned by the caller. The
+ * buffer must then outlive the view.
+ *
+ * The values are the same as those of a DBAR loaded from the same input. In
+ * contrast to a DBAR, a DBARView cannot represent incomplete input: any
+ * truncated block is reported on construction.
+ *
+ * Instances are move-only.
+ */
+class DBARView final
+{
+public:
+
+	class Impl;
+
+private:
+
+	/**
+	 * \brief Internal implementation.
+	 */
+	std::unique_ptr<Impl> impl_;
+
+public:
+
+	using size_type = std::size_t;
+
+	/**
+	 * \brief Constructor for a view on a file.
+	 *
+	 * \param[in] filename Name of the file to map
+	 *
+	 * \throws std::runtime_error If the file cannot be opened, mapped or read
+	 * \throws StreamParseException If the file content is incomplete
+	 */
+	explicit DBARView(const std::string& filename);
+
+	/**
+	 * \brief Constructor for a view on a buffer.
+	 *
+	 * The buffer is not copied and must outlive the view.
+	 *
+	 * \param[in] data  Pointer to the first byte
+	 * \param[in] bytes Number of bytes
+	 *
+	 * \throws StreamParseException If the buffer content is incomplete
+	 */
+	DBARView(const uint8_t* data, const size_type bytes);
+
+	DBARView(const DBARView& rhs) = delete;
+	DBARView& operator= (const DBARView& rhs) = delete;
+
+	DBARView(DBARView&& rhs) noexcept;
+	DBARView& operator= (DBARView&& rhs) noexcept;
+
+	/**
+	 * \brief Default destructor.
+	 */
+	~DBARView() noexcept;
+
+	/**
+	 * \brief Total number of blocks.
+	 *
+	 * \return Total number of blocks
+	 */
+	size_type size() const noexcept;
+
+	/**
+	 * \brief Total number of tracks in the specified block.
+	 *
+	 * \param[in] block_idx Block to access
+	 *
+	 * \return Size of the specified block
+	 */
+	size_type size(const size_type block_idx) const;
+
+	/**
+	 * \brief Returns TRUE iff the view is empty, otherwise FALSE.
+	 *
+	 * \return TRUE iff the view is empty, otherwise FALSE.
+	 */
+	bool empty() const noexcept;
+
+	/**
+	 * \brief Number of bytes in the view.
+	 *
+	 * \return Number of bytes in the view
+	 */
+	size_type bytes() const noexcept;
+
+	/**
+	 * \brief ARCS value of a track.
+	 *
+	 * \param[in] block_idx Specified block index
+	 * \param[in] track_idx Specified track index
+	 *
+	 * \return ARCS value of the specified track
+	 */
+	uint32_t arcs_value(const size_type block_idx,
+			const size_type track_idx) const;
+
+	/**
+	 * \brief Confidence value of a track.
+	 *
+	 * \param[in] block_idx Specified block index
+	 * \param[in] track_idx Specified track index
+	 *
+	 * \return Confidence value of the specified track
+	 */
+	unsigned confidence_value(const size_type block_idx,
+			const size_type track_idx) const;
+
+	/**
+	 * \brief ARCS value of frame 450 of a track.
+	 *
+	 * \param[in] block_idx Specified block index
+	 * \param[in] track_idx Specified track index
+	 *
+	 * \return ARCS value frame 450 of the specified track
+	 */
+	uint32_t frame450_arcs_value(const size_type block_idx,
+			const size_type track_idx) const;
+
+	/**
+	 * \brief Total number of tracks the specified block declares.
+	 *
+	 * \param[in] block_idx Block to access
+	 *
+	 * \return Total number of tracks as declared
+	 */
+	unsigned total_tracks(const size_type block_idx) const;
+
+	/**
+	 * \brief Header of the specified block.
+	 *
+	 * \param[in] block_idx Block to return header of
+	 *
+	 * \return Header of the specified block.
+	 */
+	DBARBlockHeader header(const size_type block_idx) const;
+
+	/**
+	 * \brief Triplet representing the specified track.
+	 *
+	 * \param[in] block_idx Block to lookup track
+	 * \param[in] track_idx Track to return
+	 *
+	 * \return Specified triplet
+	 */
+	DBARTriplet triplet(const size_type block_idx,
+		const size_type track_idx) const;
+
+	/**
+	 * \brief ARId of the specified block.
+	 *
+	 * \param[in] block_idx Block to return the ARId of
+	 *
+	 * \return ARId of the specified block
+	 */
+	ARId id(const size_type block_idx) const;
+
+
+	friend void swap(DBARView& lhs, DBARView& rhs) noexcept
+	{
+		using std::swap;
+		swap(lhs.impl_, rhs.impl_);
+	}
+};
+
 /** @} */
 
 } // namespace v_1_0_0
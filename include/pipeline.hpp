@@ -0,0 +1,140 @@
+#ifndef __LIBARCSTK_PIPELINE_HPP__
+#define __LIBARCSTK_PIPELINE_HPP__
+
+/**
+ * \file
+ *
+ * \brief Pipeline for decoupling reading samples from updating a Calculation.
+ */
+
+#include <cstddef>          // for size_t
+#include <memory>           // for unique_ptr
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"    // for Calculation, sample_t
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+/** \addtogroup calc */
+/** @{ */
+
+
+/**
+ * \brief Update a Calculation by a separate thread.
+ *
+ * A CalculationPipeline decouples reading and decoding the samples from
+ * updating the Calculation with the samples. While the caller decodes the
+ * next block of samples, the previous blocks are processed by a consumer
+ * thread owned by the pipeline. Thus, decoding and calculating run in
+ * parallel.
+ *
+ * The pipeline owns a fixed number of reusable blocks of samples, organized
+ * as a lock-free ring for a single producer and a single consumer. The caller
+ * is the producer: it acquires a free block by acquire(), fills it with
+ * samples and passes it to the consumer by commit(). If no block is free,
+ * acquire() waits until the consumer has processed a block.
+ *
+ * After the last block is committed, close() waits until all blocks are
+ * processed. Afterwards, the result of the Calculation is available.
+ *
+ * The Calculation must not be accessed by the caller while the pipeline is
+ * open. This includes updating its AudioSize, which therefore has to be done
+ * before the pipeline is constructed.
+ *
+ * Only a single thread may act as the producer.
+ */
+class CalculationPipeline final
+{
+	class Impl;
+	std::unique_ptr<Impl> impl_;
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * Starts the consumer thread.
+	 *
+	 * \param[in] calculation  Calculation to update
+	 * \param[in] block_size   Capacity of each block in samples
+	 * \param[in] total_blocks Number of blocks in the ring
+	 *
+	 * \throws std::invalid_argument If \c block_size or \c total_blocks is 0
+	 */
+	CalculationPipeline(Calculation& calculation,
+			const std::size_t block_size   = 64 * 588,
+			const std::size_t total_blocks = 4);
+
+	CalculationPipeline(const CalculationPipeline& rhs) = delete;
+	CalculationPipeline& operator=(const CalculationPipeline& rhs) = delete;
+
+	/**
+	 * \brief Destructor.
+	 *
+	 * Closes the pipeline if it is still open. Errors of the consumer are
+	 * discarded, call close() to receive them.
+	 */
+	~CalculationPipeline() noexcept;
+
+	/**
+	 * \brief Acquire the next free block.
+	 *
+	 * The block remains owned by the caller until it is passed to commit().
+	 * Acquiring a block again without committing the previous one returns the
+	 * same block.
+	 *
+	 * \return Pointer to a block of block_size() samples
+	 *
+	 * \throws Whatever the consumer thread has thrown while updating the
+	 * Calculation
+	 * \throws std::logic_error If the pipeline is closed
+	 */
+	sample_t* acquire();
+
+	/**
+	 * \brief Pass the acquired block to the consumer.
+	 *
+	 * \param[in] size Number of samples in the block
+	 *
+	 * \throws std::logic_error If no block is acquired
+	 * \throws std::out_of_range If \c size exceeds block_size()
+	 */
+	void commit(const std::size_t size);
+
+	/**
+	 * \brief Close the pipeline.
+	 *
+	 * Blocks until all committed blocks are processed and the consumer thread
+	 * is stopped. Closing a closed pipeline has no effect.
+	 *
+	 * \throws Whatever the consumer thread has thrown while updating the
+	 * Calculation
+	 */
+	void close();
+
+	/**
+	 * \brief Capacity of each block in samples.
+	 *
+	 * \return Capacity of each block
+	 */
+	std::size_t block_size() const noexcept;
+
+	/**
+	 * \brief Number of blocks in the ring.
+	 *
+	 * \return Number of blocks
+	 */
+	std::size_t total_blocks() const noexcept;
+};
+
+/** @} */
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
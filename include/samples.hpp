@@ -8,16 +8,17 @@
  */
 
 #ifndef __LIBARCSTK_POLICIES_HPP__
-#include "policies.hpp"         // for Comparable, IteratorElement
+#include "policies.hpp"         // for TotallyOrdered, IteratorElement
 #endif
 
+#include <algorithm>            // for min
 #include <array>                // for array
 #include <cstddef>              // for ptrdiff_t, size_t
 #include <cstdint>              // for int16_t, int32_t, uint8_t, uint32_t,...
-#include <iterator>             // for bidirectional_iterator_tag
+#include <iterator>             // for random_access_iterator_tag
 #include <sstream>              // for ostringstream
 #include <stdexcept>            // for out_of_range
-#include <type_traits>          // for is_same, enable_if_t
+#include <type_traits>          // for is_same, enable_if_t, make_unsigned_t
 
 namespace arcstk
 {
@@ -131,13 +132,85 @@ template<typename T, bool is_planar, typename = IsSampleType<T>>
 class SampleSequenceImplBase; // IWYU pragma keep
 // forward declaration required by friend delcaration in SampleIterator
 
+/**
+ * \internal
+ *
+ * \brief Combine \c n pairs of planar 16 bit samples to PCM 32 bit samples.
+ *
+ * Sample \c i in \c dest is <tt>higher[i] << 16 | lower[i]</tt>.
+ *
+ * Uses vectorized conversion if the CPU supports it.
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ */
+void combine_planar(const uint16_t* lower, const uint16_t* higher,
+		const std::size_t n, sample_type* dest);
+
+/**
+ * \internal
+ *
+ * \brief Combine \c n pairs of planar 32 bit samples to PCM 32 bit samples.
+ *
+ * Only the lower 16 bits of each input sample are respected.
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ *
+ * \see combine_planar(const uint16_t*, const uint16_t*, const std::size_t, sample_type*)
+ */
+void combine_planar(const uint32_t* lower, const uint32_t* higher,
+		const std::size_t n, sample_type* dest);
+
+/**
+ * \internal
+ *
+ * \brief Combine \c n pairs of interleaved 16 bit samples to PCM 32 bit
+ * samples.
+ *
+ * If \c left0_right1 is \c TRUE, sample \c i in \c dest is
+ * <tt>buffer[2 * i + 1] << 16 | buffer[2 * i]</tt>, otherwise the channels are
+ * swapped.
+ *
+ * Uses vectorized conversion if the CPU supports it.
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ */
+void combine_interleaved(const uint16_t* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest);
+
+/**
+ * \internal
+ *
+ * \brief Combine \c n pairs of interleaved 32 bit samples to PCM 32 bit
+ * samples.
+ *
+ * Only the lower 16 bits of each input sample are respected.
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ *
+ * \see combine_interleaved(const uint16_t*, const std::size_t, const bool, sample_type*)
+ */
+void combine_interleaved(const uint32_t* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest);
+
 } // namespace details
 
 
 /**
  * \internal
  *
- * \brief A \c bidirectional_iterator for samples in SampleSequence instances.
+ * \brief A \c random_access_iterator for samples in SampleSequence instances.
  *
  * Provides a representation of the 16 bit stereo samples for each channel as
  * a single integer of an unsigned integer type assignable to \c sample_t.
@@ -149,12 +222,13 @@ class SampleSequenceImplBase; // IWYU pragma keep
  *   <li>prefix- and postfix decrement,</li>
  *   <li>operators add-assign (+=) and subtract-assign (-=),</li>
  *   <li>binary operators for addition and substraction of values, and</li>
- *   <li>binary operators for addition and substraction of positions.</li>
+ *   <li>binary operators for addition and substraction of positions,</li>
+ *   <li>subscript operator and relational operators.</li>
  * </ul>
  */
 template <typename T, bool is_planar, bool is_const>
 class SampleIterator final :
-					public Comparable<SampleIterator<T, is_planar, is_const>>
+				public TotallyOrdered<SampleIterator<T, is_planar, is_const>>
 {
 	// Befriend the converse version of the type: const_iterator can access
 	// private members of iterator (and vice versa)
@@ -165,7 +239,7 @@ class SampleIterator final :
 
 public:
 
-	using iterator_category = std::bidirectional_iterator_tag;
+	using iterator_category = std::random_access_iterator_tag;
 
 	using value_type        = sample_type;
 
@@ -274,6 +348,18 @@ public:
 		return { pos_, **this };
 	}
 
+	/**
+	 * \brief Subscript operator.
+	 *
+	 * \param[in] n Position relative to the current position
+	 *
+	 * \return The converted PCM 32 bit sample at position \c n
+	 */
+	reference operator [] (const difference_type n) const
+	{
+		return *(*this + n);
+	}
+
 	/**
 	 * \internal
 	 * \brief Prefix increment operator.
@@ -405,6 +491,12 @@ public:
 		return lhs.seq_ == rhs.seq_ && lhs.pos_ == rhs.pos_;
 	}
 
+	friend bool operator < (const SampleIterator& lhs,
+			const SampleIterator& rhs) noexcept
+	{
+		return lhs.pos_ < rhs.pos_;
+	}
+
 	friend void swap(SampleIterator& lhs, SampleIterator& rhs) noexcept
 	{
 		using std::swap;
@@ -412,6 +504,32 @@ public:
 		swap(lhs.pos_, rhs.pos_);
 	}
 
+	/**
+	 * \internal
+	 * \brief Copy \c n converted samples starting at \c pos to \c dest.
+	 *
+	 * Overload of copy_samples() that uses the bulk conversion of the
+	 * SampleSequence instead of converting each sample on its own. It is
+	 * found by argument dependent lookup.
+	 *
+	 * \param[in] pos  Position of the first sample to copy
+	 * \param[in] n    Number of samples to copy
+	 * \param[in] dest Buffer for at least \c n samples
+	 *
+	 * \return Position behind the last sample copied
+	 */
+	friend SampleIterator copy_samples(SampleIterator pos,
+			const difference_type n, sample_type* dest)
+	{
+		using index_type = typename SampleSequence<T, is_planar>::size_type;
+
+		pos.seq_->copy(dest, static_cast<index_type>(n),
+				static_cast<index_type>(pos.pos_));
+
+		pos += n;
+		return pos;
+	}
+
 private:
 
 	/**
@@ -701,6 +819,30 @@ protected:
 		}
 	}
 
+	/**
+	 * \brief Number of samples to copy from \c pos on.
+	 *
+	 * \param[in] count Requested number of samples
+	 * \param[in] pos   Index of the first sample to copy
+	 *
+	 * \return \c count, limited to the samples from \c pos to the end
+	 *
+	 * \throws std::out_of_range if \c pos is greater than size()
+	 */
+	size_type copy_count(const size_type count, const size_type pos) const
+	{
+		if (pos > this->size())
+		{
+			auto msg = std::ostringstream {};
+			msg << "Position out of bounds: " << pos
+				<< ". Size: " << this->size();
+
+			throw std::out_of_range(msg.str());
+		}
+
+		return std::min(count, this->size() - pos);
+	}
+
 	/**
 	 * \brief Obtain the number of the left channel from the ordering flag.
 	 *
@@ -1000,6 +1142,39 @@ public: /* member functions */
 		//	| static_cast<uint16_t>(buffer_[left_][index]);
 	}
 
+	/**
+	 * \brief Copy a range of samples in the uniform format (32 bit PCM) to
+	 * a contiguous buffer.
+	 *
+	 * The samples are converted in bulk which is considerably faster than
+	 * accessing each sample by operator[].
+	 *
+	 * If the range <tt>[pos, pos + count)</tt> exceeds size(), only the
+	 * samples up to size() are copied.
+	 *
+	 * \param[in] dest  Buffer for at least \c count samples
+	 * \param[in] count Number of samples to copy
+	 * \param[in] pos   Index of the first sample to copy
+	 *
+	 * \return Number of samples copied
+	 *
+	 * \throw std::out_of_range if \c pos is greater than size()
+	 */
+	size_type copy(value_type* dest, const size_type count,
+			const size_type pos = 0) const
+	{
+		const auto n { this->copy_count(count, pos) };
+
+		using U = std::make_unsigned_t<T>;
+
+		details::combine_planar(
+				reinterpret_cast<const U*>(buffer_[this->left_channel()]  + pos),
+				reinterpret_cast<const U*>(buffer_[this->right_channel()] + pos),
+				n, dest);
+
+		return n;
+	}
+
 	/**
 	 * \brief Provides access to the samples in a uniform format (32 bit PCM).
 	 *
@@ -1268,6 +1443,38 @@ public: /* member functions */
 		//	| static_cast<uint16_t>(buffer_[2 * index + left_]);
 	}
 
+	/**
+	 * \brief Copy a range of samples in the uniform format (32 bit PCM) to
+	 * a contiguous buffer.
+	 *
+	 * The samples are converted in bulk which is considerably faster than
+	 * accessing each sample by operator[].
+	 *
+	 * If the range <tt>[pos, pos + count)</tt> exceeds size(), only the
+	 * samples up to size() are copied.
+	 *
+	 * \param[in] dest  Buffer for at least \c count samples
+	 * \param[in] count Number of samples to copy
+	 * \param[in] pos   Index of the first sample to copy
+	 *
+	 * \return Number of samples copied
+	 *
+	 * \throw std::out_of_range if \c pos is greater than size()
+	 */
+	size_type copy(value_type* dest, const size_type count,
+			const size_type pos = 0) const
+	{
+		const auto n { this->copy_count(count, pos) };
+
+		using U = std::make_unsigned_t<T>;
+
+		details::combine_interleaved(
+				reinterpret_cast<const U*>(buffer_ + 2 * pos), n,
+				this->channel_ordering(), dest);
+
+		return n;
+	}
+
 	/**
 	 * \brief Provides access to the samples in a uniform format (32 bit PCM).
 	 *
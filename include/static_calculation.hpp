@@ -0,0 +1,368 @@
+#ifndef __LIBARCSTK_STATIC_CALCULATION_HPP__
+#define __LIBARCSTK_STATIC_CALCULATION_HPP__
+
+/**
+ * \file
+ *
+ * \brief Calculation specialized at compile time on algorithm and iterator.
+ */
+
+#include <algorithm>        // for min
+#include <cstdint>          // for int32_t
+#include <iterator>         // for distance, iterator_traits, next
+#include <stdexcept>        // for invalid_argument
+#include <type_traits>      // for is_base_of
+#include <utility>          // for move
+#include <vector>           // for vector
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"   // for AccurateRip::V1, V2, V1andV2
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"    // for Context, Points, any
+#endif
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"     // for ChecksumSet, Checksums
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"     // for AudioSize, CDDA, ToC
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+/** \addtogroup calc */
+/** @{ */
+
+namespace details
+{
+
+/**
+ * \internal
+ *
+ * \brief Compile time properties of an Algorithm usable in a
+ * StaticCalculation.
+ *
+ * Only algorithms with a specialization are supported.
+ *
+ * \tparam A Algorithm type
+ */
+template <class A>
+struct StaticAlgorithm;
+
+
+/**
+ * \internal
+ *
+ * \brief Static properties of the AccurateRip algorithms.
+ */
+template <enum checksum::type T1, enum checksum::type... T2>
+struct StaticAlgorithm<accuraterip::details::ARCSAlgorithm<T1, T2...>>
+{
+	/**
+	 * \brief Update functor of the algorithm.
+	 */
+	using update_type = accuraterip::details::Update<T1, T2...>;
+};
+
+} // namespace details
+
+
+/**
+ * \brief A Calculation whose Algorithm and sample iterator are known at
+ * compile time.
+ *
+ * A StaticCalculation yields the same Checksums as a Calculation with the same
+ * Algorithm but does not dispatch to the Algorithm virtually and does not wrap
+ * the input in a SampleInputIterator. Since the calculation loop is a template
+ * defined in this header, the compiler can inline it into the caller's read
+ * loop. Hosts that know their types at build time can use it for maximum
+ * throughput, while Calculation remains the choice for selecting the Algorithm
+ * at runtime.
+ *
+ * Supported algorithms are AccurateRip::V1, AccurateRip::V2 and
+ * AccurateRip::V1andV2. Each update is performed single-threaded.
+ *
+ * \tparam A Algorithm type
+ * \tparam I Forward iterator type with sample_t as value type
+ */
+template <class A, class I>
+class StaticCalculation final
+{
+	static_assert(std::is_base_of<std::forward_iterator_tag,
+			typename std::iterator_traits<I>::iterator_category>::value,
+			"StaticCalculation requires a forward iterator");
+
+	using update_type = typename details::StaticAlgorithm<A>::update_type;
+
+	using difference_type = typename std::iterator_traits<I>::difference_type;
+
+	/**
+	 * \brief Update functor of the algorithm.
+	 */
+	update_type update_;
+
+	/**
+	 * \brief Subtotals of the current track.
+	 */
+	accuraterip::details::Subtotals st_;
+
+	/**
+	 * \brief Index of the first sample to calculate.
+	 */
+	int32_t first_;
+
+	/**
+	 * \brief Index behind the last sample to calculate of each track.
+	 */
+	std::vector<int32_t> track_ends_;
+
+	/**
+	 * \brief Index of the next sample to be passed to update().
+	 */
+	int32_t offset_;
+
+	/**
+	 * \brief 0-based index of the current track.
+	 */
+	std::size_t track_;
+
+	/**
+	 * \brief Number of samples calculated in the current track.
+	 */
+	int32_t track_samples_;
+
+	/**
+	 * \brief Checksums of the finished tracks.
+	 */
+	Checksums result_;
+
+	/**
+	 * \brief Finish the current track and prepare the next one.
+	 */
+	void finish_track();
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] context Context of the calculation
+	 * \param[in] size    Total number of samples of the input
+	 * \param[in] points  Track offsets (as samples), may be empty for a single
+	 *                    track
+	 *
+	 * \throws std::invalid_argument If \c size is zero or the points are not
+	 * ascending within \c size
+	 */
+	StaticCalculation(const Context context, const AudioSize& size,
+			const Points& points);
+
+	/**
+	 * \brief Constructor for an album.
+	 *
+	 * \param[in] toc Complete ToC of the album
+	 *
+	 * \throws std::invalid_argument If the ToC is not complete
+	 */
+	explicit StaticCalculation(const ToC& toc);
+
+	/**
+	 * \brief Update the calculation with a sequence of samples.
+	 *
+	 * The samples have to be passed in order. Samples after the last sample to
+	 * calculate are ignored.
+	 *
+	 * \param[in] start Iterator pointing to the first sample
+	 * \param[in] stop  Iterator pointing behind the last sample
+	 */
+	void update(I start, I stop);
+
+	/**
+	 * \brief Returns \c TRUE iff all tracks are finished.
+	 *
+	 * \return \c TRUE iff all tracks are finished, otherwise \c FALSE
+	 */
+	bool complete() const noexcept;
+
+	/**
+	 * \brief Number of samples passed to update() so far.
+	 *
+	 * \return Number of samples passed
+	 */
+	int32_t samples_processed() const noexcept;
+
+	/**
+	 * \brief Checksums of the tracks finished so far.
+	 *
+	 * \return Checksums of the finished tracks
+	 */
+	const Checksums& result() const noexcept;
+
+	/**
+	 * \brief Move the Checksums of the finished tracks out of the instance.
+	 *
+	 * \return Checksums of the finished tracks
+	 */
+	Checksums take_result() noexcept;
+};
+
+
+template <class A, class I>
+StaticCalculation<A, I>::StaticCalculation(const Context context,
+		const AudioSize& size, const Points& points)
+	: update_        { /* default */ }
+	, st_            { /* default */ }
+	, first_         { points.empty() ? 0 : points.front().samples() }
+	, track_ends_    { /* empty */ }
+	, offset_        { 0 }
+	, track_         { 0 }
+	, track_samples_ { 0 }
+	, result_        { /* empty */ }
+{
+	using accuraterip::details::NUM_SKIP_SAMPLES;
+
+	if (size.zero())
+	{
+		throw std::invalid_argument(
+				"StaticCalculation requires the total number of samples");
+	}
+
+	auto last { size.samples() }; // behind the last sample to calculate
+
+	if (any(Context::FIRST_TRACK & context))
+	{
+		first_ += NUM_SKIP_SAMPLES::FRONT;
+		st_.multiplier = NUM_SKIP_SAMPLES::FRONT + 1;
+	}
+
+	if (any(Context::LAST_TRACK & context))
+	{
+		last -= NUM_SKIP_SAMPLES::BACK;
+	}
+
+	for (auto p = std::size_t { 1 }; p < points.size(); ++p)
+	{
+		if (points[p].samples() < points[p - 1].samples()
+				|| points[p].samples() > size.samples())
+		{
+			throw std::invalid_argument("Track offsets are not ascending");
+		}
+
+		track_ends_.push_back(std::min(points[p].samples(), last));
+	}
+
+	track_ends_.push_back(last);
+
+	if (first_ >= track_ends_.front())
+	{
+		throw std::invalid_argument("Input contains no samples to calculate");
+	}
+}
+
+
+template <class A, class I>
+StaticCalculation<A, I>::StaticCalculation(const ToC& toc)
+	: StaticCalculation { Context::ALBUM,
+		toc.complete() ? toc.leadout() : AudioSize { /* zero */ },
+		toc.offsets() }
+{
+	// empty
+}
+
+
+template <class A, class I>
+void StaticCalculation<A, I>::update(I start, I stop)
+{
+	auto remaining { std::distance(start, stop) };
+
+	while (remaining > 0 && !this->complete())
+	{
+		if (offset_ < first_)
+		{
+			// Skip the samples before the first sample to calculate
+			const auto n { std::min(remaining,
+					static_cast<difference_type>(first_ - offset_)) };
+
+			std::advance(start, n);
+			offset_   += static_cast<int32_t>(n);
+			remaining -= n;
+			continue;
+		}
+
+		const auto track_end { track_ends_[track_] };
+
+		const auto n { std::min(remaining,
+				static_cast<difference_type>(track_end - offset_)) };
+
+		const auto block_end { std::next(start, n) };
+
+		update_(start, block_end, st_);
+
+		start           = block_end;
+		offset_        += static_cast<int32_t>(n);
+		track_samples_ += static_cast<int32_t>(n);
+		remaining      -= n;
+
+		if (offset_ == track_end)
+		{
+			this->finish_track();
+		}
+	}
+
+	offset_ += static_cast<int32_t>(remaining); // ignored samples
+}
+
+
+template <class A, class I>
+void StaticCalculation<A, I>::finish_track()
+{
+	auto checksums { update_.value(st_) };
+	checksums.set_length(track_samples_ / CDDA::SAMPLES_PER_FRAME);
+
+	result_.push_back(std::move(checksums));
+
+	st_ = accuraterip::details::Subtotals {};
+	track_samples_ = 0;
+	++track_;
+}
+
+
+template <class A, class I>
+bool StaticCalculation<A, I>::complete() const noexcept
+{
+	return track_ == track_ends_.size();
+}
+
+
+template <class A, class I>
+int32_t StaticCalculation<A, I>::samples_processed() const noexcept
+{
+	return offset_;
+}
+
+
+template <class A, class I>
+const Checksums& StaticCalculation<A, I>::result() const noexcept
+{
+	return result_;
+}
+
+
+template <class A, class I>
+Checksums StaticCalculation<A, I>::take_result() noexcept
+{
+	auto result { std::move(result_) };
+	result_.clear(); // moved-from state is unspecified
+	return result;
+}
+
+/** @} */
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
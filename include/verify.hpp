@@ -16,9 +16,12 @@
 
 #include <cstddef>        // for size_t
 #include <cstdint>        // for uint32_t
+#include <map>            // for map
 #include <memory>         // for unique_ptr
 #include <ostream>        // for ostream
 #include <tuple>          // for tuple
+#include <unordered_map>  // for unordered_multimap
+#include <utility>        // for pair
 #include <vector>         // for vector
 
 
@@ -28,11 +31,14 @@ inline namespace v_1_0_0
 {
 
 class ARId;
+class Calculation;
 class Checksum;
 class ChecksumSet;
 class DBAR;
+class DBARView;
 
 using Checksums = std::vector<ChecksumSet>; // duplicate from calculate.hpp
+using sample_t  = uint32_t; // duplicate from calculate.hpp
 
 /**
  * \defgroup verify AccurateRip Checksum Verification
@@ -44,7 +50,8 @@ using Checksums = std::vector<ChecksumSet>; // duplicate from calculate.hpp
  * A Verifier verifies local Checksums against some reference Checksums provided
  * by a ChecksumSource. A ChecksumSource is an interface to different kinds of
  * input for Checksums. For convenience, a DBARSource is provided that makes a
- * DBAR object available as input for verification.
+ * DBAR object available as input for verification. Likewise, a DBARViewSource
+ * makes a DBARView available.
  *
  * A custom class T can be made available as input provider by subclassing
  * ChecksumSourceOf<T> and implementing the access to the reference values in
@@ -312,6 +319,73 @@ public:
 };
 
 
+/**
+ * \brief Access DBARView as a ChecksumSource.
+ *
+ * Make DBARView instances available for verification.
+ *
+ * A DBARView decodes its values on access. Therefore, the references returned
+ * by arcs_value(), confidence() and frame450_arcs_value() refer to a copy of
+ * the decoded value that is kept per position. Such a reference remains valid
+ * for the lifetime of the instance and does not alias the values of other
+ * positions. Since the copies are added on access, an instance must not be
+ * shared between threads.
+ */
+class DBARViewSource final : public ChecksumSourceOf<DBARView>
+{
+	/**
+	 * \brief Position of a value as block index and track index.
+	 */
+	using Position = std::pair<size_type, size_type>;
+
+	/**
+	 * \brief Values decoded by do_arcs_value().
+	 */
+	mutable std::map<Position, uint32_t> arcs_;
+
+	/**
+	 * \brief Values decoded by do_confidence().
+	 */
+	mutable std::map<Position, unsigned> confidence_;
+
+	/**
+	 * \brief Values decoded by do_frame450_arcs_value().
+	 */
+	mutable std::map<Position, uint32_t> frame450_arcs_;
+
+	// ChecksumSource
+
+	ARId do_id(const size_type block_idx) const final;
+
+	Checksum do_checksum(const size_type block_idx,
+			const size_type idx) const final;
+
+	const uint32_t& do_arcs_value(const size_type block_idx,
+			const size_type idx) const final;
+
+	const unsigned& do_confidence(const size_type block_idx,
+			const size_type idx) const final;
+
+	const uint32_t& do_frame450_arcs_value(const size_type block_idx,
+			const size_type idx) const final;
+
+	std::size_t do_size(const size_type block_idx) const final;
+
+	std::size_t do_size() const final;
+
+	std::unique_ptr<ChecksumSource> do_clone() const final;
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] view The DBARView to access
+	 */
+	DBARViewSource(const DBARView* view);
+};
+
+
 /**
  * \brief Interface: Result of a verification process.
  *
@@ -789,6 +863,130 @@ public:
 	~TracksetVerifier() noexcept;
 };
 
+/**
+ * \brief A read offset detected by the ARCS of frame 450.
+ */
+struct OffsetMatch final
+{
+	/**
+	 * \brief Read offset in samples.
+	 */
+	int32_t offset;
+
+	/**
+	 * \brief 0-based index of the matching block.
+	 */
+	std::size_t block;
+
+	/**
+	 * \brief 0-based index of the matching track within the block.
+	 */
+	std::size_t track;
+
+	friend bool operator == (const OffsetMatch& lhs, const OffsetMatch& rhs)
+		noexcept
+	{
+		return lhs.offset == rhs.offset
+			&& lhs.block  == rhs.block
+			&& lhs.track  == rhs.track;
+	}
+};
+
+
+/**
+ * \brief Detect the read offset of a track by the ARCS of frame 450.
+ *
+ * The ARCS values of frame 450 of all blocks and tracks in a ChecksumSource are
+ * indexed by their value. To detect the offset of a track, the ARCS of frame
+ * 450 is calculated for each candidate offset from a window of samples around
+ * frame 450 of the track. The ARCS for the next offset is derived from the ARCS
+ * of its predecessor in constant time and looked up in the index in constant
+ * time.
+ *
+ * The window for a maximal offset \c m consists of the 588 + 2 * \c m samples
+ * starting with sample 450 * 588 - \c m of the track. It is retained by
+ * AccurateRip::V1andV2withFrame450 during the calculation of the track. As for
+ * ARCSOffsetScanner, a match with offset \c o means that sample \c i of the
+ * track is read as sample \c i + \c o.
+ *
+ * Reference values of \c 0 are ignored since they indicate a missing value or
+ * silence.
+ */
+class OffsetDetector final
+{
+public:
+
+	using size_type = ChecksumSource::size_type;
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] refs Reference values to detect offsets for
+	 */
+	explicit OffsetDetector(const ChecksumSource& refs);
+
+	/**
+	 * \brief Number of indexed reference values.
+	 *
+	 * \return Number of indexed reference values
+	 */
+	size_type size() const noexcept;
+
+	/**
+	 * \brief Block and track of every reference value equal to \c value.
+	 *
+	 * \param[in] value ARCS value of frame 450 to lookup
+	 *
+	 * \return Pairs of 0-based block and track indices
+	 */
+	std::vector<std::pair<size_type, size_type>> lookup(const uint32_t value)
+		const;
+
+	/**
+	 * \brief Detect the offsets for which the ARCS of frame 450 of a track
+	 * matches a reference value.
+	 *
+	 * \param[in] start      Pointer to the first sample of the window
+	 * \param[in] stop       Pointer behind the last sample of the window
+	 * \param[in] max_offset Maximal absolute offset
+	 *
+	 * \return Matches ordered by offset
+	 *
+	 * \throws std::invalid_argument If the window size does not correspond to
+	 * max_offset
+	 */
+	std::vector<OffsetMatch> detect(const sample_t* start,
+			const sample_t* stop, const int32_t max_offset) const;
+
+	/**
+	 * \brief Detect the offsets for which the ARCS of frame 450 of a track of
+	 * a Calculation matches a reference value.
+	 *
+	 * The window is taken from the algorithm of the Calculation, which is
+	 * required to be an AccurateRip::V1andV2withFrame450 or any other variant
+	 * that provides the ARCS of frame 450. The maximal offset is the maximal
+	 * offset the algorithm retains the windows for. Hence, the offsets are
+	 * detected without reading the input again.
+	 *
+	 * \param[in] calculation Calculation that processed the track
+	 * \param[in] track       1-based number of the track
+	 *
+	 * \return Matches ordered by offset
+	 *
+	 * \throws std::invalid_argument If the algorithm does not retain windows
+	 * or there is no window for \c track
+	 */
+	std::vector<OffsetMatch> detect(const Calculation& calculation,
+			const int track) const;
+
+private:
+
+	/**
+	 * \brief Block and track indices by reference value.
+	 */
+	std::unordered_multimap<uint32_t, std::pair<size_type, size_type>> index_;
+};
+
 /** @} */
 
 } // namespace v_1_0_0
@@ -12,7 +12,13 @@
 #ifndef __LIBARCSTK_ACCURATERIP_HPP__
 #include "accuraterip.hpp"
 #endif
+#ifndef __LIBARCSTK_ACCURATERIP_DETAILS_HPP__
+#include "accuraterip_details.hpp"
+#endif
 
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#include "checkpoint.hpp"            // for CheckpointReader, CheckpointWriter
+#endif
 #ifndef __LIBARCSTK_CHECKSUM_HPP__
 #include "checksum.hpp"              // for type, ChecksumSet
 #endif
@@ -23,9 +29,27 @@
 #include "metadata.hpp"              // for AudioSize
 #endif
 
-#include <cstdint>       // for int32_t, uint_fast64_t
+#include <algorithm>     // for copy, fill, max, min
+#include <array>         // for array
+#include <cstddef>       // for size_t
+#include <cstdint>       // for int32_t, int64_t, uint64_t, uint_fast64_t
 #include <memory>        // for make_unique, unique_ptr
-#include <utility>       // for pair
+#include <stdexcept>     // for invalid_argument
+#include <string>        // for to_string
+#include <system_error>  // for system_error
+#include <thread>        // for thread
+#include <utility>       // for move, pair
+#include <vector>        // for vector
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// g++ 12 issues false positives on the AVX-512 intrinsics (GCC bug 105593)
+#pragma GCC diagnostic push
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>   // for SSE4.1, AVX2 and AVX-512 intrinsics
+#pragma GCC diagnostic pop
+#endif
 
 namespace arcstk
 {
@@ -39,9 +63,480 @@ namespace details
 using cstype = checksum::type; // local, for Readability
 
 
+// accuraterip_details.hpp
+
+
+namespace
+{
+
+/**
+ * \brief Greatest multiplier the vectorized kernels can process.
+ *
+ * The vectorized kernels multiply 32 bit by 32 bit, hence the multiplier must
+ * fit in 32 bits.
+ */
+constexpr uint_fast64_t MAX_VECTOR_MULTIPLIER { 0xFFFFFFFF };
+
+
+/**
+ * \brief Scalar kernel for sum_products().
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+ProductSums sum_products_scalar(const sample_t* start, const sample_t* stop,
+		uint_fast64_t multiplier)
+{
+	auto sums    = ProductSums {};
+	auto product = uint_fast64_t { 0 };
+
+	for (auto pos = start; pos != stop; ++pos, ++multiplier)
+	{
+		product      = multiplier * (*pos);
+		sums.lower  += product & LOWER_32_BITS_;
+		sums.higher += product >> 32u;
+	}
+
+	return sums;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+// TODO C-style stuff: The vectorized kernels are only expressible by the
+// compiler intrinsics. Each kernel is compiled for its own target, hence they
+// do not require -march=native. The kernel to use is selected at runtime.
+
+// Each kernel zero-extends the 32 bit samples to 64 bit lanes and multiplies
+// them with a vector of consecutive multipliers that is advanced by the
+// number of lanes in each step. The lower and higher 32 bits of the 64 bit
+// products are accumulated in separate 64 bit lanes. The remainder of the
+// sequence that does not fill an entire step is processed by the scalar kernel.
+
+
+/**
+ * \brief Kernel for sum_products() using SSE4.1, 4 samples per step.
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+__attribute__((target("sse4.1")))
+ProductSums sum_products_sse41(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	const auto steps { (stop - start) / 4 };
+
+	const auto mask { _mm_set1_epi64x(static_cast<int64_t>(LOWER_32_BITS_)) };
+	const auto step { _mm_set1_epi64x(4) };
+
+	auto m01 { _mm_set_epi64x(static_cast<int64_t>(multiplier + 1),
+			static_cast<int64_t>(multiplier)) };
+	auto m23 { _mm_set_epi64x(static_cast<int64_t>(multiplier + 3),
+			static_cast<int64_t>(multiplier + 2)) };
+
+	auto lower  { _mm_setzero_si128() };
+	auto higher { _mm_setzero_si128() };
+
+	auto pos { start };
+	for (auto i = decltype(steps) { 0 }; i < steps; ++i, pos += 4)
+	{
+		const auto s   { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(pos)) };
+
+		const auto p01 { _mm_mul_epu32(_mm_cvtepu32_epi64(s), m01) };
+		const auto p23 { _mm_mul_epu32(
+				_mm_cvtepu32_epi64(_mm_srli_si128(s, 8)), m23) };
+
+		lower  = _mm_add_epi64(lower,  _mm_add_epi64(
+					_mm_and_si128(p01, mask), _mm_and_si128(p23, mask)));
+		higher = _mm_add_epi64(higher, _mm_add_epi64(
+					_mm_srli_epi64(p01, 32),  _mm_srli_epi64(p23, 32)));
+
+		m01 = _mm_add_epi64(m01, step);
+		m23 = _mm_add_epi64(m23, step);
+	}
+
+	auto l = std::array<uint64_t, 2> {};
+	auto h = std::array<uint64_t, 2> {};
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(l.data()), lower);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(h.data()), higher);
+
+	auto sums { sum_products_scalar(pos, stop,
+			multiplier + static_cast<uint_fast64_t>(pos - start)) };
+
+	sums.lower  += l[0] + l[1];
+	sums.higher += h[0] + h[1];
+
+	return sums;
+}
+
+
+/**
+ * \brief Kernel for sum_products() using AVX2, 8 samples per step.
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+__attribute__((target("avx2")))
+ProductSums sum_products_avx2(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	const auto steps { (stop - start) / 8 };
+
+	const auto mask {
+		_mm256_set1_epi64x(static_cast<int64_t>(LOWER_32_BITS_)) };
+	const auto step { _mm256_set1_epi64x(8) };
+
+	auto m0_3 { _mm256_set_epi64x(
+			static_cast<int64_t>(multiplier + 3),
+			static_cast<int64_t>(multiplier + 2),
+			static_cast<int64_t>(multiplier + 1),
+			static_cast<int64_t>(multiplier)) };
+	auto m4_7 { _mm256_add_epi64(m0_3, _mm256_set1_epi64x(4)) };
+
+	auto lower  { _mm256_setzero_si256() };
+	auto higher { _mm256_setzero_si256() };
+
+	auto pos { start };
+	for (auto i = decltype(steps) { 0 }; i < steps; ++i, pos += 8)
+	{
+		const auto s0_3 { _mm256_cvtepu32_epi64(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(pos))) };
+		const auto s4_7 { _mm256_cvtepu32_epi64(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(pos + 4))) };
+
+		const auto p0_3 { _mm256_mul_epu32(s0_3, m0_3) };
+		const auto p4_7 { _mm256_mul_epu32(s4_7, m4_7) };
+
+		lower  = _mm256_add_epi64(lower,  _mm256_add_epi64(
+				_mm256_and_si256(p0_3, mask), _mm256_and_si256(p4_7, mask)));
+		higher = _mm256_add_epi64(higher, _mm256_add_epi64(
+				_mm256_srli_epi64(p0_3, 32),  _mm256_srli_epi64(p4_7, 32)));
+
+		m0_3 = _mm256_add_epi64(m0_3, step);
+		m4_7 = _mm256_add_epi64(m4_7, step);
+	}
+
+	auto l = std::array<uint64_t, 4> {};
+	auto h = std::array<uint64_t, 4> {};
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(l.data()), lower);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(h.data()), higher);
+
+	auto sums { sum_products_scalar(pos, stop,
+			multiplier + static_cast<uint_fast64_t>(pos - start)) };
+
+	sums.lower  += l[0] + l[1] + l[2] + l[3];
+	sums.higher += h[0] + h[1] + h[2] + h[3];
+
+	return sums;
+}
+
+
+/**
+ * \brief Kernel for sum_products() using AVX-512F, 16 samples per step.
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+__attribute__((target("avx512f")))
+ProductSums sum_products_avx512f(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	const auto steps { (stop - start) / 16 };
+
+	const auto mask {
+		_mm512_set1_epi64(static_cast<int64_t>(LOWER_32_BITS_)) };
+	const auto step { _mm512_set1_epi64(16) };
+
+	auto m0_7 { _mm512_add_epi64(
+			_mm512_set1_epi64(static_cast<int64_t>(multiplier)),
+			_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0)) };
+	auto m8_15 { _mm512_add_epi64(m0_7, _mm512_set1_epi64(8)) };
+
+	auto lower  { _mm512_setzero_si512() };
+	auto higher { _mm512_setzero_si512() };
+
+	auto pos { start };
+	for (auto i = decltype(steps) { 0 }; i < steps; ++i, pos += 16)
+	{
+		const auto s0_7  { _mm512_cvtepu32_epi64(_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(pos))) };
+		const auto s8_15 { _mm512_cvtepu32_epi64(_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(pos + 8))) };
+
+		const auto p0_7  { _mm512_mul_epu32(s0_7,  m0_7)  };
+		const auto p8_15 { _mm512_mul_epu32(s8_15, m8_15) };
+
+		lower  = _mm512_add_epi64(lower,  _mm512_add_epi64(
+				_mm512_and_si512(p0_7, mask), _mm512_and_si512(p8_15, mask)));
+		higher = _mm512_add_epi64(higher, _mm512_add_epi64(
+				_mm512_srli_epi64(p0_7, 32),  _mm512_srli_epi64(p8_15, 32)));
+
+		m0_7  = _mm512_add_epi64(m0_7,  step);
+		m8_15 = _mm512_add_epi64(m8_15, step);
+	}
+
+	auto sums { sum_products_scalar(pos, stop,
+			multiplier + static_cast<uint_fast64_t>(pos - start)) };
+
+	sums.lower  += static_cast<uint64_t>(_mm512_reduce_add_epi64(lower));
+	sums.higher += static_cast<uint64_t>(_mm512_reduce_add_epi64(higher));
+
+	return sums;
+}
+
+
+/**
+ * \brief Inspect the CPU for support of an InstructionSet.
+ *
+ * \param[in] isa InstructionSet to check
+ *
+ * \return TRUE iff the CPU supports \c isa, otherwise FALSE
+ */
+bool cpu_supports(const InstructionSet isa) noexcept
+{
+	__builtin_cpu_init();
+
+	switch (isa)
+	{
+		case InstructionSet::SCALAR:
+			return true;
+		case InstructionSet::SSE41:
+			return __builtin_cpu_supports("sse4.1") != 0;
+		case InstructionSet::AVX2:
+			return __builtin_cpu_supports("avx2") != 0;
+		case InstructionSet::AVX512F:
+			return __builtin_cpu_supports("avx512f") != 0;
+		default: ;
+	}
+
+	return false;
+}
+
+
+/**
+ * \brief Call the kernel for a supported InstructionSet.
+ *
+ * \param[in] isa        InstructionSet of the kernel to use
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+ProductSums call_kernel(const InstructionSet isa,
+		const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	switch (isa)
+	{
+		case InstructionSet::SSE41:
+			return sum_products_sse41(start, stop, multiplier);
+		case InstructionSet::AVX2:
+			return sum_products_avx2(start, stop, multiplier);
+		case InstructionSet::AVX512F:
+			return sum_products_avx512f(start, stop, multiplier);
+		default: ;
+	}
+
+	return sum_products_scalar(start, stop, multiplier);
+}
+
+#else // no vectorized kernels available for this platform
+
+bool cpu_supports(const InstructionSet isa) noexcept
+{
+	return isa == InstructionSet::SCALAR;
+}
+
+
+ProductSums call_kernel(const InstructionSet /* isa */,
+		const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	return sum_products_scalar(start, stop, multiplier);
+}
+
+#endif
+
+} // namespace
+
+
+std::string to_string(const InstructionSet isa)
+{
+	switch (isa)
+	{
+		case InstructionSet::SCALAR:  return "scalar";
+		case InstructionSet::SSE41:   return "SSE4.1";
+		case InstructionSet::AVX2:    return "AVX2";
+		case InstructionSet::AVX512F: return "AVX-512F";
+		default: ;
+	}
+
+	return {};
+}
+
+
+bool is_supported(const InstructionSet isa) noexcept
+{
+	return cpu_supports(isa);
+}
+
+
+InstructionSet best_instruction_set() noexcept
+{
+	static const auto best { []
+	{
+		for (const auto& isa : { InstructionSet::AVX512F,
+				InstructionSet::AVX2, InstructionSet::SSE41 })
+		{
+			if (cpu_supports(isa))
+			{
+				return isa;
+			}
+		}
+
+		return InstructionSet::SCALAR;
+	}() };
+
+	return best;
+}
+
+
+ProductSums sum_products(const InstructionSet isa,
+		const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	const auto last_multiplier {
+		multiplier + static_cast<uint_fast64_t>(stop - start) };
+
+	// Vectorized kernels cannot process multipliers wider than 32 bits.
+	if (last_multiplier > MAX_VECTOR_MULTIPLIER || !is_supported(isa))
+	{
+		return sum_products_scalar(start, stop, multiplier);
+	}
+
+	return call_kernel(isa, start, stop, multiplier);
+}
+
+
+ProductSums sum_products(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier)
+{
+	const auto last_multiplier {
+		multiplier + static_cast<uint_fast64_t>(stop - start) };
+
+	if (last_multiplier > MAX_VECTOR_MULTIPLIER)
+	{
+		return sum_products_scalar(start, stop, multiplier);
+	}
+
+	return call_kernel(best_instruction_set(), start, stop, multiplier);
+}
+
+
+ProductSums sum_products(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier, const unsigned threads)
+{
+	const auto total_samples { static_cast<std::size_t>(stop - start) };
+
+	const auto total_shards { std::min(std::size_t { threads },
+			total_samples / MIN_SAMPLES_PER_THREAD) };
+
+	if (total_shards < 2)
+	{
+		return sum_products(start, stop, multiplier);
+	}
+
+	const auto samples_per_shard { total_samples / total_shards };
+
+	// Shard i starts at sample i * samples_per_shard, the last shard also
+	// contains the remainder of the sequence.
+
+	const auto shard_start = [&](const std::size_t i)
+	{
+		return start + i * samples_per_shard;
+	};
+
+	const auto shard_stop = [&](const std::size_t i)
+	{
+		return i + 1 < total_shards ? shard_start(i + 1) : stop;
+	};
+
+	auto partial_sums = std::vector<ProductSums>(total_shards);
+	auto workers      = std::vector<std::thread> {};
+	workers.reserve(total_shards - 1);
+
+	auto shard = std::size_t { 1 };
+	try
+	{
+		for (; shard < total_shards; ++shard)
+		{
+			workers.emplace_back([&partial_sums, shard, &shard_start,
+					&shard_stop, multiplier, samples_per_shard]
+			{
+				partial_sums[shard] = sum_products(
+						shard_start(shard), shard_stop(shard),
+						multiplier + shard * samples_per_shard);
+			});
+		}
+	} catch (const std::system_error& e)
+	{
+		ARCS_LOG_WARNING << "Could not start thread for shard " << shard
+			<< ": " << e.what() << ", process remaining shards sequentially";
+	}
+
+	// Process the first shard and every shard no thread could be started for
+	// in the calling thread.
+
+	partial_sums[0] = sum_products(start, shard_stop(0), multiplier);
+
+	for (auto i { shard }; i < total_shards; ++i)
+	{
+		partial_sums[i] = sum_products(shard_start(i), shard_stop(i),
+				multiplier + i * samples_per_shard);
+	}
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	auto sums = ProductSums {};
+	for (const auto& partial : partial_sums)
+	{
+		sums.lower  += partial.lower;
+		sums.higher += partial.higher;
+	}
+
+	return sums;
+}
+
+
 // Update
 
 
+void Update<cstype::ARCS1>::operator()(const sample_t* start,
+		const sample_t* stop, Subtotals& st, const unsigned threads) const
+{
+	const auto sums { sum_products(start, stop, st.multiplier, threads) };
+
+	st.subtotal_v1 += sums.lower;
+	st.multiplier  += static_cast<uint_fast64_t>(stop - start);
+}
+
+
 ChecksumSet Update<cstype::ARCS1>::value(const Subtotals& st) const
 {
 	return { 0, {{ cstype::ARCS1, st.subtotal_v1 }} };
@@ -54,6 +549,22 @@ std::string Update<cstype::ARCS1>::id_string() const
 }
 
 
+void Update<cstype::ARCS2>::operator()(const sample_t* start,
+		const sample_t* stop, Subtotals& st, const unsigned threads) const
+{
+	if (start == stop)
+	{
+		return;
+	}
+
+	const auto sums { sum_products(start, stop, st.multiplier, threads) };
+
+	st.subtotal_v2 += sums.lower + sums.higher;
+	st.multiplier  += static_cast<uint_fast64_t>(stop - start);
+	st.update       = (st.multiplier - 1) * *(stop - 1);
+}
+
+
 ChecksumSet Update<cstype::ARCS2>::value(const Subtotals& st) const
 {
 	return { 0, {{ cstype::ARCS2, st.subtotal_v2 }} };
@@ -66,6 +577,23 @@ std::string Update<cstype::ARCS2>::id_string() const
 }
 
 
+void Update<cstype::ARCS1, cstype::ARCS2>::operator()(const sample_t* start,
+		const sample_t* stop, Subtotals& st, const unsigned threads) const
+{
+	if (start == stop)
+	{
+		return;
+	}
+
+	const auto sums { sum_products(start, stop, st.multiplier, threads) };
+
+	st.subtotal_v1 += sums.lower;
+	st.subtotal_v2 += sums.higher;
+	st.multiplier  += static_cast<uint_fast64_t>(stop - start);
+	st.update       = (st.multiplier - 1) * *(stop - 1);
+}
+
+
 ChecksumSet Update<cstype::ARCS1, cstype::ARCS2>::value(
 		const Subtotals& st) const
 {
@@ -88,8 +616,9 @@ std::string Update<cstype::ARCS1, cstype::ARCS2>::id_string()
 
 template <cstype T1, cstype... T2>
 AccurateRipCS<T1, T2...>::AccurateRipCS()
-	: st_     { /*default*/ }
-	, update_ { /*default*/ }
+	: st_      { /*default*/ }
+	, update_  { /*default*/ }
+	, threads_ { 1 }
 {
 	// empty
 }
@@ -109,11 +638,50 @@ void AccurateRipCS<T1, T2...>::set_multiplier(const uint_fast64_t m)
 }
 
 
+template <cstype T1, cstype... T2>
+unsigned AccurateRipCS<T1, T2...>::threads() const
+{
+	return threads_;
+}
+
+
+template <cstype T1, cstype... T2>
+void AccurateRipCS<T1, T2...>::set_threads(const unsigned threads)
+{
+	threads_ = threads;
+}
+
+
 template <cstype T1, cstype... T2>
 void AccurateRipCS<T1, T2...>::update(const SampleInputIterator& start,
 			const SampleInputIterator& stop)
 {
-	update_(start, stop, st_);
+	alignas(SCRATCH_BUFFER_ALIGNMENT)
+		std::array<sample_t, SCRATCH_BUFFER_SIZE> buffer;
+
+	constexpr auto block_size {
+		static_cast<SampleInputIterator::difference_type>(buffer.size()) };
+
+	auto pos { start };
+	auto remaining { stop - start };
+
+	while (remaining > 0)
+	{
+		const auto n { std::min(remaining, block_size) };
+
+		pos.copy(n, buffer.data()); // advances pos
+		this->update(buffer.data(), buffer.data() + n);
+
+		remaining -= n;
+	}
+}
+
+
+template <cstype T1, cstype... T2>
+void AccurateRipCS<T1, T2...>::update(const sample_t* start,
+			const sample_t* stop)
+{
+	update_(start, stop, st_, threads_);
 }
 
 
@@ -133,6 +701,20 @@ void AccurateRipCS<T1, T2...>::reset()
 }
 
 
+template <cstype T1, cstype... T2>
+const Subtotals& AccurateRipCS<T1, T2...>::subtotals() const
+{
+	return st_;
+}
+
+
+template <cstype T1, cstype... T2>
+void AccurateRipCS<T1, T2...>::set_subtotals(const Subtotals& st)
+{
+	st_ = st;
+}
+
+
 // ARCSAlgorithm
 
 
@@ -157,6 +739,17 @@ void ARCSAlgorithm<T1, T2...>::do_setup(const Settings* s)
 	}
 
 	ARCS_LOG(DEBUG1) << "Initialize multiplier to: " << state_.multiplier();
+
+	auto threads { s->threads() };
+
+	if (threads == 0)
+	{
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	state_.set_threads(threads);
+
+	ARCS_LOG(DEBUG1) << "Use up to " << threads << " thread(s) per update";
 }
 
 
@@ -173,6 +766,18 @@ void ARCSAlgorithm<T1, T2...>::do_update(SampleInputIterator start,
 }
 
 
+template <cstype T1, cstype... T2>
+void ARCSAlgorithm<T1, T2...>::do_update(const sample_t* start,
+		const sample_t* stop)
+{
+	ARCS_LOG(DEBUG3) << "First multiplier: " << state_.multiplier();
+
+	state_.update(start, stop);
+
+	ARCS_LOG(DEBUG3) << "Last multiplier:  " << state_.multiplier() - 1;
+}
+
+
 template <cstype T1, cstype... T2>
 void ARCSAlgorithm<T1, T2...>::do_track_finished(const int /*t*/,
 		const AudioSize& s)
@@ -185,6 +790,13 @@ void ARCSAlgorithm<T1, T2...>::do_track_finished(const int /*t*/,
 }
 
 
+template <cstype T1, cstype... T2>
+uint_fast64_t ARCSAlgorithm<T1, T2...>::multiplier() const
+{
+	return state_.multiplier();
+}
+
+
 template <cstype T1, cstype... T2>
 ChecksumSet ARCSAlgorithm<T1, T2...>::do_result() const
 {
@@ -193,7 +805,7 @@ ChecksumSet ARCSAlgorithm<T1, T2...>::do_result() const
 
 
 template <cstype T1, cstype... T2>
-std::unordered_set<cstype> ARCSAlgorithm<T1, T2...>::do_types() const
+ChecksumtypeSet ARCSAlgorithm<T1, T2...>::do_types() const
 {
 	return state_.types();
 }
@@ -246,6 +858,690 @@ std::unique_ptr<Algorithm> ARCSAlgorithm<T1, T2...>::do_clone() const
 }
 
 
+template <cstype T1, cstype... T2>
+void ARCSAlgorithm<T1, T2...>::do_seek(const int /* t */, const int32_t index)
+{
+	state_.set_multiplier(static_cast<uint_fast64_t>(index) + 1);
+
+	ARCS_LOG(DEBUG1) << "Seek to multiplier: " << state_.multiplier();
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSAlgorithm<T1, T2...>::do_reset()
+{
+	state_.reset();
+	state_.set_multiplier(1);
+	current_result_ = ChecksumSet {};
+}
+
+
+template <cstype T1, cstype... T2>
+ChecksumSet ARCSAlgorithm<T1, T2...>::do_merge(const ChecksumSet& lhs,
+		const ChecksumSet& rhs, const int32_t /* samples */) const
+{
+	// The checksums are sums of the products of the samples and their
+	// multipliers, hence the sums of adjacent parts just add up
+
+	auto merged { ChecksumSet { lhs.length() + rhs.length() } };
+
+	for (const auto& type : state_.types())
+	{
+		merged.insert(type, (lhs.get(type).value() + rhs.get(type).value())
+				& LOWER_32_BITS_);
+	}
+
+	return merged;
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSAlgorithm<T1, T2...>::do_save(CheckpointWriter& out) const
+{
+	const auto& st { state_.subtotals() };
+
+	out.write_u64(st.multiplier);
+	out.write_u64(st.update);
+	out.write_u32(static_cast<uint32_t>(st.subtotal_v1));
+	out.write_u32(static_cast<uint32_t>(st.subtotal_v2));
+	out.write(current_result_);
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSAlgorithm<T1, T2...>::do_restore(CheckpointReader& in)
+{
+	auto st { Subtotals {} };
+
+	st.multiplier  = in.read_u64();
+	st.update      = in.read_u64();
+	st.subtotal_v1 = in.read_u32();
+	st.subtotal_v2 = in.read_u32();
+
+	auto result { in.read_checksums() };
+
+	state_.set_subtotals(st);
+	current_result_ = std::move(result);
+}
+
+
+// ARCSFrame450Base
+
+
+namespace
+{
+
+/**
+ * \brief 0-based index of the first sample of frame 450 within the track.
+ */
+constexpr int32_t FRAME450_START { 450 * CDDA::SAMPLES_PER_FRAME };
+
+/**
+ * \brief 0-based index behind the last sample of frame 450 within the track.
+ */
+constexpr int32_t FRAME450_END { FRAME450_START + CDDA::SAMPLES_PER_FRAME };
+
+} // namespace
+
+
+ARCSFrame450Base::ARCSFrame450Base(const int32_t max_offset)
+	: max_offset_ { max_offset }
+	, window_     { /* empty */ }
+	, windows_    { /* empty */ }
+{
+	if (max_offset < 0 || max_offset > FRAME450_START)
+	{
+		throw std::invalid_argument("Maximal offset must be in range 0 to "
+				+ std::to_string(FRAME450_START) + ", but is "
+				+ std::to_string(max_offset));
+	}
+
+	window_.resize(static_cast<std::size_t>(
+				CDDA::SAMPLES_PER_FRAME + 2 * max_offset));
+}
+
+
+std::pair<int32_t, int32_t> ARCSFrame450Base::window_range(
+		const int32_t first, const int32_t last) const
+{
+	const auto from { std::max(first, FRAME450_START - max_offset_) };
+
+	return { from, std::max(from, std::min(last, FRAME450_END + max_offset_)) };
+}
+
+
+sample_t* ARCSFrame450Base::window_at(const int32_t index)
+{
+	return window_.data() + (index - (FRAME450_START - max_offset_));
+}
+
+
+uint32_t ARCSFrame450Base::window_arcs() const
+{
+	const auto frame { window_.data() + max_offset_ };
+
+	return sum_products(frame, frame + CDDA::SAMPLES_PER_FRAME, 1).lower
+		& LOWER_32_BITS_;
+}
+
+
+void ARCSFrame450Base::finish_window(const int t, const bool complete)
+{
+	const auto track { static_cast<std::size_t>(t) };
+
+	if (windows_.size() < track)
+	{
+		windows_.resize(track);
+	}
+
+	if (complete)
+	{
+		windows_[track - 1] = window_;
+	}
+
+	std::fill(window_.begin(), window_.end(), 0);
+}
+
+
+void ARCSFrame450Base::reset_windows()
+{
+	std::fill(window_.begin(), window_.end(), 0);
+	windows_.clear();
+}
+
+
+void ARCSFrame450Base::save_windows(CheckpointWriter& out) const
+{
+	const auto write_window = [&out](const std::vector<sample_t>& window)
+	{
+		out.write_u32(static_cast<uint32_t>(window.size()));
+
+		for (const auto& sample : window)
+		{
+			out.write_u32(sample);
+		}
+	};
+
+	out.write_i32(max_offset_);
+	write_window(window_);
+
+	out.write_u32(static_cast<uint32_t>(windows_.size()));
+
+	for (const auto& window : windows_)
+	{
+		write_window(window);
+	}
+}
+
+
+void ARCSFrame450Base::restore_windows(CheckpointReader& in)
+{
+	const auto max_offset { in.read_i32() };
+
+	if (max_offset != max_offset_)
+	{
+		throw std::invalid_argument("Checkpoint retains windows for maximal "
+				"offset " + std::to_string(max_offset) + " instead of "
+				+ std::to_string(max_offset_));
+	}
+
+	const auto read_window = [&in]()
+	{
+		auto window = std::vector<sample_t>(in.read_u32());
+
+		for (auto& sample : window)
+		{
+			sample = in.read_u32();
+		}
+
+		return window;
+	};
+
+	auto window { read_window() };
+
+	if (window.size() != window_.size())
+	{
+		throw std::invalid_argument("Checkpoint contains a window of "
+				+ std::to_string(window.size()) + " samples instead of "
+				+ std::to_string(window_.size()));
+	}
+
+	auto windows = std::vector<std::vector<sample_t>>(in.read_u32());
+
+	for (auto& w : windows)
+	{
+		w = read_window();
+	}
+
+	window_  = std::move(window);
+	windows_ = std::move(windows);
+}
+
+
+void ARCSFrame450Base::swap_windows(ARCSFrame450Base& rhs) noexcept
+{
+	using std::swap;
+
+	swap(max_offset_, rhs.max_offset_);
+	swap(window_,     rhs.window_);
+	swap(windows_,    rhs.windows_);
+}
+
+
+int32_t ARCSFrame450Base::max_offset() const noexcept
+{
+	return max_offset_;
+}
+
+
+std::vector<sample_t> ARCSFrame450Base::frame450_window(const int track) const
+{
+	if (track < 1 || static_cast<std::size_t>(track) > windows_.size())
+	{
+		return {};
+	}
+
+	return windows_[static_cast<std::size_t>(track - 1)];
+}
+
+
+// ARCSFrame450Algorithm
+
+
+template <cstype T1, cstype... T2>
+ARCSFrame450Algorithm<T1, T2...>::ARCSFrame450Algorithm()
+	: ARCSFrame450Algorithm { 0 }
+{
+	// empty
+}
+
+
+template <cstype T1, cstype... T2>
+ARCSFrame450Algorithm<T1, T2...>::ARCSFrame450Algorithm(
+		const int32_t max_offset)
+	: ARCSFrame450Base { max_offset }
+	, arcs_            { /* default */ }
+	, current_result_  { /* default */ }
+{
+	// empty
+}
+
+
+template <cstype T1, cstype... T2>
+std::pair<int32_t, int32_t> ARCSFrame450Algorithm<T1, T2...>::update_range(
+		const uint_fast64_t first_multiplier) const
+{
+	return this->window_range(static_cast<int32_t>(first_multiplier - 1),
+			static_cast<int32_t>(arcs_.multiplier() - 1));
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_setup(const Settings* s)
+{
+	arcs_.set_settings(s);
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_update(SampleInputIterator start,
+		SampleInputIterator stop)
+{
+	const auto first_multiplier { arcs_.multiplier() };
+
+	arcs_.update(start, stop);
+
+	const auto range { update_range(first_multiplier) };
+
+	if (range.first == range.second)
+	{
+		return;
+	}
+
+	start += range.first - static_cast<int32_t>(first_multiplier - 1);
+	start.copy(range.second - range.first, this->window_at(range.first));
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_update(const sample_t* start,
+		const sample_t* stop)
+{
+	const auto first_multiplier { arcs_.multiplier() };
+
+	arcs_.update(start, stop);
+
+	const auto range { update_range(first_multiplier) };
+
+	if (range.first == range.second)
+	{
+		return;
+	}
+
+	const auto first { start
+		+ (range.first - static_cast<int32_t>(first_multiplier - 1)) };
+
+	std::copy(first, first + (range.second - range.first),
+			this->window_at(range.first));
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_track_finished(const int t,
+		const AudioSize& length)
+{
+	const auto processed { arcs_.multiplier() - 1 };
+
+	arcs_.track_finished(t, length);
+
+	current_result_ = arcs_.result();
+
+	if (processed >= FRAME450_END)
+	{
+		current_result_.insert(cstype::FRAME450, this->window_arcs());
+	}
+
+	this->finish_window(t, processed >= static_cast<uint_fast64_t>(
+				FRAME450_END + this->max_offset()));
+}
+
+
+template <cstype T1, cstype... T2>
+ChecksumSet ARCSFrame450Algorithm<T1, T2...>::do_result() const
+{
+	return current_result_;
+}
+
+
+template <cstype T1, cstype... T2>
+ChecksumtypeSet ARCSFrame450Algorithm<T1, T2...>::do_types() const
+{
+	auto types { arcs_.types() };
+	types.insert(cstype::FRAME450);
+	return types;
+}
+
+
+template <cstype T1, cstype... T2>
+std::pair<int32_t, int32_t> ARCSFrame450Algorithm<T1, T2...>::do_range(
+		const AudioSize& size, const Points& points) const
+{
+	return arcs_.range(size, points);
+}
+
+
+template <cstype T1, cstype... T2>
+std::unique_ptr<Algorithm> ARCSFrame450Algorithm<T1, T2...>::do_clone() const
+{
+	return std::make_unique<ARCSFrame450Algorithm>(*this);
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_reset()
+{
+	arcs_.reset();
+	this->reset_windows();
+	current_result_ = ChecksumSet {};
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_save(CheckpointWriter& out) const
+{
+	arcs_.save(out);
+	this->save_windows(out);
+	out.write(current_result_);
+}
+
+
+template <cstype T1, cstype... T2>
+void ARCSFrame450Algorithm<T1, T2...>::do_restore(CheckpointReader& in)
+{
+	arcs_.restore(in);
+	this->restore_windows(in);
+	current_result_ = in.read_checksums();
+}
+
+
+// ARCSOffsetScanner
+
+
+ARCSOffsetScanner::ARCSOffsetScanner(const Context ctx, const AudioSize& size,
+		const Points& points, const int32_t max_offset)
+	: max_offset_    { max_offset }
+	, total_samples_ { size.samples() }
+	, processed_     { 0 }
+	, tracks_        {}
+{
+	if (max_offset < 0)
+	{
+		throw std::invalid_argument("Maximal offset must not be negative, "
+				"but is " + std::to_string(max_offset));
+	}
+
+	auto starts { std::vector<int32_t>{} };
+
+	if (points.empty())
+	{
+		starts.push_back(0);
+	} else
+	{
+		for (const auto& p : points)
+		{
+			if (p.samples() > total_samples_)
+			{
+				throw std::invalid_argument("Offset " +
+					std::to_string(p.samples()) + " exceeds input size of " +
+					std::to_string(total_samples_) + " samples");
+			}
+
+			starts.push_back(p.samples());
+		}
+	}
+
+	const auto retained { static_cast<std::size_t>(2 * max_offset_) };
+
+	tracks_.resize(starts.size());
+
+	for (auto t = std::size_t { 0 }; t < starts.size(); ++t)
+	{
+		auto& w { tracks_[t] };
+
+		const auto end { t + 1 < starts.size() ? starts[t + 1] : total_samples_ };
+
+		w.start = starts[t];
+		w.first = w.start;
+		w.last  = end;
+
+		if (t == 0 && any(Context::FIRST_TRACK & ctx))
+		{
+			w.first += NUM_SKIP_SAMPLES::FRONT;
+		}
+
+		if (t + 1 == starts.size() && any(Context::LAST_TRACK & ctx))
+		{
+			w.last -= NUM_SKIP_SAMPLES::BACK;
+		}
+
+		w.last   = std::max(w.first, w.last);
+		w.frames = AudioSize { w.last - w.first, UNIT::SAMPLES }.frames();
+
+		w.head.resize(retained);
+		w.tail.resize(retained);
+	}
+
+	ARCS_LOG(DEBUG1) << "Scan " << tracks_.size() << " track(s) for offsets "
+		<< -max_offset_ << " to " << max_offset_;
+
+	if (complete()) // empty input
+	{
+		this->finish();
+	}
+}
+
+
+ARCSOffsetScanner::ARCSOffsetScanner(const Context ctx, const AudioSize& size,
+		const Points& points)
+	: ARCSOffsetScanner(ctx, size, points, NUM_SKIP_SAMPLES::BACK)
+{
+	// empty
+}
+
+
+int32_t ARCSOffsetScanner::max_offset() const noexcept
+{
+	return max_offset_;
+}
+
+
+int ARCSOffsetScanner::total_tracks() const noexcept
+{
+	return static_cast<int>(tracks_.size());
+}
+
+
+int32_t ARCSOffsetScanner::samples_processed() const noexcept
+{
+	return processed_;
+}
+
+
+bool ARCSOffsetScanner::complete() const noexcept
+{
+	return processed_ >= total_samples_;
+}
+
+
+void ARCSOffsetScanner::update(const sample_t* start, const sample_t* stop)
+{
+	if (stop - start > total_samples_ - processed_)
+	{
+		throw std::invalid_argument("Update of " +
+				std::to_string(stop - start) + " samples exceeds input size");
+	}
+
+	const auto from { processed_ };
+	const auto to   { static_cast<int32_t>(from + (stop - start)) };
+
+	// Pointer to the sample with the specified absolute index
+	const auto at = [start,from](const int32_t index)
+	{
+		return start + (index - from);
+	};
+
+	for (auto& w : tracks_)
+	{
+		// Sums over the extended range
+
+		auto lo { std::max(from, w.first - max_offset_) };
+		auto hi { std::min(to,   w.last  + max_offset_) };
+
+		if (lo < hi)
+		{
+			for (auto pos = at(lo); pos != at(hi); ++pos)
+			{
+				w.sum += *pos;
+			}
+
+			w.wsum += static_cast<uint32_t>(sum_products(at(lo), at(hi),
+						static_cast<uint_fast64_t>(lo) + 1).lower);
+		}
+
+		// Samples around the bounds
+
+		lo = std::max(from, w.first - max_offset_);
+		hi = std::min(to,   w.first + max_offset_);
+
+		if (lo < hi)
+		{
+			std::copy(at(lo), at(hi), w.head.begin()
+					+ (lo - (w.first - max_offset_)));
+		}
+
+		lo = std::max(from, w.last - max_offset_);
+		hi = std::min(to,   w.last + max_offset_);
+
+		if (lo < hi)
+		{
+			std::copy(at(lo), at(hi), w.tail.begin()
+					+ (lo - (w.last - max_offset_)));
+		}
+
+		// ARCSv2 for offset 0
+
+		lo = std::max(from, w.first);
+		hi = std::min(to,   w.last);
+
+		if (lo < hi)
+		{
+			const auto sums { sum_products(at(lo), at(hi),
+					static_cast<uint_fast64_t>(lo - w.start) + 1) };
+
+			w.arcs2 += static_cast<uint32_t>(sums.lower + sums.higher);
+		}
+	}
+
+	processed_ = to;
+
+	if (from < total_samples_ && complete())
+	{
+		this->finish();
+	}
+}
+
+
+void ARCSOffsetScanner::finish()
+{
+	// Replace the retained samples by the sums of all samples before them.
+
+	const auto prefix_sums = [](std::vector<uint32_t>& samples,
+			std::vector<uint32_t>& weighted, const int32_t first_index)
+	{
+		samples.push_back(0);
+		weighted.resize(samples.size());
+
+		auto sum    { uint32_t { 0 } };
+		auto wsum   { uint32_t { 0 } };
+		auto weight { static_cast<uint32_t>(first_index) + 1 };
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); ++i, ++weight)
+		{
+			const auto sample { samples[i] };
+
+			samples[i]  = sum;
+			weighted[i] = wsum;
+
+			sum  += sample;
+			wsum += sample * weight;
+		}
+	};
+
+	for (auto& w : tracks_)
+	{
+		prefix_sums(w.head, w.head_w, w.first - max_offset_);
+		prefix_sums(w.tail, w.tail_w, w.last  - max_offset_);
+	}
+}
+
+
+Checksum ARCSOffsetScanner::arcs1(const int track, const int32_t offset) const
+{
+	if (track < 1 || track > total_tracks())
+	{
+		throw std::out_of_range("No track " + std::to_string(track));
+	}
+
+	if (offset < -max_offset_ || offset > max_offset_)
+	{
+		throw std::out_of_range("Offset " + std::to_string(offset)
+				+ " exceeds maximal offset " + std::to_string(max_offset_));
+	}
+
+	if (!complete())
+	{
+		throw std::logic_error("Offset scan is not complete");
+	}
+
+	const auto& w { tracks_[static_cast<std::size_t>(track - 1)] };
+	const auto  k { static_cast<std::size_t>(offset + max_offset_) };
+
+	// Subtract the samples in the extended range that precede resp. follow the
+	// range shifted by offset
+
+	const auto sum { w.sum - w.head[k] - (w.tail.back() - w.tail[k]) };
+
+	const auto wsum { w.wsum - w.head_w[k] - (w.tail_w.back() - w.tail_w[k]) };
+
+	return wsum - static_cast<uint32_t>(w.start + offset) * sum;
+}
+
+
+Checksums ARCSOffsetScanner::result(const int32_t offset) const
+{
+	auto checksums { Checksums{} };
+	checksums.reserve(tracks_.size());
+
+	for (auto t = 1; t <= total_tracks(); ++t)
+	{
+		const auto& w { tracks_[static_cast<std::size_t>(t - 1)] };
+
+		auto track { ChecksumSet { w.frames } };
+
+		track.insert(cstype::ARCS1, this->arcs1(t, offset));
+
+		if (offset == 0)
+		{
+			track.insert(cstype::ARCS2, w.arcs2);
+		}
+
+		checksums.push_back(track);
+	}
+
+	return checksums;
+}
+
+
 // Explicit instantiations
 
 
@@ -262,6 +1558,13 @@ template class ARCSAlgorithm<cstype::ARCS2>;
 
 template class ARCSAlgorithm<cstype::ARCS1, cstype::ARCS2>;
 
+
+template class ARCSFrame450Algorithm<cstype::ARCS1>;
+
+template class ARCSFrame450Algorithm<cstype::ARCS2>;
+
+template class ARCSFrame450Algorithm<cstype::ARCS1, cstype::ARCS2>;
+
 } // namespace details
 
 } // namespace accuraterip
@@ -0,0 +1,193 @@
+#ifndef __LIBARCSTK_ACCURATERIP_HPP__
+#error "Do not include accuraterip_details.hpp, include algorithms.hpp instead"
+#endif
+
+#ifndef __LIBARCSTK_ACCURATERIP_DETAILS_HPP__
+#define __LIBARCSTK_ACCURATERIP_DETAILS_HPP__
+
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation details for accuraterip.hpp.
+ */
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint_fast64_t
+#include <string>         // for string
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+namespace accuraterip
+{
+namespace details
+{
+
+/**
+ * \internal
+ *
+ * \brief Instruction set extensions for the accumulation kernels.
+ *
+ * The kernel to use is selected at runtime by inspecting the CPU. Hence, the
+ * vectorized kernels are available regardless of whether the library was
+ * compiled with platform specific optimization.
+ */
+enum class InstructionSet : unsigned
+{
+	SCALAR  = 0, // portable, 1 sample per step
+	SSE41   = 1, // 4 samples per step
+	AVX2    = 2, // 8 samples per step
+	AVX512F = 3  // 16 samples per step
+};
+
+/**
+ * \internal
+ *
+ * \brief Name of an InstructionSet.
+ *
+ * \param[in] isa InstructionSet to get the name of
+ *
+ * \return Name of the InstructionSet
+ */
+std::string to_string(const InstructionSet isa);
+
+/**
+ * \internal
+ *
+ * \brief Returns TRUE iff the kernel for \c isa can be used on this CPU.
+ *
+ * InstructionSet::SCALAR is always supported.
+ *
+ * \param[in] isa InstructionSet to check
+ *
+ * \return TRUE iff \c isa is supported on this CPU, otherwise FALSE
+ */
+bool is_supported(const InstructionSet isa) noexcept;
+
+/**
+ * \internal
+ *
+ * \brief The most capable InstructionSet supported on this CPU.
+ *
+ * The CPU is inspected on the first call, subsequent calls return the cached
+ * result.
+ *
+ * \return Best InstructionSet supported on this CPU
+ */
+InstructionSet best_instruction_set() noexcept;
+
+/**
+ * \internal
+ *
+ * \brief Sums of the lower and higher 32 bits of each product of a sample and
+ * its multiplier.
+ *
+ * The sums are not truncated to 32 bits. This allows to add them to the
+ * Subtotals with exactly the same result as accumulating each product on its
+ * own.
+ */
+struct ProductSums
+{
+	uint_fast64_t lower  = 0; // sum of the lower 32 bits of each product
+	uint_fast64_t higher = 0; // sum of the higher 32 bits of each product
+};
+
+/**
+ * \internal
+ *
+ * \brief Accumulate the products of a contiguous sequence of samples with
+ * their multipliers.
+ *
+ * The first sample is multiplied by \c multiplier, every subsequent sample by
+ * the multiplier of its predecessor + 1.
+ *
+ * If \c isa is not supported on this CPU, the scalar kernel is used.
+ *
+ * \param[in] isa        InstructionSet of the kernel to use
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+ProductSums sum_products(const InstructionSet isa,
+		const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier);
+
+/**
+ * \internal
+ *
+ * \brief Accumulate the products of a contiguous sequence of samples with
+ * their multipliers using the best kernel for this CPU.
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+ProductSums sum_products(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier);
+
+/**
+ * \internal
+ *
+ * \brief Accumulate the products of a contiguous sequence of samples with
+ * their multipliers using up to \c threads threads.
+ *
+ * Since the accumulated sums are additive, the sequence is split in shards of
+ * consecutive samples. Each shard is processed by its own thread, starting
+ * with the multiplier of its first sample. The partial sums of the shards are
+ * added afterwards.
+ *
+ * The sequence will not be split in shards smaller than
+ * MIN_SAMPLES_PER_THREAD samples. The first shard is processed by the
+ * calling thread.
+ *
+ * \param[in] start      Pointer to the first sample
+ * \param[in] stop       Pointer behind the last sample
+ * \param[in] multiplier Multiplier for the first sample
+ * \param[in] threads    Maximum number of threads to use
+ *
+ * \return Sums of the lower and higher 32 bits of the products
+ */
+ProductSums sum_products(const sample_t* start, const sample_t* stop,
+		const uint_fast64_t multiplier, const unsigned threads);
+
+/**
+ * \internal
+ *
+ * \brief Minimal number of samples a thread is started for.
+ */
+constexpr std::size_t MIN_SAMPLES_PER_THREAD { 1 << 20 };
+
+/**
+ * \internal
+ *
+ * \brief Number of samples in the scratch buffer for updates by iterators.
+ *
+ * Samples passed by a SampleInputIterator are copied block-wise to a scratch
+ * buffer of this size and the buffer is processed by the vectorized kernel.
+ * The buffer is small enough to reside in the L1 cache.
+ */
+constexpr std::size_t SCRATCH_BUFFER_SIZE { 4096 };
+
+/**
+ * \internal
+ *
+ * \brief Alignment of the scratch buffer for updates by iterators.
+ *
+ * Suitable for the widest vector register the kernels use.
+ */
+constexpr std::size_t SCRATCH_BUFFER_ALIGNMENT { 64 };
+
+} // namespace details
+} // namespace accuraterip
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
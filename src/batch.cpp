@@ -0,0 +1,520 @@
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation of the batch calculation API
+ */
+
+#ifndef __LIBARCSTK_BATCH_HPP__
+#include "batch.hpp"
+#endif
+#ifndef __LIBARCSTK_BATCH_DETAILS_HPP__
+#include "batch_details.hpp"
+#endif
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"                  // for Algorithm, Calculation, Context
+#endif
+#ifndef __LIBARCSTK_LOGGING_HPP__
+#include "logging.hpp"
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"                   // for AudioSize, ToC, UNIT
+#endif
+
+#include <algorithm>      // for copy, max, min
+#include <cstdint>        // for int32_t
+#include <exception>      // for current_exception, exception, exception_ptr
+#include <memory>         // for make_unique, unique_ptr
+#include <stdexcept>      // for invalid_argument, logic_error, runtime_error
+#include <string>         // for to_string
+#include <system_error>   // for system_error
+#include <thread>         // for thread
+#include <utility>        // for move
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+// SampleSource
+
+
+SampleSource::~SampleSource() noexcept = default;
+
+
+std::size_t SampleSource::read(sample_t* buffer, const std::size_t size)
+{
+	return this->do_read(buffer, size);
+}
+
+
+AudioSize SampleSource::size() const
+{
+	return this->do_size();
+}
+
+
+AudioSize SampleSource::do_size() const
+{
+	return AudioSize {};
+}
+
+
+// MemorySampleSource
+
+
+MemorySampleSource::MemorySampleSource(const sample_t* start,
+		const sample_t* stop) noexcept
+	: start_   { start }
+	, current_ { start }
+	, stop_    { stop  }
+{
+	// empty
+}
+
+
+std::size_t MemorySampleSource::do_read(sample_t* buffer,
+		const std::size_t size)
+{
+	const auto count { std::min(size,
+			static_cast<std::size_t>(stop_ - current_)) };
+
+	std::copy(current_, current_ + count, buffer);
+	current_ += count;
+
+	return count;
+}
+
+
+AudioSize MemorySampleSource::do_size() const
+{
+	return AudioSize { static_cast<int32_t>(stop_ - start_), UNIT::SAMPLES };
+}
+
+
+// BatchJob::State
+
+
+BatchJob::State::State(const std::size_t id, const AudioSize& size,
+		const Points& points, std::unique_ptr<SampleSource> source,
+		BatchCallback callback)
+	: id_       { id }
+	, status_   { JobStatus::QUEUED }
+	, size_     { size }
+	, points_   { points }
+	, source_   { std::move(source) }
+	, callback_ { std::move(callback) }
+	, promise_  {}
+	, future_   { promise_.get_future().share() }
+{
+	// empty
+}
+
+
+std::size_t BatchJob::State::id() const noexcept
+{
+	return id_;
+}
+
+
+JobStatus BatchJob::State::status() const noexcept
+{
+	return status_.load();
+}
+
+
+const std::shared_future<Checksums>& BatchJob::State::future() const noexcept
+{
+	return future_;
+}
+
+
+void BatchJob::State::run(std::unique_ptr<Calculation>& calculation,
+		const Algorithm& prototype, sample_t* buffer,
+		const std::size_t size) noexcept
+{
+	status_.store(JobStatus::RUNNING);
+
+	auto result = Checksums {};
+	auto error  = std::exception_ptr {};
+
+	try
+	{
+		if (calculation)
+		{
+			calculation->reset(size_, points_);
+		} else
+		{
+			calculation = std::make_unique<Calculation>(Context::ALBUM,
+					prototype.clone(), size_, points_);
+		}
+
+		result = this->calculate(*calculation, buffer, size);
+
+	} catch (...)
+	{
+		error = std::current_exception();
+	}
+
+	source_.reset();
+
+	if (error)
+	{
+		status_.store(JobStatus::FAILED);
+		promise_.set_exception(error);
+	} else
+	{
+		status_.store(JobStatus::COMPLETED);
+		promise_.set_value(result);
+	}
+
+	this->notify(result);
+}
+
+
+Checksums BatchJob::State::calculate(Calculation& calculation,
+		sample_t* buffer, const std::size_t size)
+{
+	auto total      = int32_t { 0 };
+	auto block_size = source_->read(buffer, size);
+
+	while (block_size > 0)
+	{
+		calculation.update(buffer, buffer + block_size);
+
+		total += static_cast<int32_t>(block_size);
+		block_size = source_->read(buffer, size);
+	}
+
+	if (!calculation.complete())
+	{
+		throw std::runtime_error("Sample source exhausted after "
+				+ std::to_string(total) + " samples, but calculation expects "
+				+ std::to_string(calculation.samples_expected()));
+	}
+
+	return calculation.take_result();
+}
+
+
+void BatchJob::State::notify(const Checksums& result) noexcept
+{
+	if (!callback_)
+	{
+		return;
+	}
+
+	try
+	{
+		callback_(id_, status_.load(), result);
+
+	} catch (const std::exception& e)
+	{
+		ARCS_LOG_ERROR << "Callback for batch job " << id_ << " failed: "
+			<< e.what();
+	} catch (...)
+	{
+		ARCS_LOG_ERROR << "Callback for batch job " << id_ << " failed";
+	}
+}
+
+
+// BatchJob
+
+
+BatchJob::BatchJob(std::shared_ptr<State> state) noexcept
+	: state_ { std::move(state) }
+{
+	// empty
+}
+
+
+std::size_t BatchJob::id() const noexcept
+{
+	return state_->id();
+}
+
+
+JobStatus BatchJob::status() const noexcept
+{
+	return state_->status();
+}
+
+
+void BatchJob::wait() const
+{
+	state_->future().wait();
+}
+
+
+Checksums BatchJob::result() const
+{
+	return state_->future().get();
+}
+
+
+std::shared_future<Checksums> BatchJob::future() const noexcept
+{
+	return state_->future();
+}
+
+
+// BatchCalculator::Impl
+
+
+BatchCalculator::Impl::Impl(std::unique_ptr<Algorithm> algorithm,
+		const unsigned threads)
+	: algorithm_  { std::move(algorithm) }
+	, queues_     {}
+	, workers_    {}
+	, mutex_      {}
+	, wakeup_     {}
+	, finished_   {}
+	, queued_     { 0 }
+	, unfinished_ { 0 }
+	, next_id_    { 0 }
+	, stop_       { false }
+{
+	if (!algorithm_)
+	{
+		throw std::invalid_argument("Algorithm for BatchCalculator is null");
+	}
+
+	try
+	{
+		algorithm_->clone()->reset();
+
+	} catch (const std::logic_error&)
+	{
+		throw std::invalid_argument(
+				"Algorithm for BatchCalculator does not support reset");
+	}
+
+	auto total_workers { threads > 0
+		? threads
+		: std::max(std::thread::hardware_concurrency(), 1u) };
+
+	queues_ = std::vector<details::batch::WorkerQueue>(total_workers);
+	workers_.reserve(total_workers);
+
+	try
+	{
+		for (auto w = std::size_t { 0 }; w < total_workers; ++w)
+		{
+			workers_.emplace_back(&Impl::work, this, w);
+		}
+	} catch (const std::system_error& e)
+	{
+		if (workers_.empty())
+		{
+			throw;
+		}
+
+		ARCS_LOG_WARNING << "Could not start thread " << workers_.size()
+			<< ": " << e.what() << ", use " << workers_.size() << " threads";
+	}
+}
+
+
+BatchCalculator::Impl::~Impl() noexcept
+{
+	this->shutdown();
+}
+
+
+BatchJob BatchCalculator::Impl::submit(const ToC& toc,
+		std::unique_ptr<SampleSource> source, BatchCallback callback)
+{
+	if (!source)
+	{
+		throw std::invalid_argument("SampleSource for batch job is null");
+	}
+
+	auto size { toc.complete() ? toc.leadout() : source->size() };
+
+	if (size.zero())
+	{
+		throw std::invalid_argument("ToC is incomplete and SampleSource "
+				"does not provide the total number of samples");
+	}
+
+	auto id = std::size_t { 0 };
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		id = next_id_++;
+		++unfinished_;
+	}
+
+	auto state { std::make_shared<BatchJob::State>(id, size, toc.offsets(),
+			std::move(source), std::move(callback)) };
+
+	// Distribute the jobs round robin, unbalanced queues are compensated by
+	// stealing.
+
+	auto& queue { queues_[id % queues_.size()] };
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(state);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		++queued_;
+	}
+	wakeup_.notify_one();
+
+	return BatchJob { state };
+}
+
+
+void BatchCalculator::Impl::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	finished_.wait(lock, [this]{ return unfinished_ == 0; });
+}
+
+
+std::size_t BatchCalculator::Impl::unfinished() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return unfinished_;
+}
+
+
+unsigned BatchCalculator::Impl::threads() const noexcept
+{
+	return static_cast<unsigned>(workers_.size());
+}
+
+
+void BatchCalculator::Impl::work(const std::size_t worker)
+{
+	// The buffer and the calculation are reused for every job the worker
+	// processes
+	auto buffer      { std::vector<sample_t>(details::batch::BLOCK_SIZE) };
+	auto calculation { std::unique_ptr<Calculation> {} };
+
+	while (true)
+	{
+		auto job { this->take(worker) };
+
+		if (!job)
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wakeup_.wait(lock, [this]{ return stop_ || queued_ > 0; });
+
+			if (queued_ == 0) // stop_ is set
+			{
+				return;
+			}
+
+			continue;
+		}
+
+		job->run(calculation, *algorithm_, buffer.data(), buffer.size());
+		job.reset();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--unfinished_;
+		}
+		finished_.notify_all();
+	}
+}
+
+
+std::shared_ptr<BatchJob::State> BatchCalculator::Impl::take(
+		const std::size_t worker)
+{
+	const auto total_queues { queues_.size() };
+
+	for (auto i = std::size_t { 0 }; i < total_queues; ++i)
+	{
+		auto& queue { queues_[(worker + i) % total_queues] };
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.jobs.empty())
+		{
+			continue;
+		}
+
+		auto job = std::shared_ptr<BatchJob::State> {};
+
+		if (i == 0) // own queue
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		} else
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+
+		--queued_;
+		return job;
+	}
+
+	return nullptr;
+}
+
+
+void BatchCalculator::Impl::shutdown() noexcept
+{
+	this->wait();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wakeup_.notify_all();
+
+	for (auto& worker : workers_)
+	{
+		worker.join();
+	}
+}
+
+
+// BatchCalculator
+
+
+BatchCalculator::BatchCalculator(std::unique_ptr<Algorithm> algorithm,
+		const unsigned threads)
+	: impl_ { std::make_unique<Impl>(std::move(algorithm), threads) }
+{
+	// empty
+}
+
+
+BatchCalculator::~BatchCalculator() noexcept = default;
+
+
+BatchJob BatchCalculator::submit(const ToC& toc,
+		std::unique_ptr<SampleSource> source, BatchCallback callback)
+{
+	return impl_->submit(toc, std::move(source), std::move(callback));
+}
+
+
+void BatchCalculator::wait()
+{
+	impl_->wait();
+}
+
+
+std::size_t BatchCalculator::unfinished() const noexcept
+{
+	return impl_->unfinished();
+}
+
+
+unsigned BatchCalculator::threads() const noexcept
+{
+	return impl_->threads();
+}
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
@@ -0,0 +1,336 @@
+#ifndef __LIBARCSTK_BATCH_HPP__
+#error "Do not include batch_details.hpp, include batch.hpp instead"
+#endif
+
+#ifndef __LIBARCSTK_BATCH_DETAILS_HPP__
+#define __LIBARCSTK_BATCH_DETAILS_HPP__
+
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation details for batch.hpp.
+ */
+
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <cstddef>            // for size_t
+#include <deque>              // for deque
+#include <future>             // for promise, shared_future
+#include <memory>             // for shared_ptr, unique_ptr
+#include <mutex>              // for mutex
+#include <thread>             // for thread
+#include <vector>             // for vector
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"  // for Algorithm, Calculation, sample_t
+#endif
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"   // for Checksums
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"   // for CDDA
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+/**
+ * \internal
+ *
+ * \brief Internal state of a BatchJob.
+ *
+ * The state is shared by the BatchJob handles and the worker thread that
+ * processes the job. The SampleSource is released as soon as the job is
+ * finished.
+ */
+class BatchJob::State final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] id       Id of the job
+	 * \param[in] size     Total number of samples
+	 * \param[in] points   Track offsets
+	 * \param[in] source   Source of the samples
+	 * \param[in] callback Callback to call on finish, may be empty
+	 */
+	State(const std::size_t id, const AudioSize& size, const Points& points,
+			std::unique_ptr<SampleSource> source, BatchCallback callback);
+
+	/**
+	 * \brief Id of the job.
+	 *
+	 * \return Id of the job
+	 */
+	std::size_t id() const noexcept;
+
+	/**
+	 * \brief Current status of the job.
+	 *
+	 * \return Current JobStatus
+	 */
+	JobStatus status() const noexcept;
+
+	/**
+	 * \brief Future for the result of the job.
+	 *
+	 * \return Future for the result of the job
+	 */
+	const std::shared_future<Checksums>& future() const noexcept;
+
+	/**
+	 * \brief Process the job.
+	 *
+	 * The \c calculation is reset for the job. If it is \c nullptr, it is
+	 * created with a clone of \c prototype. The samples are read from the
+	 * source to the buffer block by block. Any error is reported as result of
+	 * the job.
+	 *
+	 * \param[in,out] calculation Calculation to reuse for the job
+	 * \param[in]     prototype   Prototype of the Algorithm to use
+	 * \param[in]     buffer      Buffer for a block of samples
+	 * \param[in]     size        Size of the buffer in samples
+	 */
+	void run(std::unique_ptr<Calculation>& calculation,
+			const Algorithm& prototype, sample_t* buffer,
+			const std::size_t size) noexcept;
+
+private:
+
+	/**
+	 * \brief Perform the calculation.
+	 *
+	 * \param[in,out] calculation Calculation to perform
+	 * \param[in]     buffer      Buffer for a block of samples
+	 * \param[in]     size        Size of the buffer in samples
+	 *
+	 * \return Result of the calculation
+	 *
+	 * \throws std::runtime_error If the source is exhausted too early
+	 */
+	Checksums calculate(Calculation& calculation, sample_t* buffer,
+			const std::size_t size);
+
+	/**
+	 * \brief Notify the callback about the finished job.
+	 *
+	 * \param[in] result Result of the job
+	 */
+	void notify(const Checksums& result) noexcept;
+
+	/**
+	 * \brief Id of the job.
+	 */
+	const std::size_t id_;
+
+	/**
+	 * \brief Current status of the job.
+	 */
+	std::atomic<JobStatus> status_;
+
+	/**
+	 * \brief Total number of samples.
+	 */
+	const AudioSize size_;
+
+	/**
+	 * \brief Track offsets.
+	 */
+	const Points points_;
+
+	/**
+	 * \brief Source of the samples.
+	 */
+	std::unique_ptr<SampleSource> source_;
+
+	/**
+	 * \brief Callback to call on finish.
+	 */
+	BatchCallback callback_;
+
+	/**
+	 * \brief Promise for the result.
+	 */
+	std::promise<Checksums> promise_;
+
+	/**
+	 * \brief Future for the result.
+	 */
+	std::shared_future<Checksums> future_;
+};
+
+
+namespace details
+{
+namespace batch
+{
+
+/**
+ * \internal
+ *
+ * \brief Number of samples in the sample buffer of a worker thread.
+ *
+ * Equivalent to 256 frames. This is small enough to never let the Algorithm
+ * split an update between threads, since the BatchCalculator already occupies
+ * all threads.
+ */
+constexpr std::size_t BLOCK_SIZE { 256 * CDDA::SAMPLES_PER_FRAME };
+
+/**
+ * \internal
+ *
+ * \brief Queue of jobs owned by a worker thread.
+ *
+ * The owning worker takes jobs from the front, other workers steal jobs from
+ * the back.
+ */
+struct WorkerQueue final
+{
+	/**
+	 * \brief Mutex for accessing the jobs.
+	 */
+	std::mutex mutex {};
+
+	/**
+	 * \brief Queued jobs.
+	 */
+	std::deque<std::shared_ptr<BatchJob::State>> jobs {};
+};
+
+} // namespace batch
+} // namespace details
+
+
+/**
+ * \internal
+ *
+ * \brief Private implementation of BatchCalculator.
+ */
+class BatchCalculator::Impl final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] algorithm Prototype of the Algorithm to use for each job
+	 * \param[in] threads   Number of threads to use, 0 for hardware threads
+	 */
+	Impl(std::unique_ptr<Algorithm> algorithm, const unsigned threads);
+
+	Impl(const Impl& rhs) = delete;
+	Impl& operator=(const Impl& rhs) = delete;
+
+	/**
+	 * \brief Destructor.
+	 *
+	 * Blocks until all jobs are finished and joins the threads.
+	 */
+	~Impl() noexcept;
+
+	/**
+	 * \brief Implements BatchCalculator::submit().
+	 */
+	BatchJob submit(const ToC& toc, std::unique_ptr<SampleSource> source,
+			BatchCallback callback);
+
+	/**
+	 * \brief Implements BatchCalculator::wait().
+	 */
+	void wait();
+
+	/**
+	 * \brief Implements BatchCalculator::unfinished().
+	 */
+	std::size_t unfinished() const noexcept;
+
+	/**
+	 * \brief Implements BatchCalculator::threads().
+	 */
+	unsigned threads() const noexcept;
+
+private:
+
+	/**
+	 * \brief Main loop of a worker thread.
+	 *
+	 * \param[in] worker Index of the worker
+	 */
+	void work(const std::size_t worker);
+
+	/**
+	 * \brief Take a job from the own queue or steal one from another queue.
+	 *
+	 * \param[in] worker Index of the worker
+	 *
+	 * \return The job taken or \c nullptr if all queues are empty
+	 */
+	std::shared_ptr<BatchJob::State> take(const std::size_t worker);
+
+	/**
+	 * \brief Stop the worker threads after all jobs are finished.
+	 */
+	void shutdown() noexcept;
+
+	/**
+	 * \brief Prototype for the Algorithm of each job.
+	 */
+	std::unique_ptr<Algorithm> algorithm_;
+
+	/**
+	 * \brief Job queue of each worker.
+	 */
+	std::vector<details::batch::WorkerQueue> queues_;
+
+	/**
+	 * \brief Worker threads.
+	 */
+	std::vector<std::thread> workers_;
+
+	/**
+	 * \brief Mutex for sleeping and waiting.
+	 */
+	mutable std::mutex mutex_;
+
+	/**
+	 * \brief Notified when a job is queued or the workers are to stop.
+	 */
+	std::condition_variable wakeup_;
+
+	/**
+	 * \brief Notified when a job is finished.
+	 */
+	std::condition_variable finished_;
+
+	/**
+	 * \brief Number of jobs queued but not yet taken.
+	 */
+	std::atomic<std::size_t> queued_;
+
+	/**
+	 * \brief Number of jobs submitted but not yet finished.
+	 */
+	std::size_t unfinished_;
+
+	/**
+	 * \brief Id of the next job submitted.
+	 */
+	std::size_t next_id_;
+
+	/**
+	 * \brief TRUE iff the workers are to stop.
+	 */
+	bool stop_;
+};
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
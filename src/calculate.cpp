@@ -16,6 +16,9 @@
 #include "calculate_impl.hpp"
 #endif
 
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#include "checkpoint.hpp"    // for CheckpointReader, CheckpointWriter
+#endif
 #ifndef __LIBARCSTK_LOGGING_HPP__
 #include "logging.hpp"
 #endif
@@ -23,9 +26,21 @@
 #include "metadata.hpp"      // for AudioSize, ToC, CDDA
 #endif
 
-#include <algorithm>   // for min, max
+#include <algorithm>   // for min, max, upper_bound
+#include <chrono>      // for duration, duration_cast, nanoseconds, steady_clock
+#include <cstddef>     // for size_t
 #include <cstdint>     // for int32_t, uint16_t
 #include <iomanip>     // for setw, right
+#include <iterator>    // for distance
+#include <limits>      // for numeric_limits
+#include <stdexcept>   // for invalid_argument, logic_error
+#include <string>      // for to_string
+#include <utility>     // for pair
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>     // for __get_cpuid
+#include <x86intrin.h> // for __rdtsc
+#endif
 
 namespace arcstk
 {
@@ -42,27 +57,60 @@ namespace details
 
 Partitioning get_partitioning(const SampleRange& interval,
 		const SampleRange& legal,
-		const Points&      opoints)
+		const Points&      points)
+{
+	auto partitions = Partitioning {};
+
+	if (points.empty())
+	{
+		fill_partitioning(interval, legal, partitions);
+	} else
+	{
+		fill_partitioning(interval, legal, convert<UNIT::SAMPLES>(points),
+				partitions);
+	}
+
+	return partitions;
+}
+
+
+Partitioning get_partitioning(const SampleRange& interval,
+		const SampleRange& legal)
+{
+	auto partitions = Partitioning {};
+	fill_partitioning(interval, legal, partitions);
+	return partitions;
+}
+
+
+// fill_partitioning
+
+
+void fill_partitioning(const SampleRange& interval,
+		const SampleRange&     legal,
+		const PartitionBounds& points,
+		Partitioning&          partitions)
 {
-	if (opoints.empty())
+	if (points.empty())
 	{
-		return get_partitioning(interval, legal);
+		fill_partitioning(interval, legal, partitions);
+		return;
 	}
 
 	const auto real_lower { std::max(legal.lower(), interval.lower()) };
 	const auto real_upper { std::min(legal.upper(), interval.upper()) };
-	const auto points     { convert<UNIT::SAMPLES>(opoints)  };
 
 	// Both, real_lower and real_upper lie in segments between two of points[].
-	// Identify those segments.
+	// Identify those segments: b and e are the number of points that are
+	// smaller than or equal to the respective bound.
 
-	auto b = std::size_t { 0 };
-	auto e = std::size_t { 0 };
-	for (const auto& p : points)
-	{
-		if (real_lower >= p) { ++b; };
-		if (real_upper >= p) { ++e; } else break;
-	}
+	const auto b { static_cast<std::size_t>(std::distance(points.begin(),
+			std::upper_bound(points.begin(), points.end(), real_lower))) };
+
+	const auto e { static_cast<std::size_t>(std::distance(points.begin(),
+			std::upper_bound(points.begin() + static_cast<
+				PartitionBounds::difference_type>(b),
+				points.end(), real_upper))) };
 
 	// Now, b-1 and e-1 are the indices of the tracks/segments in which the
 	// bounds lie. All segments between these two, i.e. in the interval
@@ -75,20 +123,22 @@ Partitioning get_partitioning(const SampleRange& interval,
 	// partition will be returned and it may be the partition that ends the last
 	// track. In this case, b will be bigger than the index.
 
-	auto partitions = std::vector<Partition>{};
-
 	// front
 
 	auto track { b };
 	{
+		const auto is_last_track  { track >= points.size() };
+
 		const auto start_of_track = track == 0 ? 0 : points[track - 1];
-		const auto end_of_track   = points[track] - 1;
+		const auto end_of_track   = is_last_track
+			? legal.upper()
+			: points[track] - 1;
 
 		// start of the first (and maybe only) partition
 		const auto p0_lower { real_lower };
 
 		// end of the first (and maybe only) partition
-		const auto p0_upper { track < points.size()  // if not last track
+		const auto p0_upper { !is_last_track
 			? std::min(end_of_track, real_upper)
 			: real_upper
 		};
@@ -108,7 +158,7 @@ Partitioning get_partitioning(const SampleRange& interval,
 	} // front
 
 	// If the interval does not span over multiple tracks, we are done now.
-	if (b == e) { return partitions; }
+	if (b == e) { return; }
 
 	// mid (if any)
 
@@ -133,9 +183,11 @@ Partitioning get_partitioning(const SampleRange& interval,
 
 	track = e;
 	{
+		const auto is_last_track { track >= points.size() };
+
 		const auto pN_lower { points[track - 1] };
 
-		const auto pN_upper { track < points.size()
+		const auto pN_upper { !is_last_track
 			? std::min(points[track] - 1, real_upper)
 			: real_upper
 		};
@@ -150,17 +202,17 @@ Partitioning get_partitioning(const SampleRange& interval,
 		// upper bound to the real upper bound.
 		partitions.emplace_back(pN_lower, pN_upper,
 			true,/*a previous partition is guaranteed that ends on track end*/
-			pN_upper == points[track] - 1 || pN_upper == legal.upper(),
+			(!is_last_track && pN_upper == points[track] - 1)
+				|| pN_upper == legal.upper(),
 			static_cast<TrackNo>(track)
 		);
 	} // back
-
-	return partitions;
 }
 
 
-Partitioning get_partitioning(const SampleRange& interval,
-		const SampleRange& legal)
+void fill_partitioning(const SampleRange& interval,
+		const SampleRange& legal,
+		Partitioning&      partitions)
 {
 	// Create a single partition spanning the entire block of samples.
 	// Respect legal range.
@@ -178,13 +230,13 @@ Partitioning get_partitioning(const SampleRange& interval,
 	ARCS_LOG(DEBUG3) << "Create partition from interval: " << partition_start
 		<< " - " << partition_end;
 
-	return { Partition {
-		{ partition_start },
-		{ partition_end   },
-		{ partition_start == legal.lower() }/* starts track ? */,
-		{ partition_end   == legal.upper() }/* ends track ? */,
+	partitions.emplace_back(
+		partition_start,
+		partition_end,
+		partition_start == legal.lower()/* starts track ? */,
+		partition_end   == legal.upper()/* ends track ? */,
 		0/* invalid track */
-	}};
+	);
 }
 
 
@@ -195,19 +247,24 @@ Partitioner::Partitioner(const AudioSize& total_samples, const Points& points,
 		const SampleRange& legal)
 	: total_samples_ { total_samples }
 	, points_        { points        }
+	, bounds_        { convert<UNIT::SAMPLES>(points) }
 	, legal_         { legal         }
+	, partitions_    { /* empty */   }
 {
-	// empty
+	// A block contains at most a partition for each track
+	partitions_.reserve(bounds_.size() + 1);
 }
 
 
 Partitioner::~Partitioner() noexcept = default;
 
 
-Partitioning Partitioner::create_partitioning(
+const Partitioning& Partitioner::create_partitioning(
 		const int32_t offset,
-		const int32_t total_samples_in_block) const
+		const int32_t total_samples_in_block)
 {
+	partitions_.clear();
+
 	const SampleRange current_interval {
 		offset, offset + am2ind(total_samples_in_block)
 	};
@@ -220,10 +277,13 @@ Partitioning Partitioner::create_partitioning(
 	{
 		ARCS_LOG(DEBUG2) <<
 			"No relevant samples in interval, provide no partitions";
-		return Partitioning {};
+		return partitions_;
 	}
 
-	return do_create_partitioning(current_interval, legal_range(), points_);
+	do_create_partitioning(current_interval, legal_range(), bounds_,
+			partitions_);
+
+	return partitions_;
 }
 
 
@@ -245,12 +305,18 @@ SampleRange Partitioner::legal_range() const
 }
 
 
-Points Partitioner::points() const
+const Points& Partitioner::points() const
 {
 	return points_;
 }
 
 
+const PartitionBounds& Partitioner::bounds() const
+{
+	return bounds_;
+}
+
+
 std::unique_ptr<Partitioner> Partitioner::clone() const
 {
 	return do_clone();
@@ -269,12 +335,13 @@ TrackPartitioner::TrackPartitioner(const AudioSize& total_samples,
 }
 
 
-Partitioning TrackPartitioner::do_create_partitioning(
-		const SampleRange& interval,     /* block of samples */
-		const SampleRange& legal,        /* legal range of samples */
-		const Points&      points) const /* track points */
+void TrackPartitioner::do_create_partitioning(
+		const SampleRange&     interval,   /* block of samples */
+		const SampleRange&     legal,      /* legal range of samples */
+		const PartitionBounds& bounds,     /* track points */
+		Partitioning&          partitions) const
 {
-	return get_partitioning(interval, legal, points);
+	fill_partitioning(interval, legal, bounds, partitions);
 }
 
 
@@ -355,6 +422,179 @@ int32_t am2ind(const int32_t amount)
 }
 
 
+int32_t track_index(const Points& points, const int32_t sample)
+{
+	const auto is_after = [](const int32_t s, const AudioSize& point)
+	{
+		return s < point.samples();
+	};
+
+	const auto following { std::upper_bound(points.begin(), points.end(),
+			sample, is_after) };
+
+	if (following == points.begin())
+	{
+		return 0;
+	}
+
+	return static_cast<int32_t>(std::distance(points.begin(), following) - 1);
+}
+
+
+// TimeCounter
+
+
+namespace
+{
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+/**
+ * \brief TRUE iff the CPU has an invariant time stamp counter.
+ *
+ * An invariant time stamp counter runs at a constant rate in all power states
+ * and is synchronized between the cores.
+ *
+ * \return TRUE iff the time stamp counter can be used as a clock
+ */
+bool has_invariant_tsc() noexcept
+{
+	auto eax = 0u, ebx = 0u, ecx = 0u, edx = 0u;
+
+	if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0
+			|| eax < 0x80000007)
+	{
+		return false;
+	}
+
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+
+	return (edx & (1u << 8)) != 0;
+}
+
+
+/**
+ * \brief TRUE iff the ticks are read from the time stamp counter.
+ */
+const bool use_tsc { has_invariant_tsc() };
+
+#else
+
+const bool use_tsc { false };
+
+#endif
+
+
+/**
+ * \brief Nanoseconds of the steady clock.
+ *
+ * \return Current nanoseconds of the steady clock
+ */
+TimeCounter::ticks_type steady_ticks() noexcept
+{
+	return static_cast<TimeCounter::ticks_type>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+/**
+ * \brief Reads the clock ticks and the steady clock at the same time.
+ *
+ * \return Pair of clock ticks and nanoseconds of the steady clock
+ */
+std::pair<TimeCounter::ticks_type, TimeCounter::ticks_type> read_clocks()
+	noexcept
+{
+	const auto ticks { TimeCounter::now() };
+	return { ticks, steady_ticks() };
+}
+
+
+/**
+ * \brief Clock ticks and steady clock when the library was loaded.
+ */
+const auto clocks_at_load { read_clocks() };
+
+
+/**
+ * \brief Duration of a clock tick in seconds.
+ *
+ * For the time stamp counter, the duration is calibrated against the steady
+ * clock over the entire period from loading the library to the call. This
+ * period encloses any time measured so far, hence the calibration does not
+ * need to wait for the clocks to advance.
+ *
+ * \return Duration of a clock tick in seconds
+ */
+double seconds_per_tick() noexcept
+{
+	if (!use_tsc)
+	{
+		return 1.0e-9;
+	}
+
+	const auto clocks_now { read_clocks() };
+
+	const auto ticks  { clocks_now.first  - clocks_at_load.first  };
+	const auto steady { clocks_now.second - clocks_at_load.second };
+
+	if (ticks == 0)
+	{
+		return 1.0e-9;
+	}
+
+	return static_cast<double>(steady) * 1.0e-9 / static_cast<double>(ticks);
+}
+
+} // namespace
+
+
+TimeCounter::ticks_type TimeCounter::now() noexcept
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	if (use_tsc)
+	{
+		return __rdtsc();
+	}
+#endif
+
+	return steady_ticks();
+}
+
+
+TimeCounter::TimeCounter()
+	: ticks_ { 0 }
+	, added_ { 0 }
+{
+	// empty
+}
+
+
+void TimeCounter::add_since(const ticks_type start) noexcept
+{
+	ticks_ += now() - start;
+}
+
+
+void TimeCounter::add(const std::chrono::duration<float>& duration)
+{
+	added_ += duration;
+}
+
+
+std::chrono::duration<float> TimeCounter::elapsed() const noexcept
+{
+	if (ticks_ == 0)
+	{
+		return added_;
+	}
+
+	return added_ + std::chrono::duration<float> {
+		static_cast<float>(static_cast<double>(ticks_) * seconds_per_tick()) };
+}
+
+
 // CalculationState
 
 
@@ -363,8 +603,8 @@ CalculationState::CalculationState(Algorithm* const algorithm)
 	, samples_processed_   { 0 }
 	, track_samples_processed_ { 0 }
 	, tracks_processed_    { 0 }
-	, algo_time_elapsed_   { 0 }
-	, update_time_elapsed_ { 0 }
+	, algo_time_elapsed_   { /* default */ }
+	, update_time_elapsed_ { /* default */ }
 	, algorithm_           { algorithm }
 {
 	// empty
@@ -413,6 +653,12 @@ void CalculationState::do_update(SampleInputIterator start,
 }
 
 
+void CalculationState::do_update(const sample_t* start, const sample_t* stop)
+{
+	algorithm_->update(start, stop);
+}
+
+
 ChecksumSet CalculationState::do_current_subtotal() const
 {
 	return algorithm_->result();
@@ -445,6 +691,12 @@ int32_t CalculationState::samples_processed() const noexcept
 }
 
 
+int32_t CalculationState::tracks_processed() const noexcept
+{
+	return tracks_processed_.value();
+}
+
+
 const Algorithm* CalculationState::algorithm() const noexcept
 {
 	return algorithm_;
@@ -454,38 +706,49 @@ const Algorithm* CalculationState::algorithm() const noexcept
 std::chrono::duration<float> CalculationState::update_time_elapsed() const
 	noexcept
 {
-	return update_time_elapsed_;
+	return update_time_elapsed_.elapsed();
 }
 
 
 void CalculationState::increment_update_time_elapsed(
 			const std::chrono::duration<float>& duration)
 {
-	update_time_elapsed_ += duration;
+	update_time_elapsed_.add(duration);
+}
+
+
+void CalculationState::increment_update_time_elapsed(
+		const TimeCounter::ticks_type start) noexcept
+{
+	update_time_elapsed_.add_since(start);
 }
 
 
 std::chrono::duration<float> CalculationState::algo_time_elapsed() const
 	noexcept
 {
-	return algo_time_elapsed_;
+	return algo_time_elapsed_.elapsed();
 }
 
 
-void CalculationState::update(SampleInputIterator start,
-		SampleInputIterator stop)
+template <typename Iterator>
+void CalculationState::timed_update(Iterator start, Iterator stop)
 {
-	using fsec = std::chrono::duration<float>;
+	const auto amount { stop - start };
 
-	const auto amount { std::distance(start, stop) };
+	const auto settings { algorithm_->settings() };
 
-	const auto start_time { std::chrono::steady_clock::now() };
+	if (settings && measures(settings->timing(), Timing::FINE))
+	{
+		const auto start_time { TimeCounter::now() };
 
-	do_update(start, stop); // TODO try and update counter in catch
+		do_update(start, stop); // TODO try and update counter in catch
 
-	const auto stop_time { std::chrono::steady_clock::now() };
-	const fsec dur       { stop_time - start_time };
-	algo_time_elapsed_ += dur;
+		algo_time_elapsed_.add_since(start_time);
+	} else
+	{
+		do_update(start, stop);
+	}
 
 	samples_processed_.increment(amount);
 	track_samples_processed_.increment(amount);
@@ -493,6 +756,19 @@ void CalculationState::update(SampleInputIterator start,
 }
 
 
+void CalculationState::update(SampleInputIterator start,
+		SampleInputIterator stop)
+{
+	timed_update(start, stop);
+}
+
+
+void CalculationState::update(const sample_t* start, const sample_t* stop)
+{
+	timed_update(start, stop);
+}
+
+
 void CalculationState::track_finished()
 {
 	tracks_processed_.increment(1);
@@ -501,6 +777,36 @@ void CalculationState::track_finished()
 }
 
 
+void CalculationState::skip_tracks(const int32_t tracks)
+{
+	tracks_processed_.increment(tracks);
+}
+
+
+void CalculationState::save(CheckpointWriter& out) const
+{
+	out.write_i32(current_offset_.value());
+	out.write_i32(samples_processed_.value());
+	out.write_i32(track_samples_processed_.value());
+	out.write_i32(tracks_processed_.value());
+}
+
+
+void CalculationState::restore(CheckpointReader& in)
+{
+	const auto restore_counter = [&in](Counter<int32_t>& counter)
+	{
+		counter.reset();
+		counter.increment(in.read_i32());
+	};
+
+	restore_counter(current_offset_);
+	restore_counter(samples_processed_);
+	restore_counter(track_samples_processed_);
+	restore_counter(tracks_processed_);
+}
+
+
 ChecksumSet CalculationState::current_subtotal() const
 {
 	return do_current_subtotal();
@@ -620,13 +926,31 @@ void swap(CalculationStateImpl& lhs, CalculationStateImpl& rhs) noexcept
 // perform_update
 
 
-bool perform_update(SampleInputIterator start, SampleInputIterator stop,
-		const Partitioner& partitioner,
-		CalculationState&  state,
-		Checksums&         result_buffer)
+namespace
+{
+
+/**
+ * \brief Implements perform_update() for any type of sample iterator.
+ *
+ * \tparam Iterator Type of the sample iterator
+ *
+ * \param[in]     start         Iterator pointing to first sample in block
+ * \param[in]     stop          Iterator pointing behind last sample in block
+ * \param[in,out] partitioner   Partition provider
+ * \param[in,out] state         Current calculation state
+ * \param[in,out] result_buffer Buffer for collecting results
+ *
+ * \return FALSE iff more updates are required, otherwise TRUE
+ */
+template <typename Iterator>
+bool perform_update_impl(Iterator start, Iterator stop,
+		Partitioner&         partitioner,
+		CalculationState&    state,
+		Checksums&           result_buffer,
+		const TrackCallback& callback)
 {
 	const auto start_pos        { state.current_offset() };
-	const auto samples_in_block { std::distance(start, stop) };
+	const auto samples_in_block { stop - start };
 	const auto last_pos         { start_pos + am2ind(samples_in_block) };
 
 	ARCS_LOG(DEBUG1) << "Offsets: " << start_pos << " - " << last_pos;
@@ -634,7 +958,7 @@ bool perform_update(SampleInputIterator start, SampleInputIterator stop,
 
 	// Create a partitioning following the track bounds in this block
 
-	const auto partitioning { partitioner.create_partitioning(
+	const auto& partitioning { partitioner.create_partitioning(
 			start_pos, samples_in_block) };
 
 	if (partitioning.empty())
@@ -698,6 +1022,13 @@ bool perform_update(SampleInputIterator start, SampleInputIterator stop,
 
 			state.track_finished();
 			result_buffer.push_back(state.current_subtotal());
+
+			// Notify immediately, hence an exception thrown by the callback
+			// leaves no finished track unnotified
+			if (callback)
+			{
+				callback(state.tracks_processed(), result_buffer.back());
+			}
 		}
 	}
 
@@ -705,6 +1036,30 @@ bool perform_update(SampleInputIterator start, SampleInputIterator stop,
 			partitioner.legal_range().upper()/* last relevant sample */);
 }
 
+} // namespace
+
+
+bool perform_update(SampleInputIterator start, SampleInputIterator stop,
+		Partitioner&         partitioner,
+		CalculationState&    state,
+		Checksums&           result_buffer,
+		const TrackCallback& callback)
+{
+	return perform_update_impl(start, stop, partitioner, state, result_buffer,
+			callback);
+}
+
+
+bool perform_update(const sample_t* start, const sample_t* stop,
+		Partitioner&         partitioner,
+		CalculationState&    state,
+		Checksums&           result_buffer,
+		const TrackCallback& callback)
+{
+	return perform_update_impl(start, stop, partitioner, state, result_buffer,
+			callback);
+}
+
 } // namespace details
 
 
@@ -749,6 +1104,8 @@ bool any(const Context& rhs) noexcept
 
 Settings::Settings()
 	: context_ { Context::ALBUM }
+	, threads_ { 1 }
+	, timing_  { Timing::FINE }
 {
 	// empty
 }
@@ -756,6 +1113,8 @@ Settings::Settings()
 
 Settings::Settings(const Context& c)
 	: context_ { c }
+	, threads_ { 1 }
+	, timing_  { Timing::FINE }
 {
 	// empty
 }
@@ -773,6 +1132,30 @@ Context Settings::context() const
 }
 
 
+void Settings::set_threads(const unsigned threads)
+{
+	threads_ = threads;
+}
+
+
+unsigned Settings::threads() const
+{
+	return threads_;
+}
+
+
+void Settings::set_timing(const Timing timing)
+{
+	timing_ = timing;
+}
+
+
+Timing Settings::timing() const
+{
+	return timing_;
+}
+
+
 // Algorithm
 
 
@@ -810,12 +1193,24 @@ std::pair<int32_t, int32_t> Algorithm::range(const AudioSize& size,
 }
 
 
+void Algorithm::prepare(const AudioSize& size, const Points& points)
+{
+	this->do_prepare(size, points);
+}
+
+
 void Algorithm::update(SampleInputIterator start, SampleInputIterator stop)
 {
 	this->do_update(start, stop);
 }
 
 
+void Algorithm::update(const sample_t* start, const sample_t* stop)
+{
+	this->do_update(start, stop);
+}
+
+
 void Algorithm::track_finished(const int t, const AudioSize& length)
 {
 	this->do_track_finished(t, length);
@@ -840,6 +1235,81 @@ std::unique_ptr<Algorithm> Algorithm::clone() const
 }
 
 
+void Algorithm::save(CheckpointWriter& out) const
+{
+	this->do_save(out);
+}
+
+
+void Algorithm::restore(CheckpointReader& in)
+{
+	this->do_restore(in);
+}
+
+
+void Algorithm::seek(const int t, const int32_t index)
+{
+	this->do_seek(t, index);
+}
+
+
+void Algorithm::reset()
+{
+	this->do_reset();
+}
+
+
+ChecksumSet Algorithm::merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+		const int32_t samples) const
+{
+	return this->do_merge(lhs, rhs, samples);
+}
+
+
+void Algorithm::do_prepare(const AudioSize& /* size */,
+		const Points& /* points */)
+{
+	// empty
+}
+
+
+void Algorithm::do_update(const sample_t* start, const sample_t* stop)
+{
+	this->do_update(SampleInputIterator { start }, SampleInputIterator { stop });
+}
+
+
+void Algorithm::do_seek(const int /* t */, const int32_t /* index */)
+{
+	throw std::logic_error("Algorithm does not support partial calculations");
+}
+
+
+void Algorithm::do_reset()
+{
+	throw std::logic_error("Algorithm does not support reset");
+}
+
+
+ChecksumSet Algorithm::do_merge(const ChecksumSet& /* lhs */,
+		const ChecksumSet& /* rhs */, const int32_t /* samples */) const
+{
+	throw std::logic_error("Algorithm does not support partial calculations");
+}
+
+
+void Algorithm::do_save(CheckpointWriter& /* out */) const
+{
+	throw std::logic_error("Algorithm does not support checkpoints");
+}
+
+
+void Algorithm::do_restore(CheckpointReader& /* in */)
+{
+	throw std::logic_error("Algorithm does not support checkpoints");
+}
+
+
 void Algorithm::base_swap(Algorithm& rhs)
 {
 	using std::swap;
@@ -856,6 +1326,8 @@ Calculation::Impl::Impl(std::unique_ptr<Algorithm> algorithm)
 	, result_buffer_ { init_buffer()                               }
 	, algorithm_     { std::move(algorithm)                        }
 	, state_         { init_state(algorithm_.get())                }
+	, subrange_      { 0, std::numeric_limits<int32_t>::max()      }
+	, track_callback_ { nullptr                                    }
 {
 	// empty
 }
@@ -867,6 +1339,8 @@ Calculation::Impl::Impl(const Impl& rhs)
 	, result_buffer_ { std::make_unique<Checksums>(*rhs.result_buffer_) }
 	, algorithm_     { rhs.algorithm_->clone()                          }
 	, state_         { rhs.state_->clone_to(algorithm_.get())           }
+	, subrange_      { rhs.subrange_                                    }
+	, track_callback_ { rhs.track_callback_                             }
 {
 	// empty
 }
@@ -881,6 +1355,8 @@ Calculation::Impl& Calculation::Impl::operator=(const Impl& rhs)
 	result_buffer_ = std::make_unique<Checksums>(*rhs.result_buffer_);
 	algorithm_     = rhs.algorithm_->clone();
 	state_         = rhs.state_->clone_to(algorithm_.get());
+	subrange_      = rhs.subrange_;
+	track_callback_ = rhs.track_callback_;
 	return *this;
 }
 
@@ -891,6 +1367,8 @@ Calculation::Impl::Impl(Impl&& rhs) noexcept
 	, result_buffer_ { std::move(rhs.result_buffer_) }
 	, algorithm_     { std::move(rhs.algorithm_)     }
 	, state_         { std::move(rhs.state_)         } // FIXME pointer to algo
+	, subrange_      { rhs.subrange_                 }
+	, track_callback_ { std::move(rhs.track_callback_) }
 {
 	// empty
 }
@@ -905,6 +1383,8 @@ Calculation::Impl& Calculation::Impl::operator=(Impl&& rhs) noexcept
 	result_buffer_ = std::move(rhs.result_buffer_);
 	algorithm_     = std::move(rhs.algorithm_);
 	state_         = std::move(rhs.state_); // FIXME pointer to algo
+	subrange_      = rhs.subrange_;
+	track_callback_ = std::move(rhs.track_callback_);
 	return *this;
 }
 
@@ -926,7 +1406,7 @@ void Calculation::Impl::init(const Settings& s, const AudioSize& size,
 
 	this->set_settings(s); // also sets up Algorithm
 
-	const auto interval { SampleRange { algorithm_->range(size, points) }};
+	const auto interval { this->prepare(*algorithm_, size, points) };
 
 	ARCS_LOG(DEBUG1) << "Calculation interval is " << interval.to_string();
 
@@ -934,6 +1414,68 @@ void Calculation::Impl::init(const Settings& s, const AudioSize& size,
 }
 
 
+void Calculation::Impl::init(const Settings& s, const AudioSize& size,
+		const Points& points, const int32_t first, const int32_t last)
+{
+	if (size.zero())
+	{
+		throw std::invalid_argument(
+				"Partial calculation requires the total number of samples");
+	}
+
+	if (first < 0 || last < first || last >= size.samples())
+	{
+		throw std::invalid_argument("Illegal sub-range of samples: "
+				+ std::to_string(first) + " - " + std::to_string(last));
+	}
+
+	subrange_ = { first, last };
+
+	this->init(s, size, points);
+
+	const auto full  { algorithm_->range(size, points) };
+	const auto begin { std::max(full.first, first) };
+
+	if (begin > std::min(full.second, last))
+	{
+		throw std::invalid_argument("Sub-range of samples " + std::to_string(first)
+				+ " - " + std::to_string(last) + " contains no samples to "
+				"calculate");
+	}
+
+	// The first sample passed to update() is the first sample of the sub-range
+	state_->advance(first);
+
+	const auto track { details::track_index(points, begin) };
+	state_->skip_tracks(track);
+
+	if (begin > full.first)
+	{
+		const auto track_start { points.empty()
+			? 0 : points[static_cast<std::size_t>(track)].samples() };
+
+		algorithm_->seek(track + 1, begin - track_start);
+	}
+
+	ARCS_LOG(DEBUG1) << "Partial calculation starts in track " << track + 1;
+}
+
+
+details::SampleRange Calculation::Impl::prepare(Algorithm& algorithm,
+		const AudioSize& size, const Points& points) const
+{
+	const auto bounded { size.zero()
+		? AudioSize { CDDA::MAX_BLOCK_ADDRESS, UNIT::FRAMES } : size };
+
+	algorithm.prepare(bounded, points);
+
+	const auto range { algorithm.range(bounded, points) };
+
+	return { std::max(range.first,  subrange_.first),
+			 std::min(range.second, subrange_.second) };
+}
+
+
 std::unique_ptr<details::CalculationStateImpl> Calculation::Impl::init_state(
 		Algorithm* const algorithm)
 {
@@ -965,6 +1507,13 @@ void Calculation::Impl::set_algorithm(std::unique_ptr<Algorithm> a) noexcept
 	algorithm_     = std::move(a);
 	state_         = init_state(algorithm_.get());
 	result_buffer_ = init_buffer();
+
+	if (partitioner_)
+	{
+		algorithm_->set_settings(&settings());
+		this->prepare(*algorithm_, partitioner_->total_samples(),
+				partitioner_->points());
+	}
 }
 
 
@@ -1007,24 +1556,26 @@ bool Calculation::Impl::complete() const noexcept
 }
 
 
-void Calculation::Impl::update(SampleInputIterator start,
-		SampleInputIterator stop)
+template <typename Iterator>
+void Calculation::Impl::update_block(Iterator start, Iterator stop)
 {
-	using fsec = std::chrono::duration<float>;
-	using ms   = std::chrono::milliseconds;
+	using details::TimeCounter;
+	using details::measures;
+	using ms = std::chrono::milliseconds;
 
 	ARCS_LOG(DEBUG1) << "PROCESS BLOCK: START";
 
-	const auto start_time { std::chrono::steady_clock::now() };
+	const auto timed { measures(settings_.timing(), Timing::COARSE) };
 
-	const auto finished = bool {
-		perform_update(start, stop, *partitioner_, *state_, *result_buffer_) };
+	const auto start_time { timed ? TimeCounter::now() : 0 };
 
-	const auto stop_time  { std::chrono::steady_clock::now() };
-	const fsec dur { stop_time - start_time }; // intentionally not auto
-	// Type of the subtraction is high_resolution_clock::duration which is
-	// not necessarily the same type as duration<float>.
-	state_->increment_update_time_elapsed(dur);
+	const auto finished = bool { perform_update(start, stop, *partitioner_,
+			*state_, *result_buffer_, track_callback_) };
+
+	if (timed)
+	{
+		state_->increment_update_time_elapsed(start_time);
+	}
 
 	if (finished)
 	{
@@ -1052,9 +1603,32 @@ void Calculation::Impl::update(SampleInputIterator start,
 }
 
 
+void Calculation::Impl::update(SampleInputIterator start,
+		SampleInputIterator stop)
+{
+	update_block(start, stop);
+}
+
+
+void Calculation::Impl::update(const sample_t* start, const sample_t* stop)
+{
+	update_block(start, stop);
+}
+
+
 void Calculation::Impl::update(const AudioSize& audiosize)
 {
-	partitioner_->set_total_samples(audiosize);
+	using details::SampleRange;
+	using details::TrackPartitioner;
+
+	// The legal range depends on the total number of samples. The partitioner
+	// does not keep any state of the stream, hence it can be replaced at any
+	// time.
+	const auto& points   { partitioner_->points() };
+	const auto  interval { this->prepare(*algorithm_, audiosize, points) };
+
+	partitioner_ = std::make_unique<TrackPartitioner>(audiosize, points,
+			interval);
 }
 
 
@@ -1064,6 +1638,181 @@ Checksums Calculation::Impl::result() const noexcept
 }
 
 
+Checksums Calculation::Impl::take_result() noexcept
+{
+	auto result { std::move(*result_buffer_) };
+	result_buffer_->clear(); // moved-from state is unspecified
+	return result;
+}
+
+
+void Calculation::Impl::set_track_callback(TrackCallback callback)
+{
+	track_callback_ = std::move(callback);
+}
+
+
+std::pair<int32_t, int32_t> Calculation::Impl::subrange() const noexcept
+{
+	return subrange_;
+}
+
+
+const details::Partitioner& Calculation::Impl::partitioner() const noexcept
+{
+	return *partitioner_;
+}
+
+
+int32_t Calculation::Impl::current_offset() const noexcept
+{
+	return state_->current_offset();
+}
+
+
+std::vector<uint8_t> Calculation::Impl::checkpoint() const
+{
+	auto out { CheckpointWriter {} };
+
+	out.write_u32(details::CHECKPOINT_MAGIC);
+	out.write_u32(CHECKPOINT_VERSION);
+	out.write_u32(static_cast<uint32_t>(settings_.context()));
+
+	out.write_u32(algorithm_->types().mask());
+
+	out.write_i32(partitioner_->total_samples().samples());
+
+	const auto& points { partitioner_->points() };
+	out.write_u32(static_cast<uint32_t>(points.size()));
+	for (const auto& point : points)
+	{
+		out.write_i32(point.samples());
+	}
+
+	out.write_i32(subrange_.first);
+	out.write_i32(subrange_.second);
+
+	state_->save(out);
+
+	out.write_u32(static_cast<uint32_t>(result_buffer_->size()));
+	for (const auto& checksums : *result_buffer_)
+	{
+		out.write(checksums);
+	}
+
+	algorithm_->save(out);
+
+	return out.release();
+}
+
+
+void Calculation::Impl::restore(const std::vector<uint8_t>& checkpoint)
+{
+	auto in { CheckpointReader { checkpoint.data(), checkpoint.size() } };
+
+	if (in.read_u32() != details::CHECKPOINT_MAGIC)
+	{
+		throw std::invalid_argument("Not a checkpoint");
+	}
+
+	const auto version { in.read_u32() };
+	if (version != CHECKPOINT_VERSION)
+	{
+		throw std::invalid_argument("Unsupported checkpoint version "
+				+ std::to_string(version));
+	}
+
+	if (in.read_u32() != static_cast<uint32_t>(settings_.context()))
+	{
+		throw std::invalid_argument("Checkpoint has another context");
+	}
+
+	if (in.read_u32() != algorithm_->types().mask())
+	{
+		throw std::invalid_argument("Checkpoint has other checksum types");
+	}
+
+	const auto total_samples { in.read_i32() };
+
+	const auto& points { partitioner_->points() };
+	if (in.read_u32() != points.size())
+	{
+		throw std::invalid_argument("Checkpoint has another number of tracks");
+	}
+	for (const auto& point : points)
+	{
+		if (in.read_i32() != point.samples())
+		{
+			throw std::invalid_argument("Checkpoint has other track offsets");
+		}
+	}
+
+	const auto first { in.read_i32() };
+	const auto last  { in.read_i32() };
+	if (first != subrange_.first || last != subrange_.second)
+	{
+		throw std::invalid_argument("Checkpoint has another sub-range of "
+				"samples: " + std::to_string(first) + " - "
+				+ std::to_string(last));
+	}
+
+	// Restore into copies to leave this instance unmodified on error
+
+	auto partitioner { std::unique_ptr<details::Partitioner> {} };
+	auto algorithm   { algorithm_->clone() };
+
+	if (total_samples != partitioner_->total_samples().samples())
+	{
+		const auto size { AudioSize { total_samples, UNIT::SAMPLES } };
+
+		partitioner = std::make_unique<details::TrackPartitioner>(size, points,
+				this->prepare(*algorithm, size, points));
+	}
+
+	auto state { state_->clone_to(algorithm.get()) };
+	state->restore(in);
+
+	auto result_buffer { init_buffer() };
+	const auto tracks { in.read_u32() };
+	if (tracks > points.size())
+	{
+		throw std::invalid_argument("Checkpoint has too many tracks");
+	}
+	for (auto t = uint32_t { 0 }; t < tracks; ++t)
+	{
+		result_buffer->push_back(in.read_checksums());
+	}
+
+	algorithm->restore(in);
+
+	if (in.remaining() > 0)
+	{
+		throw std::invalid_argument("Checkpoint has trailing data");
+	}
+
+	if (partitioner)
+	{
+		partitioner_ = std::move(partitioner);
+	}
+
+	algorithm_     = std::move(algorithm);
+	state_         = std::move(state);
+	result_buffer_ = std::move(result_buffer);
+}
+
+
+void Calculation::Impl::reset(const AudioSize& size, const Points& points)
+{
+	algorithm_->reset();
+
+	subrange_ = { 0, std::numeric_limits<int32_t>::max() };
+	state_    = init_state(algorithm_.get());
+	result_buffer_->clear();
+
+	this->init(settings_, size, points);
+}
+
+
 // Calculation
 
 
@@ -1076,6 +1825,15 @@ Calculation::Calculation(const Settings& settings,
 }
 
 
+Calculation::Calculation(const Settings& settings,
+		std::unique_ptr<Algorithm> algorithm, const AudioSize& size,
+		const Points& points, const int32_t first, const int32_t last)
+	:impl_ { std::make_unique<Impl>(std::move(algorithm)) }
+{
+	impl_->init(settings, size, points, first, last);
+}
+
+
 Calculation::Calculation(const Calculation& rhs)
 	:impl_ { std::make_unique<Calculation::Impl>(*rhs.impl_) }
 {
@@ -1155,6 +1913,18 @@ int32_t Calculation::samples_todo() const noexcept
 }
 
 
+int32_t Calculation::current_offset() const noexcept
+{
+	return impl_->current_offset();
+}
+
+
+std::pair<int32_t, int32_t> Calculation::subrange() const noexcept
+{
+	return impl_->subrange();
+}
+
+
 std::chrono::duration<float> Calculation::update_time_elapsed() const
 	noexcept
 {
@@ -1180,6 +1950,12 @@ void Calculation::update(SampleInputIterator start, SampleInputIterator stop)
 }
 
 
+void Calculation::update(const sample_t* start, const sample_t* stop)
+{
+	impl_->update(start, stop);
+}
+
+
 void Calculation::update(const AudioSize& audiosize)
 {
 	impl_->update(audiosize);
@@ -1192,6 +1968,36 @@ Checksums Calculation::result() const noexcept
 }
 
 
+Checksums Calculation::take_result() noexcept
+{
+	return impl_->take_result();
+}
+
+
+void Calculation::set_track_callback(TrackCallback callback)
+{
+	impl_->set_track_callback(std::move(callback));
+}
+
+
+std::vector<uint8_t> Calculation::checkpoint() const
+{
+	return impl_->checkpoint();
+}
+
+
+void Calculation::restore(const std::vector<uint8_t>& checkpoint)
+{
+	impl_->restore(checkpoint);
+}
+
+
+void Calculation::reset(const AudioSize& size, const Points& points)
+{
+	impl_->reset(size, points);
+}
+
+
 void Calculation::swap(Calculation& rhs) noexcept
 {
 	using std::swap;
@@ -1217,6 +2023,125 @@ std::unique_ptr<Calculation> make_calculation(
 }
 
 
+std::unique_ptr<Calculation> make_calculation(
+		std::unique_ptr<Algorithm> algorithm, const ToC& toc,
+		const int32_t first, const int32_t last)
+{
+	if (!toc.complete())
+	{
+		throw std::invalid_argument(
+				"Partial calculation requires a complete ToC");
+	}
+
+	return std::make_unique<Calculation>(Context::ALBUM, std::move(algorithm),
+		toc.leadout(), toc.offsets(), first, last);
+}
+
+
+Checksums merge(const std::vector<const Calculation*>& partials)
+{
+	if (partials.empty())
+	{
+		throw std::invalid_argument("No partial calculations to merge");
+	}
+
+	auto sorted { partials };
+	std::sort(sorted.begin(), sorted.end(),
+		[](const Calculation* lhs, const Calculation* rhs)
+		{
+			return lhs->subrange().first < rhs->subrange().first;
+		});
+
+	const auto& reference   { sorted.front()->impl_->partitioner() };
+	const auto& points      { reference.points() };
+	const auto  size        { reference.total_samples() };
+	const auto  algorithm   { sorted.front()->algorithm() };
+	const auto  types       { algorithm->types() };
+	const auto  full        { algorithm->range(size, points) };
+
+	auto merged { Checksums {} };
+	auto next   { full.first }; // next sample to be covered
+
+	for (const auto& partial : sorted)
+	{
+		const auto& partitioner { partial->impl_->partitioner() };
+
+		if (partial->types() != types
+				|| partitioner.total_samples().samples() != size.samples()
+				|| partitioner.points() != points)
+		{
+			throw std::invalid_argument(
+					"Partial calculations of different inputs cannot be merged");
+		}
+
+		if (!partial->complete())
+		{
+			throw std::invalid_argument("Partial calculation is not complete");
+		}
+
+		const auto& legal { partitioner.legal_range() };
+
+		if (legal.lower() != next)
+		{
+			throw std::invalid_argument("Partial calculations are not adjacent,"
+					" expected sample " + std::to_string(next) + " but got "
+					+ std::to_string(legal.lower()));
+		}
+
+		next = legal.upper() + 1;
+
+		auto track { static_cast<std::size_t>(
+				details::track_index(points, legal.lower())) };
+
+		for (const auto& checksums : partial->result())
+		{
+			if (track < merged.size())
+			{
+				// Number of samples of the track within the legal range
+
+				const auto start { points.empty()
+					? legal.lower()
+					: std::max(legal.lower(), points[track].samples()) };
+				const auto end { track + 1 < points.size()
+					? std::min(legal.upper() + 1, points[track + 1].samples())
+					: legal.upper() + 1 };
+
+				merged[track] = algorithm->merge(merged[track], checksums,
+						end - start);
+			} else
+			{
+				merged.push_back(checksums);
+			}
+
+			++track;
+		}
+	}
+
+	if (next <= full.second)
+	{
+		throw std::invalid_argument("Partial calculations do not cover all "
+				"samples, missing samples from " + std::to_string(next));
+	}
+
+	// The lengths of the tracks are the number of samples in the legal range
+
+	const auto stop { next }; // behind the last sample of the legal range
+
+	for (auto t = std::size_t { 0 }; t < merged.size(); ++t)
+	{
+		const auto start { t == 0 ? full.first
+			: std::max(full.first, points[t].samples()) };
+		const auto end { t + 1 < points.size()
+			? std::min(stop, points[t + 1].samples())
+			: stop };
+
+		merged[t].set_length((end - start) / CDDA::SAMPLES_PER_FRAME);
+	}
+
+	return merged;
+}
+
+
 } // namespace v_1_0_0
 } // namespace arcstk
 
@@ -149,6 +149,14 @@ class Partition;
 using Partitioning = std::vector<Partition>;
 
 
+/**
+ * \internal
+ * \brief Type of the ascending sequence of absolute sample indices on which
+ * partitions start.
+ */
+using PartitionBounds = std::vector<int32_t>;
+
+
 /**
  * \brief Create a partitioning for an interval in a legal range by a sequence
  * of points.
@@ -172,6 +180,37 @@ Partitioning get_partitioning(
 		const SampleRange& interval,
 		const SampleRange& legal);
 
+/**
+ * \brief Fill a partitioning for an interval in a legal range by a sequence
+ * of bounds.
+ *
+ * The segments that contain the interval bounds are determined by binary
+ * search. The partitions are appended to \c partitions, hence no allocation
+ * occurrs if its capacity suffices.
+ *
+ * \param[in]     interval   Interval to create a partitioning for
+ * \param[in]     legal      Relevant range within the interval
+ * \param[in]     bounds     Ascending sample indices of the partition bounds
+ * \param[in,out] partitions Partitioning to append the partitions to
+ */
+void fill_partitioning(
+		const SampleRange&     interval,
+		const SampleRange&     legal,
+		const PartitionBounds& bounds,
+		Partitioning&          partitions);
+
+/**
+ * \brief Fill a single partition for an interval in a legal range.
+ *
+ * \param[in]     interval   Interval to create a partitioning for
+ * \param[in]     legal      Relevant range within the interval
+ * \param[in,out] partitions Partitioning to append the partition to
+ */
+void fill_partitioning(
+		const SampleRange& interval,
+		const SampleRange& legal,
+		Partitioning&      partitions);
+
 
 /**
  * \internal
@@ -183,6 +222,11 @@ Partitioning get_partitioning(
  * that every two partitions adjacent within the same sequence belong to
  * different tracks. This way it is possible to entirely avoid checking for
  * track bounds within the checksum calculation loop.
+ *
+ * The bounds are converted to samples once on construction. The partitions
+ * are created in an internal buffer that has the capacity for the maximal
+ * number of partitions and is reused for every block. Hence, creating a
+ * partitioning does not allocate.
  */
 class Partitioner
 {
@@ -206,14 +250,16 @@ public:
 	/**
 	 * \brief Generates partitioning of the range of samples.
 	 *
+	 * The partitioning returned is valid until the next call.
+	 *
 	 * \param[in] offset                 Offset of the first sample
 	 * \param[in] total_samples_in_block Number of samples in the block
 	 *
 	 * \return Partitioning of \c samples as a sequence of partitions.
 	 */
-	Partitioning create_partitioning(
+	const Partitioning& create_partitioning(
 			const int32_t offset,
-			const int32_t total_samples_in_block) const;
+			const int32_t total_samples_in_block);
 
 	/**
 	 * \brief Total number of samples.
@@ -246,7 +292,14 @@ public:
 	 *
 	 * \return Points to separate partitions.
 	 */
-	Points points() const;
+	const Points& points() const;
+
+	/**
+	 * \brief Partitioning bounds as sample indices.
+	 *
+	 * \return Ascending sample indices of the points
+	 */
+	const PartitionBounds& bounds() const;
 
 	/**
 	 * \brief Deep copy of this instance.
@@ -260,16 +313,16 @@ private:
 	/**
 	 * \brief Implements Partitioner::create_partitioning() with a ToC.
 	 *
-	 * \param[in] current_interval Interval to build partitions from
-	 * \param[in] legal_range      Legal interval to process
-	 * \param[in] points           Splitting points
-	 *
-	 * \return Partitioning of \c samples as a sequence of partitions.
-	 */
-	virtual Partitioning do_create_partitioning(
-		const SampleRange& current_interval,
-		const SampleRange& legal_range,
-		const Points& points) const
+	 * \param[in]     current_interval Interval to build partitions from
+	 * \param[in]     legal_range      Legal interval to process
+	 * \param[in]     bounds           Splitting points as sample indices
+	 * \param[in,out] partitions       Empty partitioning to fill
+	 */
+	virtual void do_create_partitioning(
+		const SampleRange&     current_interval,
+		const SampleRange&     legal_range,
+		const PartitionBounds& bounds,
+		Partitioning&          partitions) const
 	= 0;
 
 	virtual std::unique_ptr<Partitioner> do_clone() const
@@ -285,10 +338,20 @@ private:
 	 */
 	Points points_;
 
+	/**
+	 * \brief Internal splitting points as sample indices.
+	 */
+	PartitionBounds bounds_;
+
 	/**
 	 * \brief Legal range of partitioning.
 	 */
 	SampleRange legal_;
+
+	/**
+	 * \brief Reused buffer for the partitions of the current block.
+	 */
+	Partitioning partitions_;
 };
 
 
@@ -297,10 +360,11 @@ private:
  */
 class TrackPartitioner final : public Partitioner
 {
-	virtual Partitioning do_create_partitioning(
-		const SampleRange& sample_block,
-		const SampleRange& relevant_interval,
-		const Points& points) const final;
+	virtual void do_create_partitioning(
+		const SampleRange&     sample_block,
+		const SampleRange&     relevant_interval,
+		const PartitionBounds& bounds,
+		Partitioning&          partitions) const final;
 
 	virtual std::unique_ptr<Partitioner> do_clone() const final;
 
@@ -21,8 +21,9 @@
 #endif
 
 #include <chrono>        // for duration
-#include <cstdint>       // for int32_t
+#include <cstdint>       // for int32_t, uint64_t
 #include <memory>        // for unique_ptr
+#include <utility>       // for pair
 #include <vector>        // for vector
 
 namespace arcstk
@@ -57,6 +58,115 @@ int32_t ind2am(const int32_t index);
  */
 int32_t am2ind(const int32_t amount);
 
+/**
+ * \brief 0-based index of the track a sample belongs to.
+ *
+ * Samples before the first track are considered part of the first track.
+ *
+ * \param[in] points Track offsets (as samples)
+ * \param[in] sample 0-based index of the sample
+ *
+ * \return 0-based index of the track
+ */
+int32_t track_index(const Points& points, const int32_t sample);
+
+/**
+ * \brief Magic number at the start of a checkpoint.
+ *
+ * Reads "ACKP" in little endian byte order.
+ */
+constexpr uint32_t CHECKPOINT_MAGIC { 0x504B4341 };
+
+/**
+ * \brief TRUE iff time is to be measured on level \c required.
+ *
+ * Always FALSE if the library is compiled with \c LIBARCSTK_NO_TIMING.
+ *
+ * \param[in] level    Level of time measurement that is set
+ * \param[in] required Level that is required for the measurement
+ *
+ * \return TRUE iff \c level includes \c required
+ */
+constexpr bool measures(const Timing level, const Timing required) noexcept
+{
+#ifdef LIBARCSTK_NO_TIMING
+	return static_cast<void>(level), static_cast<void>(required), false;
+#else
+	return static_cast<unsigned>(level) >= static_cast<unsigned>(required);
+#endif
+}
+
+
+/**
+ * \brief Accumulates elapsed time measured in clock ticks.
+ *
+ * On x86 CPUs with an invariant time stamp counter, the ticks are read from
+ * the time stamp counter which is considerably cheaper than reading a system
+ * clock. Otherwise, the ticks are the nanoseconds of the steady clock. Ticks
+ * are converted to time only on request.
+ */
+class TimeCounter final
+{
+public:
+
+	/**
+	 * \brief Type of a clock tick.
+	 */
+	using ticks_type = uint64_t;
+
+	/**
+	 * \brief Current clock tick.
+	 *
+	 * \return Current clock tick
+	 */
+	static ticks_type now() noexcept;
+
+	/**
+	 * \brief Default constructor.
+	 */
+	TimeCounter();
+
+	/**
+	 * \brief Add the time elapsed since \c start.
+	 *
+	 * \param[in] start Clock tick obtained by now()
+	 */
+	void add_since(const ticks_type start) noexcept;
+
+	/**
+	 * \brief Add a duration.
+	 *
+	 * \param[in] duration Duration to add
+	 */
+	void add(const std::chrono::duration<float>& duration);
+
+	/**
+	 * \brief Total time accumulated.
+	 *
+	 * \return Total time accumulated
+	 */
+	std::chrono::duration<float> elapsed() const noexcept;
+
+	friend void swap(TimeCounter& lhs, TimeCounter& rhs) noexcept
+	{
+		using std::swap;
+		swap(lhs.ticks_, rhs.ticks_);
+		swap(lhs.added_, rhs.added_);
+	}
+
+private:
+
+	/**
+	 * \brief Accumulated clock ticks.
+	 */
+	ticks_type ticks_;
+
+	/**
+	 * \brief Accumulated durations added explicitly.
+	 */
+	std::chrono::duration<float> added_;
+};
+
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Weffc++"
@@ -92,12 +202,12 @@ class CalculationState
 	/**
 	 * \brief Internal time elapsed by processing.
 	 */
-	std::chrono::duration<float> algo_time_elapsed_;
+	TimeCounter algo_time_elapsed_;
 
 	/**
 	 * \brief Internal time elapsed by updating.
 	 */
-	std::chrono::duration<float> update_time_elapsed_;
+	TimeCounter update_time_elapsed_;
 
 	/**
 	 * \brief Internal Algorithm to caculate updates.
@@ -109,6 +219,8 @@ class CalculationState
 
 	virtual void do_update(SampleInputIterator start, SampleInputIterator stop);
 
+	virtual void do_update(const sample_t* start, const sample_t* stop);
+
 	virtual ChecksumSet do_current_subtotal() const;
 
 	virtual void do_track_finished();
@@ -119,6 +231,17 @@ class CalculationState
 	virtual std::unique_ptr<CalculationState> do_clone_to(Algorithm* a) const
 	= 0;
 
+	/**
+	 * \brief Worker for the update() overloads.
+	 *
+	 * \tparam Iterator Type of the sample iterator
+	 *
+	 * \param[in] start First sample of update
+	 * \param[in] stop  Sample behind last sample of update
+	 */
+	template <typename Iterator>
+	void timed_update(Iterator start, Iterator stop);
+
 public:
 
 	/**
@@ -165,6 +288,15 @@ public:
 	 */
 	int32_t samples_processed() const noexcept;
 
+	/**
+	 * \brief Returns the number of tracks yet processed.
+	 *
+	 * Tracks skipped by skip_tracks() are included.
+	 *
+	 * \return Number of tracks processed.
+	 */
+	int32_t tracks_processed() const noexcept;
+
 	/**
 	 * \brief Returns the algorithm instance used by the state.
 	 *
@@ -187,6 +319,15 @@ public:
 	void increment_update_time_elapsed(
 			const std::chrono::duration<float>& duration);
 
+	/**
+	 * \brief Increment the duration for updating by the time elapsed since
+	 * \c start.
+	 *
+	 * \param[in] start Clock tick obtained by TimeCounter::now()
+	 */
+	void increment_update_time_elapsed(const TimeCounter::ticks_type start)
+		noexcept;
+
 	/**
 	 * \brief Amount of milliseconds elapsed so far by Algorithm::update().
 	 *
@@ -202,6 +343,14 @@ public:
 	 */
 	void update(SampleInputIterator start, SampleInputIterator stop);
 
+	/**
+	 * \brief Update the calculation state with a contiguous buffer of samples.
+	 *
+	 * \param[in] start First sample of update
+	 * \param[in] stop  Sample behind last sample of update
+	 */
+	void update(const sample_t* start, const sample_t* stop);
+
 	/**
 	 * \brief Current subtotal as provided by the Algorithm.
 	 *
@@ -214,6 +363,27 @@ public:
 	 */
 	void track_finished();
 
+	/**
+	 * \brief Count tracks as processed without processing them.
+	 *
+	 * \param[in] tracks Number of tracks to skip
+	 */
+	void skip_tracks(const int32_t tracks);
+
+	/**
+	 * \brief Write the counters of this instance to a checkpoint.
+	 *
+	 * \param[in,out] out Writer to write the counters to
+	 */
+	void save(CheckpointWriter& out) const;
+
+	/**
+	 * \brief Restore the counters of this instance from a checkpoint.
+	 *
+	 * \param[in,out] in Reader to read the counters from
+	 */
+	void restore(CheckpointReader& in);
+
 	/**
 	 * \brief Clone this instance.
 	 *
@@ -322,16 +492,36 @@ public:
  *
  * \param[in]     start         Iterator pointing to first sample in block
  * \param[in]     stop          Iterator pointing behind last sample in block
- * \param[in]     partitioner   Partition provider
+ * \param[in,out] partitioner   Partition provider
  * \param[in,out] state         Current calculation state
  * \param[in,out] result_buffer Buffer for collecting results
+ * \param[in]     callback      Callback to call for each finished track
  *
  * \return FALSE iff more updates are required, otherwise TRUE
  */
 bool perform_update(SampleInputIterator start, SampleInputIterator stop,
-		const Partitioner& partitioner,
-		CalculationState&  state,
-		Checksums&         result_buffer);
+		Partitioner&         partitioner,
+		CalculationState&    state,
+		Checksums&           result_buffer,
+		const TrackCallback& callback = nullptr);
+
+/**
+ * \brief Updates a calculation process by a contiguous sample block.
+ *
+ * \param[in]     start         Pointer to first sample in block
+ * \param[in]     stop          Pointer behind last sample in block
+ * \param[in,out] partitioner   Partition provider
+ * \param[in,out] state         Current calculation state
+ * \param[in,out] result_buffer Buffer for collecting results
+ * \param[in]     callback      Callback to call for each finished track
+ *
+ * \return FALSE iff more updates are required, otherwise TRUE
+ */
+bool perform_update(const sample_t* start, const sample_t* stop,
+		Partitioner&         partitioner,
+		CalculationState&    state,
+		Checksums&           result_buffer,
+		const TrackCallback& callback = nullptr);
 
 } // namespace details
 
@@ -347,6 +537,44 @@ class Calculation::Impl final
 	std::unique_ptr<Algorithm>                  algorithm_;
 	std::unique_ptr<details::CalculationState>  state_;
 
+	/**
+	 * \brief First and last sample of the input this instance calculates.
+	 */
+	std::pair<int32_t, int32_t>                 subrange_;
+
+	/**
+	 * \brief Callback to notify about finished tracks.
+	 */
+	TrackCallback                               track_callback_;
+
+	/**
+	 * \brief Prepare an Algorithm for the input and determine its legal range
+	 * restricted to the sub-range.
+	 *
+	 * While the size of the input is unknown, the Algorithm is prepared for
+	 * the maximal size of a CDDA disc. Thus no samples are skipped before
+	 * update(const AudioSize&) declares the actual size.
+	 *
+	 * \param[in] algorithm Algorithm to prepare
+	 * \param[in] size      Total size of the input, may be zero
+	 * \param[in] points    Track offsets (as sample indices)
+	 *
+	 * \return Legal range within the sub-range
+	 */
+	details::SampleRange prepare(Algorithm& algorithm, const AudioSize& size,
+			const Points& points) const;
+
+	/**
+	 * \brief Worker for the update() overloads.
+	 *
+	 * \tparam Iterator Type of the sample iterator
+	 *
+	 * \param[in] start Iterator pointing to the first sample of the block
+	 * \param[in] stop  Iterator pointing behind the last sample of the block
+	 */
+	template <typename Iterator>
+	void update_block(Iterator start, Iterator stop);
+
 public:
 
 	/**
@@ -386,6 +614,18 @@ public:
 	 */
 	void init(const Settings& s, const AudioSize& size, const Points& points);
 
+	/**
+	 * \brief Initialize the instance for a sub-range of the input.
+	 *
+	 * \param[in] s      Settings for this instance
+	 * \param[in] size   Total size of the expected input
+	 * \param[in] points Track offsets (as sample indices)
+	 * \param[in] first  First sample of the sub-range
+	 * \param[in] last   Last sample of the sub-range
+	 */
+	void init(const Settings& s, const AudioSize& size, const Points& points,
+			const int32_t first, const int32_t last);
+
 	/**
 	 * \brief Initializing worker to create the internal state.
 	 *
@@ -426,9 +666,27 @@ public:
 
 	void update(SampleInputIterator begin, SampleInputIterator end);
 
+	void update(const sample_t* begin, const sample_t* end);
+
 	void update(const AudioSize& audiosize);
 
 	Checksums result() const noexcept;
+
+	Checksums take_result() noexcept;
+
+	void set_track_callback(TrackCallback callback);
+
+	int32_t current_offset() const noexcept;
+
+	std::vector<uint8_t> checkpoint() const;
+
+	void restore(const std::vector<uint8_t>& checkpoint);
+
+	void reset(const AudioSize& size, const Points& points);
+
+	std::pair<int32_t, int32_t> subrange() const noexcept;
+
+	const details::Partitioner& partitioner() const noexcept;
 };
 
 } // namespace v_1_0_0
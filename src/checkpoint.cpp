@@ -0,0 +1,166 @@
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation of reading and writing checkpoints.
+ */
+
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#include "checkpoint.hpp"
+#endif
+
+#include <algorithm>        // for find
+#include <stdexcept>        // for invalid_argument
+#include <string>           // for to_string
+#include <utility>          // for move
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+
+// CheckpointWriter
+
+
+CheckpointWriter::CheckpointWriter()
+	: data_ {}
+{
+	// empty
+}
+
+
+void CheckpointWriter::write_u32(const uint32_t value)
+{
+	for (auto shift = 0; shift < 32; shift += 8)
+	{
+		data_.push_back(static_cast<uint8_t>((value >> shift) & 0xFF));
+	}
+}
+
+
+void CheckpointWriter::write_u64(const uint64_t value)
+{
+	this->write_u32(static_cast<uint32_t>(value & 0xFFFFFFFF));
+	this->write_u32(static_cast<uint32_t>(value >> 32));
+}
+
+
+void CheckpointWriter::write_i32(const int32_t value)
+{
+	this->write_u32(static_cast<uint32_t>(value));
+}
+
+
+void CheckpointWriter::write(const ChecksumSet& checksums)
+{
+	this->write_i32(checksums.length());
+	this->write_u32(static_cast<uint32_t>(checksums.size()));
+
+	// Write in the order of the types to get a deterministic output
+	for (const auto& type : checksum::types)
+	{
+		if (checksums.contains(type))
+		{
+			this->write_u32(static_cast<uint32_t>(type));
+			this->write_u32(checksums.get(type).value());
+		}
+	}
+}
+
+
+const std::vector<uint8_t>& CheckpointWriter::data() const noexcept
+{
+	return data_;
+}
+
+
+std::vector<uint8_t> CheckpointWriter::release() noexcept
+{
+	return std::move(data_);
+}
+
+
+// CheckpointReader
+
+
+CheckpointReader::CheckpointReader(const uint8_t* data, const std::size_t size)
+	: pos_ { data }
+	, end_ { data + size }
+{
+	// empty
+}
+
+
+uint32_t CheckpointReader::read_u32()
+{
+	this->require(4);
+
+	auto value = uint32_t { 0 };
+
+	for (auto shift = 0; shift < 32; shift += 8)
+	{
+		value |= static_cast<uint32_t>(*pos_++) << shift;
+	}
+
+	return value;
+}
+
+
+uint64_t CheckpointReader::read_u64()
+{
+	const auto lower  { this->read_u32() };
+	const auto higher { this->read_u32() };
+
+	return (static_cast<uint64_t>(higher) << 32) | lower;
+}
+
+
+int32_t CheckpointReader::read_i32()
+{
+	return static_cast<int32_t>(this->read_u32());
+}
+
+
+ChecksumSet CheckpointReader::read_checksums()
+{
+	auto checksums { ChecksumSet { this->read_i32() } };
+
+	const auto size { this->read_u32() };
+
+	for (auto i = uint32_t { 0 }; i < size; ++i)
+	{
+		const auto value { this->read_u32() };
+		const auto type  { static_cast<checksum::type>(value) };
+
+		if (std::find(checksum::types.begin(), checksum::types.end(), type)
+				== checksum::types.end())
+		{
+			throw std::invalid_argument("Checkpoint contains unknown checksum "
+					"type " + std::to_string(value));
+		}
+
+		checksums.insert(type, this->read_u32());
+	}
+
+	return checksums;
+}
+
+
+std::size_t CheckpointReader::remaining() const noexcept
+{
+	return static_cast<std::size_t>(end_ - pos_);
+}
+
+
+void CheckpointReader::require(const std::size_t n) const
+{
+	if (this->remaining() < n)
+	{
+		throw std::invalid_argument("Checkpoint is truncated");
+	}
+}
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
@@ -13,9 +13,10 @@
 #include "checksum_details.hpp"
 #endif
 
-#include <algorithm>        // for transform
+#include <algorithm>        // for equal, transform
 #include <array>            // for array
 #include <cmath>            // for log2
+#include <cstddef>          // for ptrdiff_t, size_t
 #include <cstdint>          // for int32_t
 #include <initializer_list> // for initializer_list
 #include <iterator>         // for begin, end, inserter
@@ -23,7 +24,8 @@
 #include <stdexcept>        // for domain_error
 #include <string>           // for string
 #include <type_traits>      // for underlying_type
-#include <utility>          // for pair, swap
+#include <unordered_set>    // for unordered_set
+#include <utility>          // for pair, swap, index_sequence
 
 
 namespace arcstk
@@ -92,11 +94,14 @@ namespace details
  * The order of names in this aggregate must match the order of types in
  * enum class checksum::type, otherwise function type_name() will fail.
  */
-static const std::array<std::string, 2> names {
+static const std::array<std::string, 6> names {
 	"ARCSv1",
 	"ARCSv2",
-	// "THIRD_TYPE" ,
-	// "FOURTH_TYPE" ...
+	"ARCS450",
+	"CRC32",
+	"CRC32ns",
+	"CTDB",
+	// "SEVENTH_TYPE" ...
 };
 
 } // namespace checksum::details
@@ -119,9 +124,193 @@ std::string type_name(const type t)
 } // namespace checksum
 
 
+// ChecksumtypeSet
+
+
+ChecksumtypeSet::ChecksumtypeSet() noexcept
+	: mask_ { 0 }
+{
+	// empty
+}
+
+
+ChecksumtypeSet::ChecksumtypeSet(std::initializer_list<checksum::type> types)
+	noexcept
+	: mask_ { 0 }
+{
+	for (const auto& type : types)
+	{
+		this->insert(type);
+	}
+}
+
+
+ChecksumtypeSet::ChecksumtypeSet(
+		const std::unordered_set<checksum::type>& types) noexcept
+	: mask_ { 0 }
+{
+	this->insert(types.begin(), types.end());
+}
+
+
+ChecksumtypeSet::operator std::unordered_set<checksum::type>() const
+{
+	return std::unordered_set<checksum::type>(this->begin(), this->end());
+}
+
+
+ChecksumtypeSet::size_type ChecksumtypeSet::size() const noexcept
+{
+	return checksum::details::bits_set(mask_);
+}
+
+
+bool ChecksumtypeSet::empty() const noexcept
+{
+	return mask_ == 0;
+}
+
+
+bool ChecksumtypeSet::contains(const checksum::type type) const noexcept
+{
+	return (mask_ & static_cast<mask_type>(type)) != 0;
+}
+
+
+ChecksumtypeSet::size_type ChecksumtypeSet::count(const checksum::type type)
+	const noexcept
+{
+	return this->contains(type) ? 1 : 0;
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::find(
+		const checksum::type type) const noexcept
+{
+	if (!this->contains(type))
+	{
+		return this->end();
+	}
+
+	// All types with a lower value are skipped by the iterator
+	return const_iterator { mask_ & ~(static_cast<mask_type>(type) - 1) };
+}
+
+
+std::pair<ChecksumtypeSet::const_iterator, bool> ChecksumtypeSet::insert(
+		const checksum::type type) noexcept
+{
+	const auto inserted { !this->contains(type) };
+
+	mask_ |= static_cast<mask_type>(type);
+
+	// All types with a lower value are skipped by the iterator
+	return { const_iterator {
+		mask_ & ~(static_cast<mask_type>(type) - 1) }, inserted };
+}
+
+
+void ChecksumtypeSet::insert(std::initializer_list<checksum::type> types)
+	noexcept
+{
+	this->insert(types.begin(), types.end());
+}
+
+
+std::pair<ChecksumtypeSet::const_iterator, bool> ChecksumtypeSet::emplace(
+		const checksum::type type) noexcept
+{
+	return this->insert(type);
+}
+
+
+ChecksumtypeSet::size_type ChecksumtypeSet::erase(const checksum::type type)
+	noexcept
+{
+	const auto erased { this->count(type) };
+
+	mask_ &= ~static_cast<mask_type>(type);
+
+	return erased;
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::erase(const_iterator pos)
+	noexcept
+{
+	if (pos == this->end())
+	{
+		return pos;
+	}
+
+	const auto type { static_cast<mask_type>(*pos) };
+
+	mask_ &= ~type;
+
+	// All types with a value up to the erased type are skipped by the iterator
+	return const_iterator { mask_ & ~(type | (type - 1)) };
+}
+
+
+void ChecksumtypeSet::clear() noexcept
+{
+	mask_ = 0;
+}
+
+
+ChecksumtypeSet::mask_type ChecksumtypeSet::mask() const noexcept
+{
+	return mask_;
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::cbegin() const noexcept
+{
+	return const_iterator { mask_ };
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::cend() const noexcept
+{
+	return const_iterator { 0 };
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::begin() const noexcept
+{
+	return this->cbegin();
+}
+
+
+ChecksumtypeSet::const_iterator ChecksumtypeSet::end() const noexcept
+{
+	return this->cend();
+}
+
+
 // ChecksumSet
 
 
+namespace
+{
+
+/**
+ * \brief Create the entries of a ChecksumSet.
+ *
+ * Each predefined type gets an empty entry on the position of its bit.
+ *
+ * \return Entries for all predefined types
+ */
+template <std::size_t... I>
+std::array<std::pair<const checksum::type, Checksum>, sizeof...(I)>
+	make_entries(std::index_sequence<I...>)
+{
+	return { { { checksum::types[I], Checksum { 0 } }... } };
+}
+
+} // namespace
+
+
 ChecksumSet::ChecksumSet()
 	: ChecksumSet { 0 }
 {
@@ -140,10 +329,56 @@ ChecksumSet::ChecksumSet(const int32_t length,
 		std::initializer_list<
 			std::pair<const ChecksumSet::key_type,
 							ChecksumSet::value_type>> checksums)
-	: set_     ( checksums )
+	: set_     { make_entries(
+					std::make_index_sequence<checksum::number_of_types>{}) }
+	, mask_    { 0         }
 	, length_  { length    }
 {
-	// empty
+	for (const auto& checksum : checksums)
+	{
+		this->insert(checksum.first, checksum.second);
+	}
+}
+
+
+ChecksumSet::ChecksumSet(const ChecksumSet& rhs) = default;
+
+
+ChecksumSet& ChecksumSet::operator = (const ChecksumSet& rhs)
+{
+	// The keys are fixed, hence only the Checksums are assigned
+	for (auto i = std::size_t { 0 }; i < set_.size(); ++i)
+	{
+		set_[i].second = rhs.set_[i].second;
+	}
+
+	mask_   = rhs.mask_;
+	length_ = rhs.length_;
+
+	return *this;
+}
+
+
+ChecksumSet::ChecksumSet(ChecksumSet&& rhs) noexcept = default;
+
+
+ChecksumSet& ChecksumSet::operator = (ChecksumSet&& rhs) noexcept
+{
+	using std::swap;
+	swap(*this, rhs);
+
+	return *this;
+}
+
+
+ChecksumSet::~ChecksumSet() noexcept = default;
+
+
+std::size_t ChecksumSet::index(const key_type type) noexcept
+{
+	// Number of the bit representing the type
+	return checksum::details::bits_set(
+			static_cast<ChecksumtypeSet::mask_type>(type) - 1);
 }
 
 
@@ -161,35 +396,30 @@ void ChecksumSet::set_length(const int32_t l) noexcept
 
 ChecksumSet::size_type ChecksumSet::size() const noexcept
 {
-	return set_.size();
+	return checksum::details::bits_set(mask_);
 }
 
 
 bool ChecksumSet::empty() const noexcept
 {
-	return set_.empty();
+	return mask_ == 0;
 }
 
 
 bool ChecksumSet::contains(const checksum::type& type) const
 {
-	using std::end;
-	return set_.find(type) != end(set_);
+	return (mask_ & static_cast<ChecksumtypeSet::mask_type>(type)) != 0;
 }
 
 
 Checksum ChecksumSet::get(const checksum::type type) const
 {
-	const auto rc { set_.find(type) };
-
-	using std::end;
-
-	if (rc == end(set_))
+	if (!this->contains(type))
 	{
 		return EmptyChecksum;
 	}
 
-	return rc->second;
+	return set_[ChecksumSet::index(type)].second;
 }
 
 
@@ -200,9 +430,9 @@ std::set<checksum::type> ChecksumSet::types() const
 	using std::begin;
 	using std::end;
 
-	std::transform(begin(set_), end(set_),
+	std::transform(begin(*this), end(*this),
 		std::inserter(keys, begin(keys)),
-		[](const storage_type::value_type& pair)
+		[](const entry_type& pair)
 		{
 			return pair.first;
 		}
@@ -215,7 +445,17 @@ std::set<checksum::type> ChecksumSet::types() const
 std::pair<ChecksumSet::iterator, bool> ChecksumSet::insert(
 		const checksum::type type, const Checksum& checksum)
 {
-	return set_.insert({ type, checksum });
+	const auto inserted { !this->contains(type) };
+
+	if (inserted)
+	{
+		set_[ChecksumSet::index(type)].second = checksum;
+		mask_ |= static_cast<ChecksumtypeSet::mask_type>(type);
+	}
+
+	// All types with a lower value are skipped by the iterator
+	return { iterator { set_.data(), mask_ &
+		~(static_cast<ChecksumtypeSet::mask_type>(type) - 1) }, inserted };
 }
 
 
@@ -233,62 +473,58 @@ void ChecksumSet::merge(ChecksumSet& rhs)
 		// Sets with zero length may be merged without constraint
 	}
 
-	#if __cplusplus < 201703L
-		// pre-C++17 implementation of merge()
-		using std::begin;
-		using std::end;
-		set_.insert(begin(rhs.set_), end(rhs.set_));
-	#else
-		set_.merge(rhs.set_);
-	#endif
+	for (const auto& entry : rhs)
+	{
+		this->insert(entry.first, entry.second);
+	}
 }
 
 
 void ChecksumSet::erase(const checksum::type& type)
 {
-	set_.erase(type);
+	mask_ &= ~static_cast<ChecksumtypeSet::mask_type>(type);
 }
 
 
 void ChecksumSet::clear()
 {
-	set_.clear();
+	mask_ = 0;
 }
 
 
 ChecksumSet::const_iterator ChecksumSet::cbegin() const
 {
-	return set_.cbegin();
+	return const_iterator { set_.data(), mask_ };
 }
 
 
 ChecksumSet::const_iterator ChecksumSet::cend() const
 {
-	return set_.cend();
+	return const_iterator { set_.data(), 0 };
 }
 
 
 ChecksumSet::const_iterator ChecksumSet::begin() const
 {
-	return set_.begin();
+	return this->cbegin();
 }
 
 
 ChecksumSet::const_iterator ChecksumSet::end() const
 {
-	return set_.end();
+	return this->cend();
 }
 
 
 ChecksumSet::iterator ChecksumSet::begin()
 {
-	return set_.begin();
+	return iterator { set_.data(), mask_ };
 }
 
 
 ChecksumSet::iterator ChecksumSet::end()
 {
-	return set_.end();
+	return iterator { set_.data(), 0 };
 }
 
 
@@ -298,6 +534,14 @@ ChecksumSet::operator bool() const noexcept
 }
 
 
+bool operator == (const ChecksumSet& lhs, const ChecksumSet& rhs) noexcept
+{
+	// Entries of types not present are not compared
+	return lhs.length_ == rhs.length_ && lhs.mask_ == rhs.mask_
+		&& std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+
 // empty instances
 
 
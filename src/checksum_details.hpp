@@ -13,6 +13,7 @@
  * \brief Implementation details for checksum.hpp.
  */
 
+#include <cstddef>  // for size_t
 #include <ostream>  // for ostream
 
 namespace arcstk
@@ -38,6 +39,25 @@ namespace details
 void print_hex(const Checksum& checksum, const bool upper,
 		const bool base, std::ostream& out);
 
+/**
+ * \brief Number of bits set in a bitmask.
+ *
+ * \param[in] mask Bitmask to count the bits of
+ *
+ * \return Number of bits set in \c mask
+ */
+constexpr std::size_t bits_set(unsigned int mask) noexcept
+{
+	auto count = std::size_t { 0 };
+
+	for (; mask != 0; mask &= mask - 1) // Clear lowest bit set
+	{
+		++count;
+	}
+
+	return count;
+}
+
 } // namespace details
 } // namespace checksum
 
@@ -0,0 +1,811 @@
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation of the composite checksum algorithm.
+ */
+
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#include "composite.hpp"
+#endif
+#ifndef __LIBARCSTK_COMPOSITE_DETAILS_HPP__
+#include "composite_details.hpp"
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"            // for AccurateRip::V1, V2, V1andV2, ...
+#endif
+#ifndef __LIBARCSTK_ACCURATERIP_DETAILS_HPP__
+#include "accuraterip_details.hpp"   // for SCRATCH_BUFFER_SIZE
+#endif
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#include "checkpoint.hpp"            // for CheckpointReader, CheckpointWriter
+#endif
+#ifndef __LIBARCSTK_LOGGING_HPP__
+#include "logging.hpp"
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"              // for AudioSize
+#endif
+
+#include <algorithm>     // for max, min
+#include <array>         // for array
+#include <cstddef>       // for size_t
+#include <stdexcept>     // for invalid_argument, logic_error
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+namespace details
+{
+namespace crc
+{
+
+namespace
+{
+
+/**
+ * \brief Update a CRC32 with a single sample.
+ *
+ * The CRC is passed and returned in its internal, i.e. inverted form.
+ *
+ * \param[in] c CRC32 in internal form
+ * \param[in] s Sample
+ *
+ * \return Updated CRC32 in internal form
+ */
+inline uint32_t step32(const uint32_t c, const sample_t s) noexcept
+{
+	const auto x { c ^ s };
+
+	return TABLES[3][ x        & 0xFF]
+		^  TABLES[2][(x >>  8) & 0xFF]
+		^  TABLES[1][(x >> 16) & 0xFF]
+		^  TABLES[0][ x >> 24        ];
+}
+
+
+/**
+ * \brief Update a CRC32 with a single 16 bit word.
+ *
+ * The CRC is passed and returned in its internal, i.e. inverted form.
+ *
+ * \param[in] c CRC32 in internal form
+ * \param[in] w 16 bit word
+ *
+ * \return Updated CRC32 in internal form
+ */
+inline uint32_t step16(const uint32_t c, const uint32_t w) noexcept
+{
+	const auto x { c ^ w };
+
+	return (x >> 16) ^ TABLES[1][x & 0xFF] ^ TABLES[0][(x >> 8) & 0xFF];
+}
+
+
+/**
+ * \brief Update a CRC32 with a sample skipping its null channels.
+ *
+ * \param[in] c CRC32 in internal form
+ * \param[in] s Sample
+ *
+ * \return Updated CRC32 in internal form
+ */
+inline uint32_t step_skip_nulls(const uint32_t c, const sample_t s) noexcept
+{
+	const auto lower  { s & 0xFFFF };
+	const auto higher { s >> 16 };
+
+	if (lower && higher)
+	{
+		return step32(c, s);
+	}
+
+	if (lower)
+	{
+		return step16(c, lower);
+	}
+
+	if (higher)
+	{
+		return step16(c, higher);
+	}
+
+	return c;
+}
+
+
+/**
+ * \brief Multiply two polynomials modulo POLYNOMIAL.
+ *
+ * Both polynomials are in reflected representation.
+ *
+ * \param[in] a First polynomial
+ * \param[in] b Second polynomial
+ *
+ * \return Product of \c a and \c b modulo POLYNOMIAL
+ */
+constexpr uint32_t multiply_mod_p(const uint32_t a, uint32_t b) noexcept
+{
+	auto m = uint32_t { 1u << 31 };
+	auto p = uint32_t { 0 };
+
+	while (m)
+	{
+		if (a & m)
+		{
+			p ^= b;
+
+			if ((a & (m - 1)) == 0)
+			{
+				break;
+			}
+		}
+
+		m >>= 1;
+		b = (b & 1) ? (b >> 1) ^ POLYNOMIAL : b >> 1;
+	}
+
+	return p;
+}
+
+
+/**
+ * \brief Create the table of x^(2^n) modulo POLYNOMIAL.
+ *
+ * \return Table of x^(2^n) modulo POLYNOMIAL for n = 0..31
+ */
+constexpr std::array<uint32_t, 32> make_x2n_table() noexcept
+{
+	auto table = std::array<uint32_t, 32> {};
+
+	auto p = uint32_t { 1u << 30 }; // x^1
+
+	table[0] = p;
+
+	for (auto n = std::size_t { 1 }; n < table.size(); ++n)
+	{
+		p = multiply_mod_p(p, p);
+		table[n] = p;
+	}
+
+	return table;
+}
+
+
+/**
+ * \brief Table of x^(2^n) modulo POLYNOMIAL.
+ */
+constexpr std::array<uint32_t, 32> X2N_TABLE { make_x2n_table() };
+
+
+/**
+ * \brief Compute x^(n * 2^k) modulo POLYNOMIAL.
+ *
+ * \param[in] n Factor of the exponent
+ * \param[in] k Power of 2 of the exponent
+ *
+ * \return x^(n * 2^k) modulo POLYNOMIAL
+ */
+uint32_t x2n_mod_p(uint64_t n, std::size_t k) noexcept
+{
+	auto p = uint32_t { 1u << 31 }; // x^0
+
+	while (n)
+	{
+		if (n & 1)
+		{
+			p = multiply_mod_p(X2N_TABLE[k & 31], p);
+		}
+
+		n >>= 1;
+		++k;
+	}
+
+	return p;
+}
+
+} // namespace
+
+
+uint32_t update_crc32(const uint32_t crc, const sample_t* start,
+		const sample_t* stop) noexcept
+{
+	auto c { ~crc };
+
+	for (auto s { start }; s != stop; ++s)
+	{
+		c = step32(c, *s);
+	}
+
+	return ~c;
+}
+
+
+uint32_t update_crc32_skip_nulls(const uint32_t crc, const sample_t* start,
+		const sample_t* stop) noexcept
+{
+	auto c { ~crc };
+
+	for (auto s { start }; s != stop; ++s)
+	{
+		c = step_skip_nulls(c, *s);
+	}
+
+	return ~c;
+}
+
+
+CRC32Pair update_crc32_pair(const CRC32Pair& crcs, const sample_t* start,
+		const sample_t* stop) noexcept
+{
+	auto c    { ~crcs.crc    };
+	auto c_ns { ~crcs.crc_ns };
+
+	for (auto s { start }; s != stop; ++s)
+	{
+		c    = step32(c, *s);
+		c_ns = step_skip_nulls(c_ns, *s);
+	}
+
+	return { ~c, ~c_ns };
+}
+
+
+uint32_t combine_crc32(const uint32_t crc1, const uint32_t crc2,
+		const uint64_t len2) noexcept
+{
+	// Shift crc1 by len2 bytes, i.e. multiply it by x^(8 * len2)
+	return multiply_mod_p(x2n_mod_p(len2, 3), crc1) ^ crc2;
+}
+
+
+// CRCAccumulator
+
+
+CRCAccumulator::CRCAccumulator(const ChecksumtypeSet& types)
+	: crc32_        { types.count(checksum::type::CRC32)   > 0 }
+	, crc32ns_      { types.count(checksum::type::CRC32ns) > 0 }
+	, ctdb_         { types.count(checksum::type::CTDB)    > 0 }
+	, track_crc_    { 0 }
+	, track_crc_ns_ { 0 }
+	, disc_crc_     { 0 }
+{
+	// empty
+}
+
+
+bool CRCAccumulator::empty() const noexcept
+{
+	return !(crc32_ || crc32ns_ || ctdb_);
+}
+
+
+void CRCAccumulator::update(const sample_t* start, const sample_t* stop,
+		const bool disc) noexcept
+{
+	if (start == stop)
+	{
+		return;
+	}
+
+	const auto to_disc { ctdb_ && disc };
+
+	if (!to_disc)
+	{
+		// The CRC32 of the track can be updated directly
+
+		if (crc32_ && crc32ns_)
+		{
+			const auto crcs { update_crc32_pair({ track_crc_, track_crc_ns_ },
+					start, stop) };
+
+			track_crc_    = crcs.crc;
+			track_crc_ns_ = crcs.crc_ns;
+		} else if (crc32_)
+		{
+			track_crc_ = update_crc32(track_crc_, start, stop);
+		} else if (crc32ns_)
+		{
+			track_crc_ns_ = update_crc32_skip_nulls(track_crc_ns_, start, stop);
+		}
+
+		return;
+	}
+
+	// The CRC32 of the sequence is computed once and appended to the CRC32 of
+	// the track as well as to the CRC32 of the disc
+
+	auto sequence_crc = uint32_t { 0 };
+
+	if (crc32ns_)
+	{
+		const auto crcs { update_crc32_pair({ 0, track_crc_ns_ }, start, stop) };
+
+		sequence_crc  = crcs.crc;
+		track_crc_ns_ = crcs.crc_ns;
+	} else
+	{
+		sequence_crc = update_crc32(0, start, stop);
+	}
+
+	const auto bytes { static_cast<uint64_t>(stop - start) * sizeof(sample_t) };
+
+	if (crc32_)
+	{
+		track_crc_ = combine_crc32(track_crc_, sequence_crc, bytes);
+	}
+
+	disc_crc_ = combine_crc32(disc_crc_, sequence_crc, bytes);
+}
+
+
+void CRCAccumulator::track_finished(ChecksumSet& checksums, const bool last)
+{
+	if (crc32_)
+	{
+		checksums.insert(checksum::type::CRC32, track_crc_);
+	}
+
+	if (crc32ns_)
+	{
+		checksums.insert(checksum::type::CRC32ns, track_crc_ns_);
+	}
+
+	if (ctdb_ && last)
+	{
+		checksums.insert(checksum::type::CTDB, disc_crc_);
+	}
+
+	track_crc_    = 0;
+	track_crc_ns_ = 0;
+}
+
+
+bool CRCAccumulator::mergeable() const noexcept
+{
+	return !(crc32ns_ || ctdb_);
+}
+
+
+void CRCAccumulator::merge(const ChecksumSet& lhs, const ChecksumSet& rhs,
+		const int32_t samples, ChecksumSet& merged) const
+{
+	if (!mergeable())
+	{
+		throw std::logic_error("CRC32ns and CTDB do not support partial "
+				"calculations");
+	}
+
+	if (crc32_)
+	{
+		// Append the CRC32 of the subsequent part to the CRC32 of the first
+
+		const auto bytes {
+			static_cast<uint64_t>(samples) * sizeof(sample_t) };
+
+		merged.insert(checksum::type::CRC32,
+				combine_crc32(lhs.get(checksum::type::CRC32).value(),
+					rhs.get(checksum::type::CRC32).value(), bytes));
+	}
+}
+
+
+void CRCAccumulator::reset() noexcept
+{
+	track_crc_    = 0;
+	track_crc_ns_ = 0;
+	disc_crc_     = 0;
+}
+
+
+void CRCAccumulator::save(CheckpointWriter& out) const
+{
+	out.write_u32(track_crc_);
+	out.write_u32(track_crc_ns_);
+	out.write_u32(disc_crc_);
+}
+
+
+void CRCAccumulator::restore(CheckpointReader& in)
+{
+	track_crc_    = in.read_u32();
+	track_crc_ns_ = in.read_u32();
+	disc_crc_     = in.read_u32();
+}
+
+} // namespace crc
+} // namespace details
+
+
+namespace
+{
+
+/**
+ * \brief Create the AccurateRip algorithm for the requested types.
+ *
+ * \param[in] types Requested checksum types
+ *
+ * \return AccurateRip algorithm or \c nullptr if no ARCS type is requested
+ */
+std::unique_ptr<Algorithm> make_arcs_algorithm(const ChecksumtypeSet& types)
+{
+	using checksum::type;
+
+	const auto v1    { types.count(type::ARCS1)    > 0 };
+	const auto v2    { types.count(type::ARCS2)    > 0 };
+	const auto f450  { types.count(type::FRAME450) > 0 };
+
+	if (f450)
+	{
+		return std::make_unique<AccurateRip::V1andV2withFrame450>();
+	}
+
+	if (v1 && v2)
+	{
+		return std::make_unique<AccurateRip::V1andV2>();
+	}
+
+	if (v1)
+	{
+		return std::make_unique<AccurateRip::V1>();
+	}
+
+	if (v2)
+	{
+		return std::make_unique<AccurateRip::V2>();
+	}
+
+	return nullptr;
+}
+
+
+/**
+ * \brief Intersect a sequence of samples with a range.
+ *
+ * \param[in] first 0-based index of the first sample of the sequence
+ * \param[in] last  0-based index behind the last sample of the sequence
+ * \param[in] range Range of 0-based indices, both bounds inclusive
+ *
+ * \return Intersection as 0-based indices, upper bound exclusive
+ */
+std::pair<int32_t, int32_t> intersect(const int32_t first, const int32_t last,
+		const std::pair<int32_t, int32_t>& range) noexcept
+{
+	const auto from { std::min(std::max(first, range.first), last) };
+
+	return { from, std::max(from, std::min(last, range.second + 1)) };
+}
+
+} // namespace
+
+
+// CompositeAlgorithm
+
+
+CompositeAlgorithm::CompositeAlgorithm(const ChecksumtypeSet& types)
+	: types_          { types }
+	, arcs_           { make_arcs_algorithm(types) }
+	, crcs_           { types }
+	, arcs_range_     { 0, -1 }
+	, disc_range_     { 0, -1 }
+	, points_         { /* empty */ }
+	, last_track_     { 1 }
+	, index_          { 0 }
+	, started_        { false }
+	, current_result_ { /* default */ }
+{
+	if (types_.empty())
+	{
+		throw std::invalid_argument("No checksum types requested");
+	}
+
+	ARCS_LOG_DEBUG << "Use composite algorithm for " << types_.size()
+		<< " checksum type(s)";
+}
+
+
+CompositeAlgorithm::CompositeAlgorithm(const CompositeAlgorithm& rhs)
+	: Algorithm       { rhs }
+	, types_          { rhs.types_ }
+	, arcs_           { rhs.arcs_ ? rhs.arcs_->clone() : nullptr }
+	, crcs_           { rhs.crcs_ }
+	, arcs_range_     { rhs.arcs_range_ }
+	, disc_range_     { rhs.disc_range_ }
+	, points_         { rhs.points_ }
+	, last_track_     { rhs.last_track_ }
+	, index_          { rhs.index_ }
+	, started_        { rhs.started_ }
+	, current_result_ { rhs.current_result_ }
+{
+	// empty
+}
+
+
+CompositeAlgorithm& CompositeAlgorithm::operator=(const CompositeAlgorithm& rhs)
+{
+	if (this != &rhs)
+	{
+		Algorithm::operator=(rhs);
+
+		types_          = rhs.types_;
+		arcs_           = rhs.arcs_ ? rhs.arcs_->clone() : nullptr;
+		crcs_           = rhs.crcs_;
+		arcs_range_     = rhs.arcs_range_;
+		disc_range_     = rhs.disc_range_;
+		points_         = rhs.points_;
+		last_track_     = rhs.last_track_;
+		index_          = rhs.index_;
+		started_        = rhs.started_;
+		current_result_ = rhs.current_result_;
+	}
+
+	return *this;
+}
+
+
+CompositeAlgorithm::~CompositeAlgorithm() noexcept = default;
+
+
+void CompositeAlgorithm::do_setup(const Settings* s)
+{
+	if (arcs_)
+	{
+		arcs_->set_settings(s);
+	}
+}
+
+
+CompositeAlgorithm::Ranges CompositeAlgorithm::ranges(const AudioSize& size,
+		const Points& points) const
+{
+	const auto ctx { this->settings()->context() };
+
+	auto r = Ranges { { 0, -1 }, { 0, -1 }, { 0, -1 } };
+
+	if (arcs_)
+	{
+		r.arcs = arcs_->range(size, points);
+	}
+
+	if (crcs_.empty())
+	{
+		r.total = r.arcs;
+		return r;
+	}
+
+	// The CRCs are calculated on all samples of the tracks
+
+	const auto from = int32_t { points.empty() ? 0 : points[0].samples() };
+	const auto to   = int32_t { size.samples() - 1 };
+
+	r.total = { from, to };
+	r.disc  = { from, to };
+
+	if (any(Context::FIRST_TRACK & ctx))
+	{
+		r.disc.first += details::crc::CTDB_SKIP_SAMPLES;
+	}
+
+	if (any(Context::LAST_TRACK & ctx))
+	{
+		r.disc.second -= details::crc::CTDB_SKIP_SAMPLES;
+	}
+
+	ARCS_LOG(DEBUG2) << "Range for CRCs is: " << from << " - " << to;
+
+	return r;
+}
+
+
+std::pair<int32_t, int32_t> CompositeAlgorithm::do_range(const AudioSize& size,
+		const Points& points) const
+{
+	return ranges(size, points).total;
+}
+
+
+void CompositeAlgorithm::do_prepare(const AudioSize& size,
+		const Points& points)
+{
+	const auto r { ranges(size, points) };
+
+	arcs_range_ = r.arcs;
+	disc_range_ = r.disc;
+	points_     = points;
+	last_track_ = points.empty() ? 1 : static_cast<int>(points.size());
+
+	if (!started_)
+	{
+		index_ = r.total.first;
+	}
+
+	if (arcs_)
+	{
+		arcs_->prepare(size, points);
+	}
+}
+
+
+void CompositeAlgorithm::do_update(SampleInputIterator start,
+		SampleInputIterator stop)
+{
+	using accuraterip::details::SCRATCH_BUFFER_ALIGNMENT;
+	using accuraterip::details::SCRATCH_BUFFER_SIZE;
+
+	alignas(SCRATCH_BUFFER_ALIGNMENT)
+		std::array<sample_t, SCRATCH_BUFFER_SIZE> buffer;
+
+	constexpr auto block_size {
+		static_cast<SampleInputIterator::difference_type>(buffer.size()) };
+
+	auto pos { start };
+	auto remaining { stop - start };
+
+	while (remaining > 0)
+	{
+		const auto n { std::min(remaining, block_size) };
+
+		pos.copy(n, buffer.data()); // advances pos
+		this->do_update(buffer.data(), buffer.data() + n);
+
+		remaining -= n;
+	}
+}
+
+
+void CompositeAlgorithm::do_update(const sample_t* start, const sample_t* stop)
+{
+	const auto first { index_ };
+	const auto last  { static_cast<int32_t>(index_ + (stop - start)) };
+
+	index_   = last;
+	started_ = true;
+
+	if (arcs_)
+	{
+		const auto arcs { intersect(first, last, arcs_range_) };
+
+		if (arcs.first < arcs.second)
+		{
+			arcs_->update(start + (arcs.first - first),
+					start + (arcs.second - first));
+		}
+	}
+
+	if (crcs_.empty())
+	{
+		return;
+	}
+
+	const auto disc { intersect(first, last, disc_range_) };
+	const auto disc_start { start + (disc.first  - first) };
+	const auto disc_stop  { start + (disc.second - first) };
+
+	crcs_.update(start,      disc_start, false);
+	crcs_.update(disc_start, disc_stop,  true);
+	crcs_.update(disc_stop,  stop,       false);
+}
+
+
+void CompositeAlgorithm::do_track_finished(const int t,
+		const AudioSize& length)
+{
+	current_result_ = ChecksumSet { length.frames() };
+
+	if (arcs_)
+	{
+		arcs_->track_finished(t, length);
+
+		for (const auto& entry : arcs_->result())
+		{
+			if (types_.count(entry.first) > 0)
+			{
+				current_result_.insert(entry.first, entry.second);
+			}
+		}
+	}
+
+	crcs_.track_finished(current_result_, t == last_track_);
+}
+
+
+ChecksumSet CompositeAlgorithm::do_result() const
+{
+	return current_result_;
+}
+
+
+ChecksumtypeSet CompositeAlgorithm::do_types() const
+{
+	return types_;
+}
+
+
+std::unique_ptr<Algorithm> CompositeAlgorithm::do_clone() const
+{
+	return std::make_unique<CompositeAlgorithm>(*this);
+}
+
+
+void CompositeAlgorithm::do_seek(const int t, const int32_t index)
+{
+	if (!crcs_.mergeable())
+	{
+		throw std::logic_error("CRC32ns and CTDB do not support partial "
+				"calculations");
+	}
+
+	const auto track { static_cast<std::size_t>(t - 1) };
+
+	index_   = (track < points_.size() ? points_[track].samples() : 0) + index;
+	started_ = true;
+
+	// The ARCS algorithm starts at the beginning of its range unless the
+	// calculation continues behind it
+
+	if (arcs_ && index_ > arcs_range_.first)
+	{
+		arcs_->seek(t, index);
+	}
+}
+
+
+void CompositeAlgorithm::do_reset()
+{
+	if (arcs_)
+	{
+		arcs_->reset();
+	}
+
+	crcs_.reset();
+	index_          = 0;
+	started_        = false;
+	current_result_ = ChecksumSet {};
+}
+
+
+ChecksumSet CompositeAlgorithm::do_merge(const ChecksumSet& lhs,
+		const ChecksumSet& rhs, const int32_t samples) const
+{
+	auto merged { arcs_
+		? arcs_->merge(lhs, rhs, samples)
+		: ChecksumSet { lhs.length() + rhs.length() } };
+
+	crcs_.merge(lhs, rhs, samples, merged);
+
+	return merged;
+}
+
+
+void CompositeAlgorithm::do_save(CheckpointWriter& out) const
+{
+	if (arcs_)
+	{
+		arcs_->save(out);
+	}
+
+	crcs_.save(out);
+	out.write_i32(index_);
+	out.write(current_result_);
+}
+
+
+void CompositeAlgorithm::do_restore(CheckpointReader& in)
+{
+	if (arcs_)
+	{
+		arcs_->restore(in);
+	}
+
+	crcs_.restore(in);
+	index_          = in.read_i32();
+	started_        = true;
+	current_result_ = in.read_checksums();
+}
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
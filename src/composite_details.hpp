@@ -0,0 +1,189 @@
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#error "Do not include composite_details.hpp, include composite.hpp instead"
+#endif
+
+#ifndef __LIBARCSTK_COMPOSITE_DETAILS_HPP__
+#define __LIBARCSTK_COMPOSITE_DETAILS_HPP__
+
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation details for composite.hpp.
+ */
+
+#include <array>          // for array
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint32_t, uint64_t
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"  // for sample_t
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+namespace details
+{
+namespace crc
+{
+
+/**
+ * \internal
+ *
+ * \brief Reflected CRC32 polynomial as used by zlib, EAC and CTDB.
+ */
+constexpr uint32_t POLYNOMIAL { 0xEDB88320 };
+
+/**
+ * \internal
+ *
+ * \brief Number of samples the CTDB CRC omits at the beginning and the end of
+ * the disc.
+ */
+constexpr int32_t CTDB_SKIP_SAMPLES { 10 * 588 };
+
+/**
+ * \internal
+ *
+ * \brief Lookup tables for processing 4 bytes per step.
+ *
+ * Table 0 is the common bytewise table. Table \c k yields the CRC of a byte
+ * followed by \c k zero bytes.
+ */
+using CRCTables = std::array<std::array<uint32_t, 256>, 4>;
+
+/**
+ * \internal
+ *
+ * \brief Create the lookup tables for POLYNOMIAL.
+ *
+ * \return Lookup tables for POLYNOMIAL
+ */
+constexpr CRCTables make_tables() noexcept
+{
+	auto tables = CRCTables {};
+
+	for (auto n = uint32_t { 0 }; n < 256; ++n)
+	{
+		auto c { n };
+
+		for (auto k = 0; k < 8; ++k)
+		{
+			c = (c & 1) ? (c >> 1) ^ POLYNOMIAL : c >> 1;
+		}
+
+		tables[0][n] = c;
+	}
+
+	for (auto n = std::size_t { 0 }; n < 256; ++n)
+	{
+		for (auto t = std::size_t { 1 }; t < tables.size(); ++t)
+		{
+			const auto prev { tables[t - 1][n] };
+			tables[t][n] = (prev >> 8) ^ tables[0][prev & 0xFF];
+		}
+	}
+
+	return tables;
+}
+
+/**
+ * \internal
+ *
+ * \brief Lookup tables for POLYNOMIAL.
+ */
+constexpr CRCTables TABLES { make_tables() };
+
+/**
+ * \internal
+ *
+ * \brief Update a CRC32 with a sequence of samples.
+ *
+ * Each sample is processed as its 4 bytes in little endian order, i.e. the
+ * bytes of the left channel come first. The CRC is passed and returned in its
+ * final form, hence the CRC32 of a sequence is <tt>update_crc32(0, ...)</tt>.
+ *
+ * \param[in] crc   CRC32 of the preceding samples
+ * \param[in] start Pointer to the first sample
+ * \param[in] stop  Pointer behind the last sample
+ *
+ * \return CRC32 of the preceding samples and the sequence
+ */
+uint32_t update_crc32(const uint32_t crc, const sample_t* start,
+		const sample_t* stop) noexcept;
+
+/**
+ * \internal
+ *
+ * \brief Update a CRC32 with a sequence of samples skipping null samples.
+ *
+ * Each 16 bit sample of either channel that is 0 is skipped.
+ *
+ * \param[in] crc   CRC32 of the preceding samples
+ * \param[in] start Pointer to the first sample
+ * \param[in] stop  Pointer behind the last sample
+ *
+ * \return CRC32 of the non-null preceding samples and the sequence
+ */
+uint32_t update_crc32_skip_nulls(const uint32_t crc, const sample_t* start,
+		const sample_t* stop) noexcept;
+
+/**
+ * \internal
+ *
+ * \brief A CRC32 and a CRC32 skipping null samples.
+ */
+struct CRC32Pair final
+{
+	/**
+	 * \brief CRC32 of all samples.
+	 */
+	uint32_t crc;
+
+	/**
+	 * \brief CRC32 of the samples that are not null.
+	 */
+	uint32_t crc_ns;
+};
+
+/**
+ * \internal
+ *
+ * \brief Update a CRC32 and a CRC32 skipping null samples in a single pass.
+ *
+ * Equivalent to update_crc32() and update_crc32_skip_nulls() but reads each
+ * sample only once.
+ *
+ * \param[in] crcs  CRCs of the preceding samples
+ * \param[in] start Pointer to the first sample
+ * \param[in] stop  Pointer behind the last sample
+ *
+ * \return CRCs of the preceding samples and the sequence
+ */
+CRC32Pair update_crc32_pair(const CRC32Pair& crcs, const sample_t* start,
+		const sample_t* stop) noexcept;
+
+/**
+ * \internal
+ *
+ * \brief Combine the CRC32s of two consecutive sequences.
+ *
+ * \param[in] crc1 CRC32 of the first sequence
+ * \param[in] crc2 CRC32 of the second sequence
+ * \param[in] len2 Length of the second sequence in bytes
+ *
+ * \return CRC32 of the concatenation of both sequences
+ */
+uint32_t combine_crc32(const uint32_t crc1, const uint32_t crc2,
+		const uint64_t len2) noexcept;
+
+} // namespace crc
+} // namespace details
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
@@ -24,19 +24,27 @@
 #include "logging.hpp"
 #endif
 
-#include <cstdint>          // for uint32_t
-#include <cstdio>           // for EOF
+#include <cerrno>           // for errno
+#include <cstddef>          // for ptrdiff_t, size_t
+#include <cstdint>          // for uint32_t, uint8_t
+#include <cstring>          // for strerror
 #include <fstream>          // for basic_ifstream
 #include <initializer_list> // for initializer_list
 #include <memory>           // for unique_ptr, make_unique
-#include <numeric>			// for accumulate
 #include <sstream>			// for ostringstream
-#include <stdexcept>		// for runtime_error
+#include <stdexcept>		// for runtime_error, invalid_argument, logic_error
 #include <string>			// for string
 #include <tuple>			// for get, tuple
 #include <utility>			// for pair, move
 #include <vector>			// for vector
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>          // for open, O_RDONLY
+#include <sys/mman.h>       // for mmap, munmap
+#include <sys/stat.h>       // for fstat, stat, S_ISREG
+#include <unistd.h>         // for close
+#endif
+
 namespace arcstk
 {
 inline namespace v_1_0_0
@@ -45,16 +53,6 @@ inline namespace v_1_0_0
 namespace details
 {
 
-uint32_t le_bytes_to_uint32(const char b1, const char b2, const char b3,
-		const char b4)
-{
-	return  static_cast<uint32_t>(b4 & 0xFF) << 24 |
-			static_cast<uint32_t>(b3 & 0xFF) << 16 |
-			static_cast<uint32_t>(b2 & 0xFF) <<  8 |
-			static_cast<uint32_t>(b1 & 0xFF);
-}
-
-
 void on_parse_error(const unsigned byte_pos, const unsigned block,
 		const unsigned block_byte_pos, ParseErrorHandler* e)
 {
@@ -68,8 +66,22 @@ void on_parse_error(const unsigned byte_pos, const unsigned block,
 }
 
 
-uint32_t parse_dbar_stream(std::istream& in, ParseHandler* p,
-		ParseErrorHandler* e)
+OptionalErrorHandler::OptionalErrorHandler(ParseErrorHandler* e)
+	: e_ { e }
+{
+	// empty
+}
+
+
+void OptionalErrorHandler::on_error(const unsigned byte_pos,
+		const unsigned block, const unsigned block_byte_pos)
+{
+	on_parse_error(byte_pos, block, block_byte_pos, e_);
+}
+
+
+uint32_t parse_dbar_buffer(const uint8_t* data, const std::size_t size,
+		ParseHandler* p, ParseErrorHandler* e)
 {
 	if (!p)
 	{
@@ -78,237 +90,83 @@ uint32_t parse_dbar_stream(std::istream& in, ParseHandler* p,
 		return 0;
 	}
 
-	using details::BLOCK_HEADER_BYTES;
-	using details::TRIPLET_BYTES;
+	auto error_handler = OptionalErrorHandler { e };
 
-	std::vector<char> id(BLOCK_HEADER_BYTES * sizeof(char));
-	std::vector<char> triplet(TRIPLET_BYTES * sizeof(char));
-
-	auto track_count   = int { 0 };
-	auto discId1       = uint32_t { 0 };
-	auto discId2       = uint32_t { 0 };
-	auto cddbId        = uint32_t { 0 };
-	auto confidence    = unsigned { 0 };
-	auto trk_arcs      = uint32_t { 0 };
-	auto frame450_arcs = uint32_t { 0 };
-
-	auto bytes_read         = unsigned { 0 };
-	auto byte_counter       = unsigned { 0 };
-	auto block_counter      = unsigned { 0 };
-	auto block_byte_counter = unsigned { 0 };
-
-	p->start_input();
-
-	// Commented out:
-	// Provided that the file size is carefully verified to be "small",
-	// we could also read the entire binary file content in a vector<uint8_t>
-	// and proceed working on that vector:
-	//
-	// std::vector<uint8_t> file_content(const std::string& filename) const
-	// {
-	//   std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
-	//
-	//   std::vector<uint8_t> bytes(
-	//		(std::istreambuf_iterator<char>(input)),
-	//		std::istreambuf_iterator<char>()
-	//   );
-	//
-	//   return bytes;
-	// }
-	//
-	// Currently, we read the file bytewise instead. This is more effort, but
-	// enables instant detecting of unexpected input and very precise error
-	// messages.
-
-	while (in.good() and in.peek() != EOF)
-	{
-		++block_counter;
+	const auto byte_counter { parse_buffer(data, size, *p, error_handler) };
 
-		block_byte_counter = 0;
-		bytes_read = 0;
+	ARCS_LOG(DEBUG1)  << "Parsed " << byte_counter << " bytes";
 
-		p->start_block();
+	return byte_counter;
+}
 
-		// Read header of current block
 
-		track_count = 0;
-		discId1 = 0;
-		discId2 = 0;
-		cddbId  = 0;
+void read_dbar_chunks(std::istream& in, const ChunkHandler& consume)
+{
+	auto chunk = std::vector<uint8_t>(READ_BUFFER_BYTES);
+	auto total = std::size_t { 0 };
 
+	while (in.good())
+	{
 		try
 		{
-			in.read(&id[0], BLOCK_HEADER_BYTES * sizeof(id[0]));
-			bytes_read = in.gcount();
+			in.read(reinterpret_cast<char*>(chunk.data()), READ_BUFFER_BYTES);
 
-		} catch (const std::istream::failure& flr)
+		} catch (const std::istream::failure&)
 		{
-			bytes_read = in.gcount();
+			// Short read on a stream with exceptions enabled, gcount() is
+			// still valid
 		}
 
-		ARCS_LOG(DEBUG2) << "Read " << bytes_read << " header bytes";
-
-		byte_counter += bytes_read;
-		block_byte_counter += bytes_read;
-
-		ARCS_LOG(DEBUG2) << "Read " << byte_counter << " bytes total";
-
-		if (bytes_read == 0)
-		{
-			on_parse_error(byte_counter, block_counter, block_byte_counter, e);
-			break;
-		} else
-		{
-			// At least 1 byte has been read. We want to pass the bytes parsed
-			// so far to the content handler
-
-			track_count = id[0] & 0xFF;
-
-			if (bytes_read <= 4 * sizeof(id[0]))
-			{
-				p->header(track_count, 0, 0, 0);
-
-				on_parse_error(byte_counter, block_counter, block_byte_counter,
-						e);
-				break;
-			}
-
-			discId1 = le_bytes_to_uint32(id[1], id[ 2], id[ 3], id[ 4]);
-
-			if (bytes_read <= 8 * sizeof(id[0]))
-			{
-				p->header(track_count, discId1, 0, 0);
-
-				on_parse_error(byte_counter, block_counter, block_byte_counter,
-						e);
-				break;
-			}
-
-			discId2 = le_bytes_to_uint32(id[5], id[ 6], id[ 7], id[ 8]);
-
-			if (bytes_read <= 12 * sizeof(id[0]))
-			{
-				p->header(track_count, discId1, discId2, 0);
-
-				on_parse_error(byte_counter, block_counter, block_byte_counter,
-						e);
-				break;
-			}
+		const auto bytes_read { static_cast<std::size_t>(in.gcount()) };
 
-			cddbId  = le_bytes_to_uint32(id[9], id[10], id[11], id[12]);
-
-			ARCS_LOG(DEBUG1) << "New block (" << track_count
-				<< " tracks) starts. ID: "
-				<< ARId(track_count, discId1, discId2, cddbId).filename();
-
-			p->header(track_count, discId1, discId2, cddbId);
-		}
-
-		if (not in.good())
+		if (bytes_read > 0)
 		{
-			on_parse_error(byte_counter, block_counter, block_byte_counter, e);
-			break;
+			consume(chunk.data(), bytes_read);
+			total += bytes_read;
 		}
+	}
 
-		bytes_read = 0;
+	ARCS_LOG(DEBUG2) << "Read " << total << " bytes from stream";
+}
 
-		// Read triplets of current block
 
-		for (auto trk = uint8_t { 0 }; trk < track_count; ++trk)
-		{
-			try
-			{
-				in.read(&triplet[0], TRIPLET_BYTES * sizeof(triplet[0]));
-				bytes_read = in.gcount();
+std::vector<uint8_t> read_dbar_stream(std::istream& in)
+{
+	auto bytes = std::vector<uint8_t> {};
 
-			} catch (std::istream::failure& flr)
+	read_dbar_chunks(in,
+			[&bytes](const uint8_t* data, const std::size_t size)
 			{
-				bytes_read = in.gcount();
-			}
-
-			ARCS_LOG(DEBUG2) << "Read " << bytes_read << " triplet bytes";
-
-			byte_counter += bytes_read;
-			block_byte_counter += bytes_read;
+				bytes.insert(bytes.end(), data, data + size);
+			});
 
-			ARCS_LOG(DEBUG2) << "Read " << byte_counter << " bytes total";
+	return bytes;
+}
 
-			if (bytes_read == 0)
-			{
-				on_parse_error(byte_counter, block_counter, block_byte_counter,
-						e);
-				break;
-			} else
-			{
-				// At least 1 byte has been read. We want to pass the bytes
-				// parsed so far to the content handler
-
-				confidence = triplet[0] & 0xFF;
-
-				if (bytes_read <= 4 * sizeof(id[0]))
-				{
-					// => We have read the confidence value, but reading
-					// failed on the actual ARCS.
-
-					// From a semantic perspective, it does not make sense to
-					// pass a confidence value when we do not know the ARCS to
-					// which it relates. The client could be mistake the 0 value
-					// for the actual ARCS. From a technical point of view, it
-					// may be interesting for the client to know how much bytes
-					// could be read from the stream and have the values that
-					// could be completely read without error. The client will
-					// know that 0 is not a valid ARCS for a non-silent track.
-
-					p->triplet(UNPARSED_ARCS, confidence, UNPARSED_ARCS);
-					// ARCS + frame450 ARCS are not valid
-
-					on_parse_error(byte_counter, block_counter,
-							block_byte_counter, e);
-					break;
-				}
-
-				trk_arcs = le_bytes_to_uint32(
-								triplet[1], triplet[2],
-								triplet[3], triplet[4]);
-
-				if (bytes_read <= 8 * sizeof(id[0]))
-				{
-					p->triplet(trk_arcs, confidence, UNPARSED_ARCS);
-					// frame450 ARCS is not valid
-
-					on_parse_error(byte_counter, block_counter,
-							block_byte_counter, e);
-					break;
-				}
-
-				frame450_arcs = le_bytes_to_uint32(
-								triplet[5], triplet[6],
-								triplet[7], triplet[8]);
-
-				p->triplet(trk_arcs, confidence, frame450_arcs);
-				// everything is valid
-			}
-
-			if (not in.good())
-			{
-				on_parse_error(byte_counter, block_counter, block_byte_counter,
-						e);
-			}
-		} // for
 
-		p->end_block();
+uint32_t parse_dbar_stream(std::istream& in, ParseHandler* p,
+		ParseErrorHandler* e)
+{
+	if (!p)
+	{
+		ARCS_LOG_WARNING
+			<< "Parser has no content handler attached, skip parsing";
+		return 0;
 	}
 
-	p->end_input();
+	DBARPushParser parser { p, e };
 
-	ARCS_LOG(DEBUG1)  << "Parsed " << byte_counter << " bytes";
+	read_dbar_chunks(in,
+			[&parser](const uint8_t* data, const std::size_t size)
+			{
+				parser.feed(data, size);
+			});
 
-	return byte_counter;
+	return parser.finish();
 }
 
 
-uint32_t parse_dbar_file(const std::string& filename, ParseHandler* p,
-		ParseErrorHandler* e)
+std::ifstream open_dbar_file(const std::string& filename)
 {
 	std::ifstream file;
 	file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
@@ -325,7 +183,24 @@ uint32_t parse_dbar_file(const std::string& filename, ParseHandler* p,
 		});
 	}
 
-	const auto byte_counter { parse_stream(file, p, e) };
+	return file;
+}
+
+
+std::vector<uint8_t> read_dbar_file(const std::string& filename)
+{
+	auto file { open_dbar_file(filename) };
+
+	return read_dbar_stream(file);
+}
+
+
+uint32_t parse_dbar_file(const std::string& filename, ParseHandler* p,
+		ParseErrorHandler* e)
+{
+	auto file { open_dbar_file(filename) };
+
+	const auto byte_counter { parse_dbar_stream(file, p, e) };
 
 	ARCS_LOG_DEBUG << "Successfully finished to parse file '"
 		<< filename << "'.";
@@ -541,6 +416,8 @@ DBAR::Impl::Impl()
 	: total_tracks_ { /* default */ }
 	, confidence_   { /* default */ }
 	, sums_         { /* default */ }
+	, sums_starts_       { /* default */ }
+	, confidence_starts_ { /* default */ }
 {
 	// empty
 }
@@ -579,7 +456,7 @@ const unsigned& DBAR::Impl::confidence_value(
 		const size_type block_idx,
 		const size_type track) const
 {
-	return confidence_[total_tracks_accumulated(block_idx) + track];
+	return confidence_[confidence_idx(block_idx, track)];
 }
 
 
@@ -593,6 +470,20 @@ const uint32_t& DBAR::Impl::frame450_arcs_value(const size_type block_idx,
 void DBAR::Impl::add_header(const uint8_t track_count, const uint32_t id1,
 			const uint32_t id2, const uint32_t cddb_id)
 {
+	// The new block starts behind the declared tracks of the previous block
+
+	if (total_tracks_.empty())
+	{
+		sums_starts_.push_back(0);
+		confidence_starts_.push_back(0);
+	} else
+	{
+		sums_starts_.push_back(sums_starts_.back() + header_size
+				+ total_tracks_.back() * track_size);
+		confidence_starts_.push_back(confidence_starts_.back()
+				+ total_tracks_.back());
+	}
+
 	total_tracks_.push_back(track_count);
 
 	sums_.push_back(id1);
@@ -646,22 +537,10 @@ DBARTriplet DBAR::Impl::triplet(const DBAR::Impl::size_type block_idx,
 }
 
 
-unsigned DBAR::Impl::total_tracks_accumulated(const size_type block_idx) const
-{
-	using diff_type = decltype( total_tracks_ )::difference_type;
-
-	return std::accumulate(
-		total_tracks_.begin(),
-		total_tracks_.begin() + static_cast<diff_type>(block_idx),
-		0u);
-}
-
-
 DBAR::Impl::size_type DBAR::Impl::start_idx(
 		const size_type block_idx) const
 {
-	return block_idx * header_size
-		+ total_tracks_accumulated(block_idx) * track_size;
+	return sums_starts_[block_idx];
 }
 
 
@@ -675,7 +554,7 @@ DBAR::Impl::size_type DBAR::Impl::arcs_idx(
 DBAR::Impl::size_type DBAR::Impl::confidence_idx(
 		const size_type block_idx, const size_type track_idx) const
 {
-	return total_tracks_accumulated(block_idx) + track_idx;
+	return confidence_starts_[block_idx] + track_idx;
 }
 
 
@@ -1090,16 +969,437 @@ uint32_t parse_file(const std::string& filename, ParseHandler* p,
 }
 
 
+uint32_t parse_buffer(const uint8_t* data, const std::size_t size,
+		ParseHandler* p, ParseErrorHandler* e)
+{
+	return details::parse_dbar_buffer(data, size, p, e);
+}
+
+
 // load_file()
 
 
 DBAR load_file(const std::string& filename)
 {
+	auto file { details::open_dbar_file(filename) };
+
+	// Parse events are dispatched to the DBARBuilder statically
 	DBARBuilder builder;
-	details::parse_dbar_file(filename, &builder, nullptr);
+	DBARErrorHandler error_handler;
+	details::DBARDecoder decoder;
+
+	details::read_dbar_chunks(file,
+			[&decoder, &builder](const uint8_t* data, const std::size_t size)
+			{
+				decoder.feed(data, size, builder);
+			});
+
+	decoder.finish(builder, error_handler);
 	return builder.result();
 }
 
+
+// DBARPushParser
+
+
+DBARPushParser::DBARPushParser(ParseHandler* p, ParseErrorHandler* e)
+	: p_       { p }
+	, e_       { e }
+	, decoder_ { /* default */ }
+{
+	if (!p)
+	{
+		throw std::invalid_argument(
+				"DBARPushParser requires a content handler");
+	}
+}
+
+
+void DBARPushParser::feed(const uint8_t* data, const std::size_t size)
+{
+	if (decoder_.finished())
+	{
+		throw std::logic_error("Cannot feed a finished DBARPushParser");
+	}
+
+	decoder_.feed(data, size, *p_);
+}
+
+
+uint32_t DBARPushParser::finish()
+{
+	auto error_handler = details::OptionalErrorHandler { e_ };
+
+	const auto byte_counter { decoder_.finish(*p_, error_handler) };
+
+	ARCS_LOG(DEBUG1)  << "Parsed " << byte_counter << " bytes";
+
+	return byte_counter;
+}
+
+
+bool DBARPushParser::block_complete() const noexcept
+{
+	return decoder_.block_complete();
+}
+
+
+uint32_t DBARPushParser::bytes_parsed() const noexcept
+{
+	return decoder_.bytes_parsed();
+}
+
+
+// DBARView::Impl
+
+
+DBARView::Impl::Impl(const std::string& filename)
+	: mapping_       { nullptr }
+	, mapping_size_  { 0 }
+	, buffer_        { /* empty */ }
+	, data_          { nullptr }
+	, bytes_         { 0 }
+	, block_offsets_ { /* empty */ }
+{
+#if defined(__unix__) || defined(__APPLE__)
+	if (!this->map_file(filename))
+	{
+		this->read_file(filename);
+	}
+#else
+	this->read_file(filename);
+#endif
+
+	try
+	{
+		this->index_blocks();
+	}
+	catch (...)
+	{
+		this->unmap();
+		throw;
+	}
+
+	ARCS_LOG_DEBUG << (mapping_ ? "Mapped " : "Read ") << bytes_
+		<< " bytes with " << block_offsets_.size() << " blocks from file '"
+		<< filename << "'";
+}
+
+
+DBARView::Impl::Impl(const uint8_t* data, const size_type bytes)
+	: mapping_       { nullptr }
+	, mapping_size_  { 0 }
+	, buffer_        { /* empty */ }
+	, data_          { data }
+	, bytes_         { data ? bytes : 0 }
+	, block_offsets_ { /* empty */ }
+{
+	this->index_blocks();
+}
+
+
+DBARView::Impl::~Impl() noexcept
+{
+	this->unmap();
+}
+
+
+#if defined(__unix__) || defined(__APPLE__)
+
+bool DBARView::Impl::map_file(const std::string& filename)
+{
+	const auto fd { ::open(filename.c_str(), O_RDONLY) };
+
+	if (fd < 0)
+	{
+		const auto message { std::string { std::strerror(errno) } };
+
+		throw std::runtime_error(std::string{
+			"Failed to open file '" + filename + "'. Message: " + message
+		});
+	}
+
+	struct stat file_stat;
+
+	if (::fstat(fd, &file_stat) != 0)
+	{
+		const auto message { std::string { std::strerror(errno) } };
+		::close(fd);
+
+		throw std::runtime_error(std::string{
+			"Failed to stat file '" + filename + "'. Message: " + message
+		});
+	}
+
+	// The size of other files is not known in advance, they are read instead
+
+	if (!S_ISREG(file_stat.st_mode))
+	{
+		::close(fd);
+		return false;
+	}
+
+	// An empty file cannot be mapped but is a valid empty view
+
+	if (file_stat.st_size > 0)
+	{
+		const auto size { static_cast<std::size_t>(file_stat.st_size) };
+		const auto mapping { ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd,
+				0) };
+
+		if (mapping == MAP_FAILED)
+		{
+			const auto message { std::string { std::strerror(errno) } };
+			::close(fd);
+
+			throw std::runtime_error(std::string{
+				"Failed to map file '" + filename + "'. Message: " + message
+			});
+		}
+
+		mapping_      = mapping;
+		mapping_size_ = size;
+		data_         = static_cast<const uint8_t*>(mapping);
+		bytes_        = size;
+	}
+
+	::close(fd); // the mapping remains valid
+
+	return true;
+}
+
+#endif
+
+
+void DBARView::Impl::read_file(const std::string& filename)
+{
+	buffer_ = details::read_dbar_file(filename);
+	data_   = buffer_.data();
+	bytes_  = buffer_.size();
+}
+
+
+void DBARView::Impl::unmap() noexcept
+{
+#if defined(__unix__) || defined(__APPLE__)
+	if (mapping_)
+	{
+		::munmap(mapping_, mapping_size_);
+		mapping_ = nullptr;
+	}
+#endif
+}
+
+
+void DBARView::Impl::index_blocks()
+{
+	using details::BLOCK_HEADER_BYTES;
+	using details::TRIPLET_BYTES;
+
+	auto offset = size_type { 0 };
+
+	while (offset < bytes_)
+	{
+		const auto block_bytes { static_cast<size_type>(
+				BLOCK_HEADER_BYTES + data_[offset] * TRIPLET_BYTES) };
+
+		if (block_bytes > bytes_ - offset)
+		{
+			// Report the error like the stream parser does after reading the
+			// remaining bytes
+
+			throw StreamParseException(static_cast<unsigned>(bytes_),
+					static_cast<unsigned>(block_offsets_.size() + 1),
+					static_cast<unsigned>(bytes_ - offset));
+		}
+
+		block_offsets_.push_back(offset);
+		offset += block_bytes;
+	}
+}
+
+
+const uint8_t* DBARView::Impl::triplet_bytes(const size_type block_idx,
+		const size_type track_idx) const
+{
+	using details::BLOCK_HEADER_BYTES;
+	using details::TRIPLET_BYTES;
+
+	return data_ + block_offsets_[block_idx]
+		+ static_cast<size_type>(BLOCK_HEADER_BYTES)
+		+ track_idx * static_cast<size_type>(TRIPLET_BYTES);
+}
+
+
+DBARView::Impl::size_type DBARView::Impl::size() const noexcept
+{
+	return block_offsets_.size();
+}
+
+
+DBARView::Impl::size_type DBARView::Impl::size(const size_type block_idx)
+	const
+{
+	return this->total_tracks(block_idx);
+}
+
+
+DBARView::Impl::size_type DBARView::Impl::bytes() const noexcept
+{
+	return bytes_;
+}
+
+
+uint32_t DBARView::Impl::arcs_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return details::le_bytes_to_uint32(
+			triplet_bytes(block_idx, track_idx) + 1);
+}
+
+
+unsigned DBARView::Impl::confidence_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return *triplet_bytes(block_idx, track_idx);
+}
+
+
+uint32_t DBARView::Impl::frame450_arcs_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return details::le_bytes_to_uint32(
+			triplet_bytes(block_idx, track_idx) + 5);
+}
+
+
+unsigned DBARView::Impl::total_tracks(const size_type block_idx) const
+{
+	return data_[block_offsets_[block_idx]];
+}
+
+
+DBARBlockHeader DBARView::Impl::header(const size_type block_idx) const
+{
+	const auto h { data_ + block_offsets_[block_idx] };
+
+	return DBARBlockHeader {
+		h[0],
+		details::le_bytes_to_uint32(h + 1),
+		details::le_bytes_to_uint32(h + 5),
+		details::le_bytes_to_uint32(h + 9)
+	};
+}
+
+
+DBARTriplet DBARView::Impl::triplet(const size_type block_idx,
+		const size_type track_idx) const
+{
+	const auto t { triplet_bytes(block_idx, track_idx) };
+
+	return DBARTriplet {
+		details::le_bytes_to_uint32(t + 1),
+		t[0],
+		details::le_bytes_to_uint32(t + 5)
+	};
+}
+
+
+// DBARView
+
+
+DBARView::DBARView(const std::string& filename)
+	: impl_ { std::make_unique<DBARView::Impl>(filename) }
+{
+	// empty
+}
+
+
+DBARView::DBARView(const uint8_t* data, const size_type bytes)
+	: impl_ { std::make_unique<DBARView::Impl>(data, bytes) }
+{
+	// empty
+}
+
+
+DBARView::DBARView(DBARView&& rhs) noexcept = default;
+
+
+DBARView& DBARView::operator= (DBARView&& rhs) noexcept = default;
+
+
+DBARView::~DBARView() noexcept = default;
+
+
+DBARView::size_type DBARView::size() const noexcept
+{
+	return impl_->size();
+}
+
+
+DBARView::size_type DBARView::size(const size_type block_idx) const
+{
+	return impl_->size(block_idx);
+}
+
+
+bool DBARView::empty() const noexcept
+{
+	return this->size() == 0;
+}
+
+
+DBARView::size_type DBARView::bytes() const noexcept
+{
+	return impl_->bytes();
+}
+
+
+uint32_t DBARView::arcs_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return impl_->arcs_value(block_idx, track_idx);
+}
+
+
+unsigned DBARView::confidence_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return impl_->confidence_value(block_idx, track_idx);
+}
+
+
+uint32_t DBARView::frame450_arcs_value(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return impl_->frame450_arcs_value(block_idx, track_idx);
+}
+
+
+unsigned DBARView::total_tracks(const size_type block_idx) const
+{
+	return impl_->total_tracks(block_idx);
+}
+
+
+DBARBlockHeader DBARView::header(const size_type block_idx) const
+{
+	return impl_->header(block_idx);
+}
+
+
+DBARTriplet DBARView::triplet(const size_type block_idx,
+		const size_type track_idx) const
+{
+	return impl_->triplet(block_idx, track_idx);
+}
+
+
+ARId DBARView::id(const size_type block_idx) const
+{
+	return details::get_arid(this->header(block_idx));
+}
+
 } // namespace v_1_0_0
 } // namespace arcstk
 
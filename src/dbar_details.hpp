@@ -17,10 +17,13 @@
 #include "dbar.hpp"            // for DBAR::size_type + ...
 #endif
 
-#include <cstdint>   // for uint32_t, uint8_t
-#include <istream>   // for istream
-#include <string>    // for string
-#include <vector>    // for vector
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, uint8_t
+#include <fstream>      // for ifstream
+#include <functional>   // for function
+#include <istream>      // for istream
+#include <string>       // for string
+#include <vector>       // for vector
 
 namespace arcstk
 {
@@ -34,68 +37,148 @@ namespace details
 {
 
 /**
- * \brief Size of bytes of a dBAR block header
+ * \brief Size in bytes of a single read from an input stream.
+ *
+ * A dBAR file is usually read completely by a single read.
  */
-static constexpr int BLOCK_HEADER_BYTES { 13 };
+static constexpr std::size_t READ_BUFFER_BYTES { 64 * 1024 };
 
 /**
- * \brief Size in bytes of a dBAR triplet
+ * \brief Worker: called by OptionalErrorHandler when a parse error occurrs.
+ *
+ * If \c e is not nullptr, e->on_error() is called. Otherwise, a
+ * StreamParseException with position data is thrown as default behaviour.
+ *
+ * \param[in] byte_pos       Last 1-based global byte pos read before exception
+ * \param[in] block          1-based block number
+ * \param[in] block_byte_pos Last 1-based block byte pos read before exception
+ * \param[in] e              Error handler
+ *
+ * \throws SteamParseException If \c e is \c nullptr or if \c e throws it
  */
-static constexpr int TRIPLET_BYTES { 9 };
+void on_parse_error(const unsigned byte_pos, const unsigned block,
+			const unsigned block_byte_pos, ParseErrorHandler* e);
 
 /**
- * \brief Service method: Interpret 4 bytes as a 32 bit unsigned integer
- * with little endian storage, which means that the bits of b4 become the
- * most significant bits of the result.
+ * \brief Error handler for parse_buffer() that calls on_parse_error().
  *
- * \param[in] b1 First input byte, least significant bits of the result
- * \param[in] b2 Second input byte
- * \param[in] b3 Third input byte
- * \param[in] b4 Fourth input byte, most significant bits of the result
+ * Adapts the optional ParseErrorHandler of the parse functions.
+ */
+class OptionalErrorHandler final
+{
+	/**
+	 * \brief The error handler to call, may be \c nullptr.
+	 */
+	ParseErrorHandler* e_;
+
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] e Error handler, may be \c nullptr
+	 */
+	explicit OptionalErrorHandler(ParseErrorHandler* e);
+
+	/**
+	 * \brief React on error by calling on_parse_error().
+	 *
+	 * \param[in] byte_pos       Last 1-based global byte pos read
+	 * \param[in] block          1-based block number
+	 * \param[in] block_byte_pos Last 1-based block byte pos read
+	 *
+	 * \throws StreamParseException If the error handler is \c nullptr
+	 */
+	void on_error(const unsigned byte_pos, const unsigned block,
+			const unsigned block_byte_pos);
+};
+
+/**
+ * \brief Worker method for parsing a buffer.
+ *
+ * Dispatches the parse events to \c p virtually.
+ *
+ * \param[in] data Pointer to the first byte
+ * \param[in] size Number of bytes
+ * \param[in] p    Parse handler
+ * \param[in] e    Error handler
+ *
+ * \throw StreamParseException If the input is incomplete and \c e is
+ * \c nullptr
  *
- * \return The bytes as 32 bit unsigned integer
+ * \return Number of parsed bytes
  */
-uint32_t le_bytes_to_uint32(const char b1, const char b2, const char b3,
-	const char b4);
+uint32_t parse_dbar_buffer(const uint8_t* data, const std::size_t size,
+		ParseHandler* p, ParseErrorHandler* e);
 
 /**
- * \brief Indicates an invalid ARCS value.
+ * \brief Consumer for the chunks read from an input stream.
+ *
+ * Receives a pointer to the first byte of the chunk and the number of bytes.
+ * The chunk is only valid during the call.
  */
-static constexpr uint32_t UNPARSED_ARCS = 0;
+using ChunkHandler = std::function<void(const uint8_t*, const std::size_t)>;
 
 /**
- * \brief Indicates an invalid confidence value.
+ * \brief Read an input stream in chunks of READ_BUFFER_BYTES.
+ *
+ * Each chunk is passed to \c consume as soon as it is read. A short read is
+ * considered to be the end of the input.
+ *
+ * \param[in] in      The stream to read
+ * \param[in] consume Consumer for each chunk read
  */
-static constexpr unsigned UNPARSED_CONFIDENCE = 0;
+void read_dbar_chunks(std::istream& in, const ChunkHandler& consume);
 
 /**
- * \brief Worker: called by parse_dbar_stream() when a parse error occurrs.
+ * \brief Read an input stream completely.
  *
- * If \c e is not nullptr, e->on_error() is called. Otherwise, a
- * StreamParseException with position data is thrown as default behaviour.
+ * The stream is read by read_dbar_chunks().
  *
- * \param[in] byte_pos       Last 1-based global byte pos read before exception
- * \param[in] block          1-based block number
- * \param[in] block_byte_pos Last 1-based block byte pos read before exception
- * \param[in] e              Error handler
+ * \param[in] in The stream to read
  *
- * \throws SteamParseException If \c e is \c nullptr or if \c e throws it
+ * \return The bytes read
  */
-void on_parse_error(const unsigned byte_pos, const unsigned block,
-			const unsigned block_byte_pos, ParseErrorHandler* e);
+std::vector<uint8_t> read_dbar_stream(std::istream& in);
+
+/**
+ * \brief Open a file for reading binary input.
+ *
+ * \param[in] filename The file to open
+ *
+ * \throws std::runtime_error If the file cannot be opened
+ *
+ * \return The opened file
+ */
+std::ifstream open_dbar_file(const std::string& filename);
+
+/**
+ * \brief Read a file completely.
+ *
+ * \param[in] filename The file to read
+ *
+ * \throws std::runtime_error If the file cannot be opened
+ *
+ * \return The bytes read
+ */
+std::vector<uint8_t> read_dbar_file(const std::string& filename);
 
 /**
  * \brief Worker method for parsing an input stream.
  *
+ * The stream is read by read_dbar_chunks() and each chunk is fed to a
+ * DBARPushParser as soon as it is read. A record that is split between chunks
+ * is completed by the next chunk. Hence, the input is never held completely in
+ * memory.
+ *
  * \param[in] in The stream to be parsed
  * \param[in] p  Parse handler
  * \param[in] e  Error handler
  *
- * \throw StreamReadException If reading of the stream fails
+ * \throw StreamParseException If the input is incomplete and \c e is
+ * \c nullptr
  *
  * \return Number of parsed bytes
- *
- * \todo This implementation silently relies on a little endian plattform.
  */
 uint32_t parse_dbar_stream(std::istream& in, ParseHandler* p,
 		ParseErrorHandler* e);
@@ -103,11 +186,15 @@ uint32_t parse_dbar_stream(std::istream& in, ParseHandler* p,
 /**
  * \brief Worker method for parsing a file.
  *
+ * The file is opened by open_dbar_file() and parsed by parse_dbar_stream().
+ *
  * \param[in] filename The file to be parsed
  * \param[in] p        Parse handler
  * \param[in] e        Error handler
  *
- * \throw StreamReadException If reading of the stream fails
+ * \throws std::runtime_error If the file cannot be opened
+ * \throw StreamParseException If the input is incomplete and \c e is
+ * \c nullptr
  *
  * \return Number of parsed bytes
  */
@@ -159,6 +246,22 @@ class DBAR::Impl final
 	 */
 	std::vector<uint32_t> sums_;  // header ids + arcss + frame450s
 
+	/**
+	 * \brief Start index of each block in \c sums_.
+	 *
+	 * Size equals the total number of blocks. Maintained by add_header() to
+	 * address blocks in constant time.
+	 */
+	std::vector<DBAR::size_type> sums_starts_;
+
+	/**
+	 * \brief Start index of each block in \c confidence_.
+	 *
+	 * Size equals the total number of blocks. Maintained by add_header() to
+	 * address blocks in constant time.
+	 */
+	std::vector<DBAR::size_type> confidence_starts_;
+
 public:
 
 	using size_type      = DBAR::size_type;
@@ -273,6 +376,8 @@ public:
 		swap(lhs.total_tracks_, rhs.total_tracks_);
 		swap(lhs.confidence_,   rhs.confidence_);
 		swap(lhs.sums_,         rhs.sums_);
+		swap(lhs.sums_starts_,       rhs.sums_starts_);
+		swap(lhs.confidence_starts_, rhs.confidence_starts_);
 	}
 
 private:
@@ -287,15 +392,6 @@ private:
 	 */
 	static constexpr unsigned track_size  = 2;
 
-	/**
-	 * \brief Total number of tracks before specified block.
-	 *
-	 * \param[in] block Block index
-	 *
-	 * \return Total number of tracks of the first <tt>block - 1</tt> blocks.
-	 */
-	unsigned total_tracks_accumulated(const size_type block) const;
-
 	/**
 	 * \brief Start index of block \c block_idx in sums_.
 	 *
@@ -341,6 +437,138 @@ private:
 		const size_type track_idx) const;
 };
 
+
+/**
+ * \brief Implementation of a DBARView.
+ */
+class DBARView::Impl final
+{
+	/**
+	 * \brief Start of the memory mapping, \c nullptr if no file is mapped.
+	 */
+	void* mapping_;
+
+	/**
+	 * \brief Number of bytes in the memory mapping.
+	 */
+	std::size_t mapping_size_;
+
+	/**
+	 * \brief Content of a file that is read instead of mapped.
+	 */
+	std::vector<uint8_t> buffer_;
+
+	/**
+	 * \brief First byte of the viewed content.
+	 */
+	const uint8_t* data_;
+
+	/**
+	 * \brief Number of bytes of the viewed content.
+	 */
+	std::size_t bytes_;
+
+	/**
+	 * \brief Byte offset of each block header in \c data_.
+	 */
+	std::vector<DBARView::size_type> block_offsets_;
+
+	/**
+	 * \brief Map a file to memory.
+	 *
+	 * Only defined on platforms that provide memory mapping.
+	 *
+	 * \param[in] filename Name of the file to map
+	 *
+	 * \return \c TRUE iff the file was mapped, \c FALSE if it is not a regular
+	 * file
+	 *
+	 * \throws std::runtime_error If the file cannot be opened or mapped
+	 */
+	bool map_file(const std::string& filename);
+
+	/**
+	 * \brief Read a file into a buffer owned by the instance.
+	 *
+	 * \param[in] filename Name of the file to read
+	 *
+	 * \throws std::runtime_error If the file cannot be opened or read
+	 */
+	void read_file(const std::string& filename);
+
+	/**
+	 * \brief Unmap the file if mapped.
+	 */
+	void unmap() noexcept;
+
+	/**
+	 * \brief Record the offset of each block.
+	 *
+	 * \throws StreamParseException If the last block is incomplete
+	 */
+	void index_blocks();
+
+	/**
+	 * \brief First byte of the specified triplet.
+	 *
+	 * \param[in] block_idx Block index
+	 * \param[in] track_idx Track index
+	 *
+	 * \return Pointer to the confidence byte of the specified triplet
+	 */
+	const uint8_t* triplet_bytes(const DBARView::size_type block_idx,
+			const DBARView::size_type track_idx) const;
+
+public:
+
+	using size_type = DBARView::size_type;
+
+	/**
+	 * \brief Constructor for a view on a file.
+	 *
+	 * \param[in] filename Name of the file to map
+	 */
+	explicit Impl(const std::string& filename);
+
+	/**
+	 * \brief Constructor for a view on a buffer.
+	 *
+	 * \param[in] data  Pointer to the first byte
+	 * \param[in] bytes Number of bytes
+	 */
+	Impl(const uint8_t* data, const size_type bytes);
+
+	Impl(const Impl& rhs) = delete;
+	Impl& operator= (const Impl& rhs) = delete;
+
+	/**
+	 * \brief Destructor, unmaps the file if mapped.
+	 */
+	~Impl() noexcept;
+
+	size_type size() const noexcept;
+
+	size_type size(const size_type block_idx) const;
+
+	size_type bytes() const noexcept;
+
+	uint32_t arcs_value(const size_type block_idx, const size_type track_idx)
+		const;
+
+	unsigned confidence_value(const size_type block_idx,
+			const size_type track_idx) const;
+
+	uint32_t frame450_arcs_value(const size_type block_idx,
+			const size_type track_idx) const;
+
+	unsigned total_tracks(const size_type block_idx) const;
+
+	DBARBlockHeader header(const size_type block_idx) const;
+
+	DBARTriplet triplet(const size_type block_idx, const size_type track_idx)
+		const;
+};
+
 } // namespace v_1_0_0
 } // namespace arcstk
 
@@ -0,0 +1,314 @@
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation of the calculation pipeline
+ */
+
+#ifndef __LIBARCSTK_PIPELINE_HPP__
+#include "pipeline.hpp"
+#endif
+#ifndef __LIBARCSTK_PIPELINE_DETAILS_HPP__
+#include "pipeline_details.hpp"
+#endif
+
+#ifndef __LIBARCSTK_LOGGING_HPP__
+#include "logging.hpp"
+#endif
+
+#include <exception>      // for current_exception, rethrow_exception
+#include <stdexcept>      // for invalid_argument, logic_error, out_of_range
+#include <string>         // for to_string
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+namespace details
+{
+namespace pipeline
+{
+
+// BlockRing
+
+
+BlockRing::BlockRing(const std::size_t block_size,
+		const std::size_t total_blocks)
+	: blocks_ {}
+	, head_   { 0 }
+	, tail_   { 0 }
+{
+	if (block_size == 0 || total_blocks == 0)
+	{
+		throw std::invalid_argument("Size and number of blocks must not be 0");
+	}
+
+	blocks_.resize(total_blocks);
+
+	for (auto& block : blocks_)
+	{
+		block.samples.resize(block_size);
+	}
+}
+
+
+Block* BlockRing::try_tail() noexcept
+{
+	const auto tail { tail_.load(std::memory_order_relaxed) };
+
+	// Acquire the release of the block by the consumer
+	if (tail - head_.load(std::memory_order_acquire) == blocks_.size())
+	{
+		return nullptr;
+	}
+
+	return &blocks_[tail % blocks_.size()];
+}
+
+
+void BlockRing::push() noexcept
+{
+	tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+			std::memory_order_release);
+}
+
+
+Block* BlockRing::try_head() noexcept
+{
+	const auto head { head_.load(std::memory_order_relaxed) };
+
+	// Acquire the publication of the block by the producer
+	if (head == tail_.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+
+	return &blocks_[head % blocks_.size()];
+}
+
+
+void BlockRing::pop() noexcept
+{
+	head_.store(head_.load(std::memory_order_relaxed) + 1,
+			std::memory_order_release);
+}
+
+
+std::size_t BlockRing::capacity() const noexcept
+{
+	return blocks_.size();
+}
+
+
+std::size_t BlockRing::block_size() const noexcept
+{
+	return blocks_.front().samples.size();
+}
+
+} // namespace pipeline
+} // namespace details
+
+
+// CalculationPipeline::Impl
+
+
+CalculationPipeline::Impl::Impl(Calculation& calculation,
+		const std::size_t block_size, const std::size_t total_blocks)
+	: calculation_ { calculation }
+	, ring_        { block_size, total_blocks }
+	, acquired_    { nullptr }
+	, closed_      { false }
+	, failed_      { false }
+	, error_       { nullptr }
+	, consumer_    {}
+{
+	consumer_ = std::thread(&Impl::consume, this);
+}
+
+
+CalculationPipeline::Impl::~Impl() noexcept
+{
+	this->stop();
+}
+
+
+sample_t* CalculationPipeline::Impl::acquire()
+{
+	if (closed_.load(std::memory_order_relaxed))
+	{
+		throw std::logic_error("Cannot acquire a block, pipeline is closed");
+	}
+
+	if (!acquired_)
+	{
+		details::pipeline::wait_until([this]
+		{
+			return failed_.load(std::memory_order_acquire)
+				|| (acquired_ = ring_.try_tail()) != nullptr;
+		});
+
+		this->rethrow_error();
+	}
+
+	return acquired_->samples.data();
+}
+
+
+void CalculationPipeline::Impl::commit(const std::size_t size)
+{
+	if (!acquired_)
+	{
+		throw std::logic_error("Cannot commit, no block is acquired");
+	}
+
+	if (size > ring_.block_size())
+	{
+		throw std::out_of_range("Cannot commit " + std::to_string(size)
+				+ " samples, block size is " + std::to_string(ring_.block_size()));
+	}
+
+	acquired_->size = size;
+	acquired_ = nullptr;
+
+	ring_.push();
+}
+
+
+void CalculationPipeline::Impl::close()
+{
+	if (!consumer_.joinable())
+	{
+		return;
+	}
+
+	this->stop();
+	this->rethrow_error();
+}
+
+
+std::size_t CalculationPipeline::Impl::block_size() const noexcept
+{
+	return ring_.block_size();
+}
+
+
+std::size_t CalculationPipeline::Impl::total_blocks() const noexcept
+{
+	return ring_.capacity();
+}
+
+
+void CalculationPipeline::Impl::consume() noexcept
+{
+	auto block = static_cast<details::pipeline::Block*>(nullptr);
+
+	while (true)
+	{
+		details::pipeline::wait_until([this,&block]
+		{
+			return (block = ring_.try_head()) != nullptr
+				|| closed_.load(std::memory_order_acquire);
+		});
+
+		if (!block)
+		{
+			// Closed, but the last block may have been published right before
+			block = ring_.try_head();
+
+			if (!block)
+			{
+				return;
+			}
+		}
+
+		// After a failure, the remaining blocks are skipped
+		if (!failed_.load(std::memory_order_relaxed))
+		{
+			try
+			{
+				calculation_.update(block->samples.data(),
+						block->samples.data() + block->size);
+
+			} catch (...)
+			{
+				error_ = std::current_exception();
+				failed_.store(true, std::memory_order_release);
+			}
+		}
+
+		ring_.pop();
+	}
+}
+
+
+void CalculationPipeline::Impl::stop() noexcept
+{
+	if (!consumer_.joinable())
+	{
+		return;
+	}
+
+	closed_.store(true, std::memory_order_release);
+
+	consumer_.join();
+
+	ARCS_LOG_DEBUG << "Calculation pipeline closed";
+}
+
+
+void CalculationPipeline::Impl::rethrow_error()
+{
+	if (failed_.load(std::memory_order_acquire))
+	{
+		std::rethrow_exception(error_);
+	}
+}
+
+
+// CalculationPipeline
+
+
+CalculationPipeline::CalculationPipeline(Calculation& calculation,
+		const std::size_t block_size, const std::size_t total_blocks)
+	: impl_ { std::make_unique<Impl>(calculation, block_size, total_blocks) }
+{
+	// empty
+}
+
+
+CalculationPipeline::~CalculationPipeline() noexcept = default;
+
+
+sample_t* CalculationPipeline::acquire()
+{
+	return impl_->acquire();
+}
+
+
+void CalculationPipeline::commit(const std::size_t size)
+{
+	impl_->commit(size);
+}
+
+
+void CalculationPipeline::close()
+{
+	impl_->close();
+}
+
+
+std::size_t CalculationPipeline::block_size() const noexcept
+{
+	return impl_->block_size();
+}
+
+
+std::size_t CalculationPipeline::total_blocks() const noexcept
+{
+	return impl_->total_blocks();
+}
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
@@ -0,0 +1,315 @@
+#ifndef __LIBARCSTK_PIPELINE_HPP__
+#error "Do not include pipeline_details.hpp, include pipeline.hpp instead"
+#endif
+
+#ifndef __LIBARCSTK_PIPELINE_DETAILS_HPP__
+#define __LIBARCSTK_PIPELINE_DETAILS_HPP__
+
+/**
+ * \internal
+ *
+ * \file
+ *
+ * \brief Implementation details for pipeline.hpp.
+ */
+
+#include <atomic>         // for atomic
+#include <chrono>         // for microseconds
+#include <cstddef>        // for size_t
+#include <exception>      // for exception_ptr
+#include <thread>         // for thread, sleep_for, yield
+#include <vector>         // for vector
+
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"  // for Calculation, sample_t
+#endif
+
+namespace arcstk
+{
+inline namespace v_1_0_0
+{
+namespace details
+{
+namespace pipeline
+{
+
+/**
+ * \internal
+ *
+ * \brief Assumed size of a cache line.
+ *
+ * The indices of the producer and the consumer are placed on different cache
+ * lines to avoid false sharing.
+ */
+constexpr std::size_t CACHE_LINE_SIZE { 64 };
+
+/**
+ * \internal
+ *
+ * \brief Number of polls before a waiting thread yields.
+ */
+constexpr int SPINS_BEFORE_YIELD { 64 };
+
+/**
+ * \internal
+ *
+ * \brief Number of polls before a waiting thread sleeps.
+ */
+constexpr int SPINS_BEFORE_SLEEP { 128 };
+
+/**
+ * \internal
+ *
+ * \brief Duration a waiting thread sleeps between polls.
+ *
+ * Waiting for longer means that the other thread is much slower, hence the
+ * waiting thread does not need to react immediately.
+ */
+constexpr std::chrono::microseconds SLEEP_DURATION { 50 };
+
+/**
+ * \internal
+ *
+ * \brief A reusable block of samples.
+ */
+struct Block final
+{
+	/**
+	 * \brief Samples of the block.
+	 */
+	std::vector<sample_t> samples {};
+
+	/**
+	 * \brief Number of valid samples.
+	 */
+	std::size_t size { 0 };
+};
+
+/**
+ * \internal
+ *
+ * \brief Lock-free ring of blocks for a single producer and a single consumer.
+ *
+ * The producer fills the block at the tail and publishes it by advancing the
+ * tail. The consumer processes the block at the head and releases it by
+ * advancing the head. Both indices are increased monotonically, the block of
+ * index \c i is <tt>i % capacity()</tt>. The ring is full iff
+ * <tt>tail - head == capacity()</tt> and empty iff <tt>tail == head</tt>.
+ *
+ * Only the producer writes the tail and only the consumer writes the head.
+ * Hence, synchronizing the access to the blocks requires no locks.
+ */
+class BlockRing final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] block_size   Capacity of each block in samples
+	 * \param[in] total_blocks Number of blocks
+	 */
+	BlockRing(const std::size_t block_size, const std::size_t total_blocks);
+
+	/**
+	 * \brief Producer: the block at the tail if it is free.
+	 *
+	 * \return Free block or \c nullptr if the ring is full
+	 */
+	Block* try_tail() noexcept;
+
+	/**
+	 * \brief Producer: publish the block at the tail.
+	 */
+	void push() noexcept;
+
+	/**
+	 * \brief Consumer: the block at the head if it is published.
+	 *
+	 * \return Published block or \c nullptr if the ring is empty
+	 */
+	Block* try_head() noexcept;
+
+	/**
+	 * \brief Consumer: release the block at the head.
+	 */
+	void pop() noexcept;
+
+	/**
+	 * \brief Number of blocks.
+	 *
+	 * \return Number of blocks
+	 */
+	std::size_t capacity() const noexcept;
+
+	/**
+	 * \brief Capacity of each block in samples.
+	 *
+	 * \return Capacity of each block
+	 */
+	std::size_t block_size() const noexcept;
+
+private:
+
+	/**
+	 * \brief The blocks.
+	 */
+	std::vector<Block> blocks_;
+
+	/**
+	 * \brief Index of the next block to consume, written by the consumer.
+	 */
+	alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_;
+
+	/**
+	 * \brief Index of the next block to produce, written by the producer.
+	 */
+	alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_;
+};
+
+/**
+ * \internal
+ *
+ * \brief Wait until a condition is met by polling it.
+ *
+ * Polls the condition in a busy loop at first. If the condition is not met
+ * quickly, the thread yields between the polls and finally sleeps for
+ * SLEEP_DURATION between the polls.
+ *
+ * \param[in] condition Condition to wait for
+ */
+template <typename Condition>
+void wait_until(Condition&& condition)
+{
+	auto spins = int { 0 };
+
+	while (!condition())
+	{
+		if (spins < SPINS_BEFORE_YIELD)
+		{
+			++spins;
+		} else if (spins < SPINS_BEFORE_SLEEP)
+		{
+			++spins;
+			std::this_thread::yield();
+		} else
+		{
+			std::this_thread::sleep_for(SLEEP_DURATION);
+		}
+	}
+}
+
+} // namespace pipeline
+} // namespace details
+
+
+/**
+ * \internal
+ *
+ * \brief Private implementation of CalculationPipeline.
+ */
+class CalculationPipeline::Impl final
+{
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param[in] calculation  Calculation to update
+	 * \param[in] block_size   Capacity of each block in samples
+	 * \param[in] total_blocks Number of blocks in the ring
+	 */
+	Impl(Calculation& calculation, const std::size_t block_size,
+			const std::size_t total_blocks);
+
+	Impl(const Impl& rhs) = delete;
+	Impl& operator=(const Impl& rhs) = delete;
+
+	/**
+	 * \brief Destructor.
+	 */
+	~Impl() noexcept;
+
+	/**
+	 * \brief Implements CalculationPipeline::acquire().
+	 */
+	sample_t* acquire();
+
+	/**
+	 * \brief Implements CalculationPipeline::commit().
+	 */
+	void commit(const std::size_t size);
+
+	/**
+	 * \brief Implements CalculationPipeline::close().
+	 */
+	void close();
+
+	/**
+	 * \brief Implements CalculationPipeline::block_size().
+	 */
+	std::size_t block_size() const noexcept;
+
+	/**
+	 * \brief Implements CalculationPipeline::total_blocks().
+	 */
+	std::size_t total_blocks() const noexcept;
+
+private:
+
+	/**
+	 * \brief Main loop of the consumer thread.
+	 */
+	void consume() noexcept;
+
+	/**
+	 * \brief Stop the consumer thread after all blocks are processed.
+	 */
+	void stop() noexcept;
+
+	/**
+	 * \brief Rethrow the error of the consumer, if any.
+	 */
+	void rethrow_error();
+
+	/**
+	 * \brief Calculation to update.
+	 */
+	Calculation& calculation_;
+
+	/**
+	 * \brief Ring of blocks.
+	 */
+	details::pipeline::BlockRing ring_;
+
+	/**
+	 * \brief Block acquired by the producer, if any.
+	 */
+	details::pipeline::Block* acquired_;
+
+	/**
+	 * \brief TRUE iff the producer has committed its last block.
+	 */
+	std::atomic<bool> closed_;
+
+	/**
+	 * \brief TRUE iff the consumer has failed.
+	 */
+	std::atomic<bool> failed_;
+
+	/**
+	 * \brief Error of the consumer, valid iff failed_ is TRUE.
+	 */
+	std::exception_ptr error_;
+
+	/**
+	 * \brief Consumer thread.
+	 */
+	std::thread consumer_;
+};
+
+} // namespace v_1_0_0
+} // namespace arcstk
+
+#endif
+
@@ -6,16 +6,333 @@
  * \brief Instantiations of SampleSequence and SampleIterator
  */
 
+#include <cstddef>       // for size_t
 #include <cstdint>
 
 #ifndef __LIBARCSTK_SAMPLES_HPP__
 #include "samples.hpp"
 #endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>   // for SSE4.1 intrinsics
+#endif
+
 namespace arcstk
 {
 inline namespace v_1_0_0
 {
+namespace details
+{
+
+namespace
+{
+
+/**
+ * \brief Scalar kernel for combine_planar().
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ */
+template <typename U>
+void combine_planar_scalar(const U* lower, const U* higher,
+		const std::size_t n, sample_type* dest)
+{
+	for (auto i = std::size_t { 0 }; i < n; ++i)
+	{
+		dest[i] = (static_cast<sample_type>(higher[i]) << 16)
+			| (static_cast<sample_type>(lower[i]) & 0x0000FFFF);
+	}
+}
+
+
+/**
+ * \brief Scalar kernel for combine_interleaved().
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ */
+template <typename U>
+void combine_interleaved_scalar(const U* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest)
+{
+	const auto left  { left0_right1 ? 0u : 1u };
+	const auto right { left0_right1 ? 1u : 0u };
+
+	for (auto i = std::size_t { 0 }; i < n; ++i)
+	{
+		dest[i] = (static_cast<sample_type>(buffer[2 * i + right]) << 16)
+			| (static_cast<sample_type>(buffer[2 * i + left]) & 0x0000FFFF);
+	}
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+// TODO C-style stuff: The vectorized kernels are only expressible by the
+// compiler intrinsics. They are compiled for their own target and are only
+// called if the CPU supports SSE4.1. Each kernel converts full vectors and
+// leaves the remainder to the scalar kernel. The conversion is bound by memory
+// bandwidth, hence wider vectors would not gain notably.
+
+
+/**
+ * \brief TRUE iff the CPU supports SSE4.1.
+ *
+ * \return TRUE iff the vectorized kernels can be used
+ */
+bool use_sse41() noexcept
+{
+	static const auto supported { []
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse4.1") != 0;
+	}() };
+
+	return supported;
+}
+
+
+/**
+ * \brief Kernel for combine_planar() on 16 bit samples using SSE4.1.
+ *
+ * Interleaves 8 samples of each channel per step.
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ *
+ * \return Number of samples combined
+ */
+__attribute__((target("sse4.1")))
+std::size_t combine_planar_sse41(const uint16_t* lower, const uint16_t* higher,
+		const std::size_t n, sample_type* dest)
+{
+	auto i { std::size_t { 0 } };
+
+	for (; i + 8 <= n; i += 8)
+	{
+		const auto l { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(lower + i)) };
+		const auto h { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(higher + i)) };
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+				_mm_unpacklo_epi16(l, h));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 4),
+				_mm_unpackhi_epi16(l, h));
+	}
+
+	return i;
+}
+
+
+/**
+ * \brief Kernel for combine_planar() on 32 bit samples using SSE4.1.
+ *
+ * Blends 4 samples of each channel per step.
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ *
+ * \return Number of samples combined
+ */
+__attribute__((target("sse4.1")))
+std::size_t combine_planar_sse41(const uint32_t* lower, const uint32_t* higher,
+		const std::size_t n, sample_type* dest)
+{
+	auto i { std::size_t { 0 } };
+
+	for (; i + 4 <= n; i += 4)
+	{
+		const auto l { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(lower + i)) };
+		const auto h { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(higher + i)) };
+
+		// Odd 16 bit words from the shifted higher channel
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+				_mm_blend_epi16(l, _mm_slli_epi32(h, 16), 0xAA));
+	}
+
+	return i;
+}
+
+
+/**
+ * \brief Kernel for combine_interleaved() on 16 bit samples using SSE4.1.
+ *
+ * On little endian platforms, a pair of interleaved 16 bit samples in
+ * LEFT/RIGHT order already is the PCM 32 bit sample. For the swapped
+ * order the halves of each pair are rotated. Processes 4 samples per step.
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ *
+ * \return Number of samples combined
+ */
+__attribute__((target("sse4.1")))
+std::size_t combine_interleaved_sse41(const uint16_t* buffer,
+		const std::size_t n, const bool left0_right1, sample_type* dest)
+{
+	auto i { std::size_t { 0 } };
+
+	for (; i + 4 <= n; i += 4)
+	{
+		auto v { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(buffer + 2 * i)) };
+
+		if (!left0_right1)
+		{
+			v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), v);
+	}
+
+	return i;
+}
+
+
+/**
+ * \brief Kernel for combine_interleaved() on 32 bit samples using SSE4.1.
+ *
+ * Shuffles the lower 16 bits of each input sample to their place in the
+ * PCM 32 bit sample. Processes 4 samples per step.
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ *
+ * \return Number of samples combined
+ */
+__attribute__((target("sse4.1")))
+std::size_t combine_interleaved_sse41(const uint32_t* buffer,
+		const std::size_t n, const bool left0_right1, sample_type* dest)
+{
+	// Bytes of the lower 16 bits of each channel, unused bytes are zeroed
+	const auto mask { left0_right1
+		? _mm_setr_epi8(0, 1, 4, 5,  8,  9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)
+		: _mm_setr_epi8(4, 5, 0, 1, 12, 13,  8,  9, -1, -1, -1, -1, -1, -1, -1, -1)
+	};
+
+	auto i { std::size_t { 0 } };
+
+	for (; i + 4 <= n; i += 4)
+	{
+		const auto a { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(buffer + 2 * i)) };
+		const auto b { _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(buffer + 2 * i + 4)) };
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+				_mm_unpacklo_epi64(_mm_shuffle_epi8(a, mask),
+					_mm_shuffle_epi8(b, mask)));
+	}
+
+	return i;
+}
+
+
+/**
+ * \brief Combine planar samples by the best available kernel.
+ *
+ * \param[in] lower  Samples of the channel for the lower 16 bits
+ * \param[in] higher Samples of the channel for the higher 16 bits
+ * \param[in] n      Number of samples to combine
+ * \param[in] dest   Buffer for at least \c n PCM 32 bit samples
+ */
+template <typename U>
+void combine_planar_impl(const U* lower, const U* higher, const std::size_t n,
+		sample_type* dest)
+{
+	const auto done { use_sse41()
+		? combine_planar_sse41(lower, higher, n, dest)
+		: std::size_t { 0 } };
+
+	combine_planar_scalar(lower + done, higher + done, n - done, dest + done);
+}
+
+
+/**
+ * \brief Combine interleaved samples by the best available kernel.
+ *
+ * \param[in] buffer       Interleaved samples, \c 2 * \c n in total
+ * \param[in] n            Number of samples to combine
+ * \param[in] left0_right1 Channel ordering
+ * \param[in] dest         Buffer for at least \c n PCM 32 bit samples
+ */
+template <typename U>
+void combine_interleaved_impl(const U* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest)
+{
+	const auto done { use_sse41()
+		? combine_interleaved_sse41(buffer, n, left0_right1, dest)
+		: std::size_t { 0 } };
+
+	combine_interleaved_scalar(buffer + 2 * done, n - done, left0_right1,
+			dest + done);
+}
+
+#else // no vectorized kernels available for this platform
+
+template <typename U>
+void combine_planar_impl(const U* lower, const U* higher, const std::size_t n,
+		sample_type* dest)
+{
+	combine_planar_scalar(lower, higher, n, dest);
+}
+
+
+template <typename U>
+void combine_interleaved_impl(const U* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest)
+{
+	combine_interleaved_scalar(buffer, n, left0_right1, dest);
+}
+
+#endif
+
+} // namespace
+
+
+void combine_planar(const uint16_t* lower, const uint16_t* higher,
+		const std::size_t n, sample_type* dest)
+{
+	combine_planar_impl(lower, higher, n, dest);
+}
+
+
+void combine_planar(const uint32_t* lower, const uint32_t* higher,
+		const std::size_t n, sample_type* dest)
+{
+	combine_planar_impl(lower, higher, n, dest);
+}
+
+
+void combine_interleaved(const uint16_t* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest)
+{
+	combine_interleaved_impl(buffer, n, left0_right1, dest);
+}
+
+
+void combine_interleaved(const uint32_t* buffer, const std::size_t n,
+		const bool left0_right1, sample_type* dest)
+{
+	combine_interleaved_impl(buffer, n, left0_right1, dest);
+}
+
+} // namespace details
+
 
 // Instantiate all legal SampleSequence cases to ensure they are compiled.
 // This avoids compilation on the client side.
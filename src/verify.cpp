@@ -13,11 +13,17 @@
 #include "verify_details.hpp"
 #endif
 
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"                 // for ARCSFrame450Base
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"                  // for Calculation
+#endif
 #ifndef __LIBARCSTK_CHECKSUM_HPP__
 #include "checksum.hpp"                   // for Checksums
 #endif
 #ifndef __LIBARCSTK_DBAR_HPP__
-#include "dbar.hpp"                       // for DBAR
+#include "dbar.hpp"                       // for DBAR, DBARView
 #endif
 #ifndef __LIBARCSTK_IDENTIFIER_HPP__
 #include "identifier.hpp"                 // for ARId
@@ -25,15 +31,18 @@
 #ifndef __LIBARCSTK_LOGGING_HPP__
 #include "logging.hpp"
 #endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"                   // for CDDA
+#endif
 
 #include <cstdint>        // for uint32_t
 #include <exception>      // for exception
 #include <iomanip>        // for setw, setfill
 #include <sstream>        // for ostringstream
 #include <stdexcept>      // for runtime_error
-#include <string>         // for string
+#include <string>         // for string, to_string
 #include <tuple>          // for tuple
-#include <utility>        // for move
+#include <utility>        // for move, pair
 #include <vector>         // for vector
 
 namespace arcstk
@@ -902,6 +911,12 @@ void MatchPolicy::perform_match(VerificationResult& result,
 {
 	for (const auto& type : actual.types())
 	{
+		if (type != arcstk::checksum::type::ARCS1
+				&& type != arcstk::checksum::type::ARCS2)
+		{
+			continue; // references are track ARCSs
+		}
+
 		const bool is_v2 = (type == arcstk::checksum::type::ARCS2);
 
 		if (ref == actual.get(type))
@@ -1136,7 +1151,7 @@ const uint32_t& ChecksumSource::frame450_arcs_value(
 		const ChecksumSource::size_type block_idx,
 		const ChecksumSource::size_type idx) const
 {
-	return this->do_arcs_value(block_idx, idx);
+	return this->do_frame450_arcs_value(block_idx, idx);
 }
 
 std::size_t ChecksumSource::size(const ChecksumSource::size_type block_idx)
@@ -1216,6 +1231,81 @@ std::unique_ptr<ChecksumSource> DBARSource::do_clone() const
 }
 
 
+// DBARViewSource
+
+
+DBARViewSource::DBARViewSource(const DBARView* view)
+	: ChecksumSourceOf { view }
+	, arcs_          { /* empty */ }
+	, confidence_    { /* empty */ }
+	, frame450_arcs_ { /* empty */ }
+{
+	// empty
+}
+
+
+ARId DBARViewSource::do_id(const ChecksumSource::size_type block_idx) const
+{
+	return source()->id(block_idx);
+}
+
+
+Checksum DBARViewSource::do_checksum(
+		const ChecksumSource::size_type block_idx,
+		const ChecksumSource::size_type idx) const
+{
+	return source()->arcs_value(block_idx, idx);
+}
+
+
+const uint32_t& DBARViewSource::do_arcs_value(
+		const ChecksumSource::size_type block,
+		const ChecksumSource::size_type track) const
+{
+	// A map does not move its values, hence the reference remains valid
+
+	return arcs_.emplace(Position { block, track },
+			source()->arcs_value(block, track)).first->second;
+}
+
+
+const unsigned& DBARViewSource::do_confidence(
+		const ChecksumSource::size_type block,
+		const ChecksumSource::size_type track) const
+{
+	return confidence_.emplace(Position { block, track },
+			source()->confidence_value(block, track)).first->second;
+}
+
+
+const uint32_t& DBARViewSource::do_frame450_arcs_value(
+		const ChecksumSource::size_type block,
+		const ChecksumSource::size_type track) const
+{
+	return frame450_arcs_.emplace(Position { block, track },
+			source()->frame450_arcs_value(block, track)).first->second;
+}
+
+
+std::size_t DBARViewSource::do_size(const ChecksumSource::size_type block_idx)
+	const
+{
+	return source()->size(block_idx);
+}
+
+
+std::size_t DBARViewSource::do_size() const
+{
+	return source()->size();
+}
+
+
+std::unique_ptr<ChecksumSource> DBARViewSource::do_clone() const
+{
+	return std::make_unique<DBARViewSource>(*this);
+}
+
+
 // VerificationResult
 
 
@@ -1578,6 +1668,142 @@ std::unique_ptr<Verifier> TracksetVerifier::do_clone() const
 }
 
 
+// OffsetDetector
+
+
+OffsetDetector::OffsetDetector(const ChecksumSource& refs)
+	: index_ {}
+{
+	for (auto b = size_type { 0 }; b < refs.size(); ++b)
+	{
+		for (auto t = size_type { 0 }; t < refs.size(b); ++t)
+		{
+			const auto value { refs.frame450_arcs_value(b, t) };
+
+			if (value != 0)
+			{
+				index_.emplace(value, std::make_pair(b, t));
+			}
+		}
+	}
+
+	ARCS_LOG(DEBUG1) << "Indexed " << index_.size()
+		<< " reference values of frame 450";
+}
+
+
+OffsetDetector::size_type OffsetDetector::size() const noexcept
+{
+	return index_.size();
+}
+
+
+std::vector<std::pair<OffsetDetector::size_type, OffsetDetector::size_type>>
+	OffsetDetector::lookup(const uint32_t value) const
+{
+	const auto range { index_.equal_range(value) };
+
+	auto matches { std::vector<std::pair<size_type, size_type>>{} };
+
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		matches.push_back(it->second);
+	}
+
+	return matches;
+}
+
+
+std::vector<OffsetMatch> OffsetDetector::detect(const sample_t* start,
+		const sample_t* stop, const int32_t max_offset) const
+{
+	constexpr auto frame_size { CDDA::SAMPLES_PER_FRAME };
+
+	if (max_offset < 0 || stop - start != frame_size + 2 * max_offset)
+	{
+		throw std::invalid_argument("Window of " + std::to_string(stop - start)
+				+ " samples does not match maximal offset "
+				+ std::to_string(max_offset));
+	}
+
+	auto matches { std::vector<OffsetMatch>{} };
+
+	// ARCS and plain sum of the frame for the smallest offset
+
+	auto arcs { uint32_t { 0 } };
+	auto sum  { uint32_t { 0 } };
+	auto multiplier { uint32_t { 1 } };
+
+	for (auto pos = start; pos != start + frame_size; ++pos, ++multiplier)
+	{
+		arcs += multiplier * *pos;
+		sum  += *pos;
+	}
+
+	for (auto offset = -max_offset; offset <= max_offset; ++offset)
+	{
+		if (arcs != 0)
+		{
+			const auto range { index_.equal_range(arcs) };
+
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				matches.push_back({ offset, it->second.first,
+						it->second.second });
+			}
+		}
+
+		if (offset == max_offset)
+		{
+			break;
+		}
+
+		// Shift frame by one sample: every multiplier decreases by 1, the
+		// first sample drops out and the next sample gets multiplier 588
+
+		const auto first { *start };
+		const auto next  { *(start + frame_size) };
+
+		arcs = arcs - sum + static_cast<uint32_t>(frame_size) * next;
+		sum  = sum - first + next;
+
+		++start;
+	}
+
+	ARCS_LOG(DEBUG1) << "Found " << matches.size() << " match(es) for "
+		<< 2 * max_offset + 1 << " offsets";
+
+	return matches;
+}
+
+
+std::vector<OffsetMatch> OffsetDetector::detect(const Calculation& calculation,
+		const int track) const
+{
+	using accuraterip::details::ARCSFrame450Base;
+
+	const auto algorithm {
+		dynamic_cast<const ARCSFrame450Base*>(calculation.algorithm()) };
+
+	if (!algorithm)
+	{
+		throw std::invalid_argument("Algorithm of the calculation does not "
+				"retain the samples around frame 450");
+	}
+
+	const auto window { algorithm->frame450_window(track) };
+
+	if (window.empty())
+	{
+		throw std::invalid_argument("No samples around frame 450 retained "
+				"for track " + std::to_string(track));
+	}
+
+	return this->detect(window.data(), window.data() + window.size(),
+			algorithm->max_offset());
+}
+
+
 } // namespace v_1_0_0
 } // namespace arcstk
 
@@ -23,7 +23,11 @@
 #include "metadata.hpp"           // for AudioSize
 #endif
 
+#include <algorithm>              // for equal, min
+#include <cstdint>                // for int32_t, uint32_t
 #include <fstream>                // for ifstream
+#include <memory>                 // for make_unique
+#include <stdexcept>              // for invalid_argument
 #include <unordered_set>          // for unordered_set
 #include <vector>                 // for vector
 
@@ -298,6 +302,48 @@ TEST_CASE ( "Updating ARCS v1+v2", "[arcsalgorithm] [calc]" )
 	}
 
 
+	SECTION ( "Updating ARCS v1+2 singletrack by contiguous buffer is correct" )
+	{
+		auto algo = Details::Versions1and2{};
+
+		// Read entire file at once: 196608 samples
+
+		std::vector<sample_t> buffer(196608); // samples
+
+		std::ifstream in;
+		in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+		try
+		{
+			in.open("calculation-test-01.bin",
+					std::ifstream::in | std::ifstream::binary);
+
+			in.read(reinterpret_cast<char*>(&buffer[0]), 786432);
+			// 786432 bytes == 196608 samples
+
+		} catch (const std::ifstream::failure& f)
+		{
+			FAIL ("Could not read test data file calculation-test-01.bin");
+		}
+
+		in.close();
+
+		// Update in two non-aligned portions from raw pointers
+
+		const sample_t* const data { buffer.data() };
+
+		algo.update(data,          data + 100003);
+		algo.update(data + 100003, data + buffer.size());
+		algo.track_finished(1, AudioSize{});
+
+		auto checksums { algo.result() };
+
+		CHECK ( checksums.size() == 2 /* types */ );
+		CHECK ( 0xD15BB487 == (checksums.get(type::ARCS2)) );
+		CHECK ( 0x8FE8D29B == (checksums.get(type::ARCS1)) );
+	}
+
+
 	SECTION ( "Updating ARCS v1+2 singletrack & non-aligned blocks is correct" )
 	{
 		auto state = Details::AccurateRipCS<type::ARCS1,type::ARCS2>{};
@@ -377,6 +423,302 @@ TEST_CASE ( "Updating ARCS v1+v2", "[arcsalgorithm] [calc]" )
 }
 
 
+TEST_CASE ( "ARCSFrame450Algorithm", "[arcsalgorithm] [calc]" )
+{
+	using arcstk::AudioSize;
+	using arcstk::Calculation;
+	using arcstk::Context;
+	using arcstk::Points;
+	using arcstk::UNIT;
+	using arcstk::checksum::type;
+	using arcstk::sample_t;
+	using arcstk::accuraterip::details::Versions1and2;
+	using arcstk::accuraterip::details::Versions1and2withFrame450;
+
+	const auto size   { AudioSize { 2000, UNIT::FRAMES } };
+	const auto points { Points {
+		AudioSize {   20, UNIT::FRAMES },
+		AudioSize {  700, UNIT::FRAMES },
+		AudioSize { 1300, UNIT::FRAMES }
+	}};
+
+	auto samples = std::vector<sample_t>(
+			static_cast<std::size_t>(size.samples()));
+
+	auto x { uint32_t { 7 } };
+	for (auto& s : samples)
+	{
+		x = x * 1664525u + 1013904223u;
+		s = x;
+	}
+
+	// Expected ARCS of frame 450 of each track
+	auto expected = std::vector<uint32_t>{};
+	for (const auto& p : points)
+	{
+		const auto first { static_cast<std::size_t>(p.samples() + 450 * 588) };
+
+		auto arcs { uint32_t { 0 } };
+		for (auto i = std::size_t { 0 }; i < 588; ++i)
+		{
+			arcs += static_cast<uint32_t>(i + 1) * samples[first + i];
+		}
+
+		expected.push_back(arcs);
+	}
+
+	auto reference { Calculation(Context::ALBUM,
+			std::make_unique<Versions1and2>(), size, points) };
+
+	auto calculation { Calculation(Context::ALBUM,
+			std::make_unique<Versions1and2withFrame450>(), size, points) };
+
+	REQUIRE ( calculation.types().size() == 3 );
+
+	reference.update(samples.data(), samples.data() + samples.size());
+
+	// Update in blocks not aligned to frame 450
+	const auto block_size { std::size_t { 1000 } };
+
+
+	SECTION ( "Updating with pointers yields ARCSs and ARCS of frame 450" )
+	{
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			calculation.update(samples.data() + i,
+				samples.data() + std::min(i + block_size, samples.size()));
+		}
+
+		REQUIRE ( calculation.complete() );
+
+		const auto result { calculation.result() };
+
+		REQUIRE ( result.size() == 3 );
+
+		for (auto t = std::size_t { 0 }; t < result.size(); ++t)
+		{
+			CHECK ( result[t].size() == 3 );
+			CHECK ( result[t].length() == reference.result()[t].length() );
+			CHECK ( result[t].get(type::ARCS1) ==
+					reference.result()[t].get(type::ARCS1) );
+			CHECK ( result[t].get(type::ARCS2) ==
+					reference.result()[t].get(type::ARCS2) );
+			CHECK ( result[t].get(type::FRAME450) == expected[t] );
+		}
+	}
+
+
+	SECTION ( "Updating with iterators yields ARCSs and ARCS of frame 450" )
+	{
+		using diff = std::vector<sample_t>::difference_type;
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			calculation.update(samples.cbegin() + static_cast<diff>(i),
+				samples.cbegin() + static_cast<diff>(
+					std::min(i + block_size, samples.size())));
+		}
+
+		REQUIRE ( calculation.complete() );
+
+		const auto result { calculation.result() };
+
+		REQUIRE ( result.size() == 3 );
+
+		for (auto t = std::size_t { 0 }; t < result.size(); ++t)
+		{
+			CHECK ( result[t].size() == 3 );
+			CHECK ( result[t].get(type::ARCS1) ==
+					reference.result()[t].get(type::ARCS1) );
+			CHECK ( result[t].get(type::FRAME450) == expected[t] );
+		}
+	}
+
+
+	SECTION ( "Windows around frame 450 are retained for each track" )
+	{
+		using arcstk::accuraterip::details::ARCSFrame450Base;
+
+		const auto max_offset { 1000 };
+
+		auto windowed { Calculation(Context::ALBUM,
+				std::make_unique<Versions1and2withFrame450>(max_offset),
+				size, points) };
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			windowed.update(samples.data() + i,
+				samples.data() + std::min(i + block_size, samples.size()));
+		}
+
+		REQUIRE ( windowed.complete() );
+
+		const auto algorithm { dynamic_cast<const ARCSFrame450Base*>(
+				windowed.algorithm()) };
+
+		REQUIRE ( algorithm );
+		CHECK ( algorithm->max_offset() == max_offset );
+
+		for (auto t = std::size_t { 0 }; t < points.size(); ++t)
+		{
+			const auto first { samples.cbegin()
+				+ points[t].samples() + 450 * 588 - max_offset };
+
+			const auto window {
+				algorithm->frame450_window(static_cast<int>(t + 1)) };
+
+			REQUIRE ( window.size()
+					== static_cast<std::size_t>(588 + 2 * max_offset) );
+			CHECK ( std::equal(window.begin(), window.end(), first) );
+
+			CHECK ( windowed.result()[t].get(type::FRAME450) == expected[t] );
+		}
+
+		CHECK ( algorithm->frame450_window(4).empty() );
+	}
+
+
+	SECTION ( "Track that ends within its window has no window" )
+	{
+		using arcstk::accuraterip::details::ARCSFrame450Base;
+
+		// Last track ends 100 samples behind frame 450, not counting the
+		// 2940 samples skipped at the end of the last track
+		const auto short_size { AudioSize {
+			points[2].samples() + 451 * 588 + 100 + 2940, UNIT::SAMPLES } };
+
+		auto windowed { Calculation(Context::ALBUM,
+				std::make_unique<Versions1and2withFrame450>(1000),
+				short_size, points) };
+
+		windowed.update(samples.data(),
+				samples.data() + short_size.samples());
+
+		REQUIRE ( windowed.complete() );
+
+		const auto algorithm { dynamic_cast<const ARCSFrame450Base*>(
+				windowed.algorithm()) };
+
+		REQUIRE ( algorithm );
+		CHECK ( not algorithm->frame450_window(2).empty() );
+		CHECK ( algorithm->frame450_window(3).empty() );
+
+		CHECK ( windowed.result()[2].get(type::FRAME450) == expected[2] );
+	}
+
+
+	SECTION ( "Maximal offset out of range is rejected" )
+	{
+		CHECK_THROWS_AS ( Versions1and2withFrame450(-1),
+				std::invalid_argument );
+		CHECK_THROWS_AS ( Versions1and2withFrame450(450 * 588 + 1),
+				std::invalid_argument );
+	}
+}
+
+
+TEST_CASE ( "ARCSOffsetScanner", "[offsetscanner] [calc]" )
+{
+	using arcstk::AudioSize;
+	using arcstk::Calculation;
+	using arcstk::Context;
+	using arcstk::Points;
+	using arcstk::UNIT;
+	using arcstk::checksum::type;
+	using arcstk::sample_t;
+	using arcstk::accuraterip::details::ARCSOffsetScanner;
+	using arcstk::accuraterip::details::Versions1and2;
+
+	const auto size   { AudioSize { 1000, UNIT::FRAMES } };
+	const auto points { Points {
+		AudioSize {  20, UNIT::FRAMES },
+		AudioSize { 400, UNIT::FRAMES },
+		AudioSize { 700, UNIT::FRAMES }
+	}};
+
+	auto samples = std::vector<sample_t>(
+			static_cast<std::size_t>(size.samples()));
+
+	auto x { uint32_t { 1 } };
+	for (auto& s : samples)
+	{
+		x = x * 1664525u + 1013904223u;
+		s = x;
+	}
+
+	auto scanner { ARCSOffsetScanner { Context::ALBUM, size, points } };
+
+	// Update in blocks not aligned to the bounds of the retained samples
+	const auto block_size { std::size_t { 5000 } };
+	for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+	{
+		scanner.update(samples.data() + i,
+				samples.data() + std::min(i + block_size, samples.size()));
+	}
+
+	REQUIRE ( scanner.complete() );
+	REQUIRE ( scanner.total_tracks() == 3 );
+	REQUIRE ( scanner.max_offset() == 2940 );
+
+	// Calculate the reference for offset o by shifting the input
+	const auto calculate = [&](const int32_t o)
+	{
+		auto shifted = std::vector<sample_t>(samples.size(), 0);
+
+		for (auto i = int32_t { 0 }; i < size.samples(); ++i)
+		{
+			if (i + o >= 0 && i + o < size.samples())
+			{
+				shifted[static_cast<std::size_t>(i)] =
+					samples[static_cast<std::size_t>(i + o)];
+			}
+		}
+
+		auto calculation { Calculation(Context::ALBUM,
+				std::make_unique<Versions1and2>(), size, points) };
+
+		calculation.update(shifted.data(), shifted.data() + shifted.size());
+
+		return calculation.result();
+	};
+
+
+	SECTION ( "Offset 0 yields same ARCSv1 and ARCSv2 as Calculation" )
+	{
+		CHECK ( scanner.result(0) == calculate(0) );
+	}
+
+
+	SECTION ( "Offsets yield same ARCSv1 as Calculation on shifted input" )
+	{
+		for (const auto o : { -2940, -2939, -1, 1, 6, 667, 2939, 2940 })
+		{
+			const auto reference { calculate(o) };
+			const auto result    { scanner.result(o) };
+
+			REQUIRE ( result.size() == reference.size() );
+
+			for (auto t = std::size_t { 0 }; t < result.size(); ++t)
+			{
+				CHECK ( result[t].size() == 1 );
+				CHECK ( result[t].length() == reference[t].length() );
+				CHECK ( result[t].get(type::ARCS1) ==
+						reference[t].get(type::ARCS1) );
+			}
+		}
+	}
+
+
+	SECTION ( "Offsets out of range throw" )
+	{
+		CHECK_THROWS ( scanner.arcs1(1,  2941) );
+		CHECK_THROWS ( scanner.arcs1(1, -2941) );
+		CHECK_THROWS ( scanner.arcs1(0, 0) );
+		CHECK_THROWS ( scanner.arcs1(4, 0) );
+	}
+}
+
+
 //TEST_CASE ( "Updating ARCS v1+v2 with MultiTrackContext", "[update]" )
 //{
 /*
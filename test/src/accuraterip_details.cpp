@@ -0,0 +1,139 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for accuraterip_details.hpp.
+ */
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#define __LIBARCSTK_ALGORITHMS_HPP__ // allow accuraterip.hpp
+#endif
+#ifndef __LIBARCSTK_ACCURATERIP_HPP__
+#include "accuraterip.hpp"
+#endif
+#ifndef __LIBARCSTK_ACCURATERIP_DETAILS_HPP__
+#include "accuraterip_details.hpp" // TO BE TESTED
+#endif
+
+#include <cstdint>                // for uint32_t, uint_fast64_t
+#include <random>                 // for mt19937, uniform_int_distribution
+#include <vector>                 // for vector
+
+
+TEST_CASE ( "sum_products()", "[sum_products] [calc]" )
+{
+	using arcstk::sample_t;
+	using arcstk::accuraterip::details::InstructionSet;
+	using arcstk::accuraterip::details::ProductSums;
+	using arcstk::accuraterip::details::is_supported;
+	using arcstk::accuraterip::details::sum_products;
+
+	auto engine       = std::mt19937 { 4711 };
+	auto distribution = std::uniform_int_distribution<uint32_t> {};
+
+	auto samples = std::vector<sample_t>(100003);
+	for (auto& s : samples)
+	{
+		s = distribution(engine);
+	}
+
+	const auto isas = std::vector<InstructionSet> {
+		InstructionSet::SSE41, InstructionSet::AVX2, InstructionSet::AVX512F
+	};
+
+	// Compare every supported kernel with the scalar kernel
+	const auto check_kernels = [&](const std::size_t offset,
+			const std::size_t size, const uint_fast64_t multiplier)
+	{
+		const auto start { samples.data() + offset };
+		const auto stop  { start + size };
+
+		const auto expected {
+			sum_products(InstructionSet::SCALAR, start, stop, multiplier) };
+
+		for (const auto& isa : isas)
+		{
+			if (not is_supported(isa))
+			{
+				continue;
+			}
+
+			const auto actual { sum_products(isa, start, stop, multiplier) };
+
+			CHECK ( actual.lower  == expected.lower  );
+			CHECK ( actual.higher == expected.higher );
+		}
+	};
+
+
+	SECTION ("Scalar kernel is always supported")
+	{
+		CHECK ( is_supported(InstructionSet::SCALAR) );
+	}
+
+
+	SECTION ("Scalar kernel computes the sums of the products")
+	{
+		const auto data = std::vector<sample_t> { 0xFFFFFFFF, 2, 3 };
+
+		const auto sums { sum_products(InstructionSet::SCALAR,
+				data.data(), data.data() + data.size(), 5) };
+
+		// 5 * 0xFFFFFFFF == 0x4FFFFFFFB, 6 * 2 == 12, 7 * 3 == 21
+		CHECK ( sums.lower  == uint_fast64_t { 0xFFFFFFFB } + 12 + 21 );
+		CHECK ( sums.higher == 4 );
+	}
+
+
+	SECTION ("Vectorized kernels are identical to scalar kernel for any size")
+	{
+		for (auto size = std::size_t { 0 }; size < 70; ++size)
+		{
+			check_kernels(0, size, 1);
+		}
+	}
+
+
+	SECTION ("Vectorized kernels are identical to scalar kernel if unaligned")
+	{
+		for (auto offset = std::size_t { 1 }; offset < 17; ++offset)
+		{
+			check_kernels(offset, samples.size() - offset, 2940);
+		}
+	}
+
+
+	SECTION ("Vectorized kernels are identical to scalar kernel for big "
+			"multipliers")
+	{
+		check_kernels(0, 1000, 0xFFFFFFFF - 1000);
+		check_kernels(0, 1000, 0xFFFFFFFF - 10);
+	}
+
+
+	SECTION ("Parallel sum is identical to sequential sum")
+	{
+		using arcstk::accuraterip::details::MIN_SAMPLES_PER_THREAD;
+
+		auto big = std::vector<sample_t>(3 * MIN_SAMPLES_PER_THREAD + 17);
+		for (auto& s : big)
+		{
+			s = distribution(engine);
+		}
+
+		const auto start { big.data() };
+		const auto stop  { big.data() + big.size() };
+
+		const auto expected {
+			sum_products(InstructionSet::SCALAR, start, stop, 2940) };
+
+		for (const auto threads : { 1u, 2u, 3u, 4u, 16u })
+		{
+			const auto actual { sum_products(start, stop, 2940, threads) };
+
+			CHECK ( actual.lower  == expected.lower  );
+			CHECK ( actual.higher == expected.higher );
+		}
+	}
+}
@@ -0,0 +1,279 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for batch.hpp.
+ */
+
+#ifndef __LIBARCSTK_BATCH_HPP__
+#include "batch.hpp"              // TO BE TESTED
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for AccurateRipV1V2
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for Calculation, make_calculation
+#endif
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#include "composite.hpp"          // for CompositeAlgorithm
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for ToC, make_toc
+#endif
+
+#include "fixtures.hpp"           // for random_samples
+
+#include <atomic>                 // for atomic
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <memory>                 // for make_unique, unique_ptr
+#include <stdexcept>              // for invalid_argument, runtime_error
+#include <vector>                 // for vector
+
+
+namespace
+{
+
+/**
+ * \brief SampleSource that fails after its first read.
+ */
+class FailingSampleSource final : public arcstk::SampleSource
+{
+	std::size_t do_read(uint32_t* buffer, const std::size_t size) final
+	{
+		if (reads_++ > 0)
+		{
+			throw std::runtime_error("Read error");
+		}
+
+		for (auto i = std::size_t { 0 }; i < size; ++i)
+		{
+			buffer[i] = 0;
+		}
+
+		return size;
+	}
+
+	int reads_ = 0;
+};
+
+} // namespace
+
+
+TEST_CASE ( "BatchCalculator", "[batch] [calc]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::BatchCalculator;
+	using arcstk::BatchJob;
+	using arcstk::Checksums;
+	using arcstk::JobStatus;
+	using arcstk::MemorySampleSource;
+	using arcstk::make_calculation;
+	using arcstk::make_toc;
+
+	const auto offsets { std::vector<int32_t>{ 33, 5225, 7390, 23380 } };
+	const auto leadout { 35608 };
+
+	const auto toc            { make_toc(leadout, offsets) };
+	const auto toc_incomplete { make_toc(offsets) };
+
+	const auto total_albums { 6 };
+
+	auto albums   = std::vector<std::vector<uint32_t>> {};
+	auto expected = std::vector<Checksums> {};
+
+	for (auto a = 0; a < total_albums; ++a)
+	{
+		albums.push_back(fixtures::random_samples(leadout,
+					static_cast<uint32_t>(a)));
+
+		auto calc { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		calc->update(albums.back().data(),
+				albums.back().data() + albums.back().size());
+		expected.push_back(calc->result());
+	}
+
+
+	SECTION ("Construction without Algorithm fails")
+	{
+		CHECK_THROWS_AS ( BatchCalculator(nullptr), std::invalid_argument );
+	}
+
+
+	SECTION ("Number of threads is as specified")
+	{
+		BatchCalculator batch(std::make_unique<V1andV2>(), 3);
+
+		CHECK ( batch.threads() == 3 );
+		CHECK ( batch.unfinished() == 0 );
+	}
+
+
+	SECTION ("Results are equal to the results of single Calculations")
+	{
+		BatchCalculator batch(std::make_unique<V1andV2>(), 2);
+
+		auto jobs = std::vector<BatchJob> {};
+
+		for (const auto& album : albums)
+		{
+			jobs.push_back(batch.submit(*toc, std::make_unique<MemorySampleSource>(
+					album.data(), album.data() + album.size())));
+		}
+
+		batch.wait();
+
+		CHECK ( batch.unfinished() == 0 );
+
+		for (auto a = std::size_t { 0 }; a < jobs.size(); ++a)
+		{
+			CHECK ( jobs[a].id() == a );
+			CHECK ( jobs[a].status() == JobStatus::COMPLETED );
+			CHECK ( jobs[a].result() == expected[a] );
+		}
+	}
+
+
+	SECTION ("Results for incomplete ToCs are equal to single Calculations")
+	{
+		BatchCalculator batch(std::make_unique<V1andV2>(), 2);
+
+		auto jobs = std::vector<BatchJob> {};
+
+		for (const auto& album : albums)
+		{
+			jobs.push_back(batch.submit(*toc_incomplete,
+					std::make_unique<MemorySampleSource>(
+						album.data(), album.data() + album.size())));
+		}
+
+		for (auto a = std::size_t { 0 }; a < jobs.size(); ++a)
+		{
+			CHECK ( jobs[a].future().get() == expected[a] );
+			CHECK ( jobs[a].status() == JobStatus::COMPLETED );
+		}
+	}
+
+
+	SECTION ("Incomplete ToC requires a SampleSource with known size")
+	{
+		BatchCalculator batch(std::make_unique<V1andV2>(), 1);
+
+		CHECK_THROWS_AS ( batch.submit(*toc_incomplete,
+					std::make_unique<FailingSampleSource>()),
+				std::invalid_argument );
+
+		CHECK ( batch.unfinished() == 0 );
+	}
+
+
+	SECTION ("Callback is called for each job")
+	{
+		auto called    = std::atomic<int> { 0 };
+		auto completed = std::atomic<int> { 0 };
+
+		{
+			BatchCalculator batch(std::make_unique<V1andV2>(), 4);
+
+			for (auto a = std::size_t { 0 }; a < albums.size(); ++a)
+			{
+				batch.submit(*toc, std::make_unique<MemorySampleSource>(
+						albums[a].data(), albums[a].data() + albums[a].size()),
+					[&called, &completed, &expected](const std::size_t id,
+						const JobStatus status, const Checksums& result) noexcept
+					{
+						++called;
+
+						if (status == JobStatus::COMPLETED
+								&& result == expected[id])
+						{
+							++completed;
+						}
+					});
+			}
+		} // destructor waits for all jobs
+
+		CHECK ( called    == total_albums );
+		CHECK ( completed == total_albums );
+	}
+
+
+	SECTION ("Failing jobs are reported and do not affect other jobs")
+	{
+		BatchCalculator batch(std::make_unique<V1andV2>(), 2);
+
+		auto failed_status = std::atomic<JobStatus> { JobStatus::QUEUED };
+
+		auto failing { batch.submit(*toc,
+				std::make_unique<FailingSampleSource>(),
+				[&failed_status](const std::size_t, const JobStatus status,
+					const Checksums& result) noexcept
+				{
+					if (result.empty())
+					{
+						failed_status = status;
+					}
+				}) };
+
+		const auto& album { albums.front() };
+		auto exhausted { batch.submit(*toc,
+				std::make_unique<MemorySampleSource>(
+					album.data(), album.data() + album.size() / 2)) };
+
+		auto succeeding { batch.submit(*toc,
+				std::make_unique<MemorySampleSource>(
+					album.data(), album.data() + album.size())) };
+
+		batch.wait();
+
+		CHECK ( failing.status() == JobStatus::FAILED );
+		CHECK_THROWS_AS ( failing.result(), std::runtime_error );
+		CHECK ( failed_status == JobStatus::FAILED );
+
+		CHECK ( exhausted.status() == JobStatus::FAILED );
+		CHECK_THROWS_AS ( exhausted.result(), std::runtime_error );
+
+		CHECK ( succeeding.status() == JobStatus::COMPLETED );
+		CHECK ( succeeding.result() == expected.front() );
+	}
+
+
+	SECTION ("Reused calculations are correct after a failed job")
+	{
+		using arcstk::ChecksumtypeSet;
+		using arcstk::CompositeAlgorithm;
+		using type = arcstk::checksum::type;
+
+		const auto types { ChecksumtypeSet {
+			type::ARCS1, type::ARCS2, type::CRC32, type::CTDB } };
+
+		BatchCalculator batch(std::make_unique<CompositeAlgorithm>(types), 1);
+
+		auto failing { batch.submit(*toc,
+				std::make_unique<FailingSampleSource>()) };
+
+		auto jobs = std::vector<BatchJob> {};
+
+		for (const auto& album : albums)
+		{
+			jobs.push_back(batch.submit(*toc, std::make_unique<MemorySampleSource>(
+					album.data(), album.data() + album.size())));
+		}
+
+		batch.wait();
+
+		CHECK ( failing.status() == JobStatus::FAILED );
+
+		for (auto a = std::size_t { 0 }; a < jobs.size(); ++a)
+		{
+			auto calc { make_calculation(
+					std::make_unique<CompositeAlgorithm>(types), *toc) };
+			calc->update(albums[a].data(), albums[a].data() + albums[a].size());
+
+			CHECK ( jobs[a].result() == calc->result() );
+		}
+	}
+}
+
@@ -19,14 +19,62 @@
 #ifndef __LIBARCSTK_METADATA_HPP__
 #include "metadata.hpp"           // for AudioSize, ToC, make_toc, UNIT
 #endif
+#ifndef __LIBARCSTK_SAMPLES_HPP__
+#include "samples.hpp"            // for InterleavedSamples
+#endif
+
+#include "fixtures.hpp"           // for album_offsets, album_toc, ...
 
+#include <algorithm>              // for equal, min, reverse
+#include <atomic>                 // for atomic
+#include <cstdint>                // for uint32_t, uint64_t
+#include <cstdlib>                // for malloc, free
+#include <deque>                  // for deque
+#include <functional>             // for function
+#include <list>                   // for list
+#include <iterator>               // for iterator_traits
 #include <memory>                 // for make_unique, unique_ptr
+#include <new>                    // for bad_alloc
+#include <numeric>                // for iota
+#include <stdexcept>              // for runtime_error
 #include <type_traits>            // for is_default_constructible,....
 #include <unordered_set>          // for unordered_set
-#include <utility>                // for move
+#include <utility>                // for move, pair
 #include <vector>                 // for vector
 
 
+// Count heap allocations by replacing the global allocation functions
+
+namespace
+{
+
+std::atomic<std::size_t> allocations { 0 };
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+	++allocations;
+
+	if (auto p = std::malloc(size))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t /* size */) noexcept
+{
+	std::free(p);
+}
+
+
 TEST_CASE ( "Context", "[context] [calc]" )
 {
 	using arcstk::Context;
@@ -60,6 +108,278 @@ TEST_CASE ( "Context", "[context] [calc]" )
 }
 
 
+TEST_CASE ( "SampleInputIterator", "[sampleinputiterator] [calc]" )
+{
+	using arcstk::SampleInputIterator;
+	using arcstk::sample_t;
+
+	auto samples = std::vector<sample_t>(100);
+	std::iota(samples.begin(), samples.end(), 1);
+
+	const auto first { SampleInputIterator { samples.cbegin() } };
+	const auto last  { SampleInputIterator { samples.cend()   } };
+
+
+	SECTION ( "Iterator is an input iterator" )
+	{
+		using category =
+			std::iterator_traits<SampleInputIterator>::iterator_category;
+
+		CHECK ( std::is_same<category, std::input_iterator_tag>::value );
+	}
+
+
+	SECTION ( "Distance is correct" )
+	{
+		CHECK ( last - first == 100 );
+		CHECK ( first - last == -100 ); // wraps a random access iterator
+		CHECK ( last - last == 0 );
+	}
+
+
+	SECTION ( "Distance and advancing are correct for non-random access iterators" )
+	{
+		const auto l = std::list<sample_t>(samples.cbegin(), samples.cend());
+
+		const auto l_first { SampleInputIterator { l.cbegin() } };
+		const auto l_last  { SampleInputIterator { l.cend()   } };
+
+		CHECK ( l_last - l_first == 100 );
+
+		auto pos { l_first };
+		pos += 42;
+		CHECK ( *pos == 43 );
+		CHECK ( pos - l_first == 42 );
+		CHECK ( l_first + 100 == l_last );
+	}
+
+
+	SECTION ( "Advancing is correct" )
+	{
+		auto pos { first };
+
+		pos += 42;
+		CHECK ( *pos == 43 );
+
+		CHECK ( *(pos + 10) == 53 );
+		CHECK ( *(10 + pos) == 53 );
+		CHECK ( first + 100 == last );
+		CHECK ( first + 42  == pos  );
+		CHECK ( first + 41  != pos  );
+	}
+
+
+	SECTION ( "Copying a block of samples is correct" )
+	{
+		const auto dq = std::deque<sample_t>(samples.cbegin(), samples.cend());
+		const auto d_first { SampleInputIterator { dq.cbegin() } };
+
+		auto v_buffer = std::vector<sample_t>(20);
+		auto d_buffer = std::vector<sample_t>(20);
+
+		auto pos { first + 30 };
+		pos.copy(20, v_buffer.data());
+
+		auto d_pos { d_first + 30 };
+		d_pos.copy(20, d_buffer.data());
+
+		CHECK ( *pos == 51 ); // advanced behind the last sample copied
+		CHECK ( pos - first == 50 );
+		CHECK ( d_pos - d_first == 50 );
+		CHECK ( std::equal(v_buffer.cbegin(), v_buffer.cend(),
+					samples.cbegin() + 30) );
+		CHECK ( v_buffer == d_buffer );
+	}
+
+
+	SECTION ( "Wrapping small iterators does not allocate" )
+	{
+		using arcstk::InterleavedSamples;
+
+		auto sequence = InterleavedSamples<uint32_t>{};
+		sequence.wrap_int_buffer(samples.data(), samples.size(), true);
+
+		const auto by_value = [](SampleInputIterator b, SampleInputIterator e)
+		{
+			return e - b;
+		};
+
+		// Do not use assertions before the count is taken since the test
+		// framework itself may allocate
+
+		const auto before { allocations.load() };
+
+		// Iterator of standard container
+		auto v_pos { first };
+		v_pos = first + 10;
+		v_pos += 5;
+		const auto v_dist { by_value(v_pos, last) };
+
+		// Pointer
+		const auto p_first { SampleInputIterator { samples.data() } };
+		auto p_pos { p_first + 50 };
+		const auto p_dist { by_value(p_first, p_pos) };
+
+		// SampleIterator
+		const auto s_first { SampleInputIterator { sequence.cbegin() } };
+		const auto s_last  { SampleInputIterator { sequence.cend()   } };
+		auto s_pos { s_first };
+		swap(s_pos, v_pos);
+		const auto s_dist { by_value(v_pos + 20, s_last) };
+		const auto value  { *s_pos };
+
+		const auto after { allocations.load() };
+
+		CHECK ( v_dist == 85 );
+		CHECK ( p_dist == 50 );
+		CHECK ( s_dist == 30 ); // 50 stereo samples
+		CHECK ( value  == 16 );
+
+		CHECK ( after == before );
+	}
+
+
+	SECTION ( "Wrapping large iterators allocates" )
+	{
+		const auto dq = std::deque<sample_t>(samples.cbegin(), samples.cend());
+
+		const auto before { allocations.load() };
+
+		const auto d_first { SampleInputIterator { dq.cbegin() } };
+		const auto d_copy  { d_first };
+		const auto value   { *(d_copy + 99) };
+
+		const auto after { allocations.load() };
+
+		CHECK ( value == 100 );
+		CHECK ( after > before );
+	}
+}
+
+
+TEST_CASE ( "Settings", "[settings] [calc]" )
+{
+	using arcstk::Context;
+	using arcstk::Settings;
+
+	auto settings { Settings { Context::ALBUM } };
+
+	SECTION ( "Default number of threads is 1" )
+	{
+		CHECK ( settings.threads() == 1 );
+		CHECK ( Settings{}.threads() == 1 );
+	}
+
+	SECTION ( "Setting number of threads works" )
+	{
+		settings.set_threads(8);
+
+		CHECK ( settings.threads() == 8 );
+		CHECK ( settings.context() == Context::ALBUM );
+	}
+
+	SECTION ( "Number of threads is respected by equality" )
+	{
+		auto other { Settings { Context::ALBUM } };
+
+		CHECK ( settings == other );
+
+		other.set_threads(0);
+
+		CHECK ( settings != other );
+	}
+
+	SECTION ( "Default timing is FINE" )
+	{
+		using arcstk::Timing;
+
+		CHECK ( settings.timing() == Timing::FINE );
+
+		settings.set_timing(Timing::OFF);
+
+		CHECK ( settings.timing() == Timing::OFF );
+		CHECK ( settings != Settings { Context::ALBUM } );
+	}
+}
+
+
+namespace
+{
+
+/**
+ * \brief Algorithm that only implements the update with SampleInputIterators.
+ *
+ * Stands for an Algorithm implemented before the contiguous update existed.
+ */
+class IteratorOnlyAlgorithm final : public arcstk::Algorithm
+{
+	using arcstk::Algorithm::do_update;
+
+	void do_setup(const arcstk::Settings*) final
+	{
+		// empty
+	}
+
+	std::pair<int32_t,int32_t> do_range(const arcstk::AudioSize& size,
+			const arcstk::Points&) const final
+	{
+		return { 1, size.samples() };
+	}
+
+	void do_update(arcstk::SampleInputIterator start,
+			arcstk::SampleInputIterator stop) final
+	{
+		while (start != stop)
+		{
+			sum_ += *start;
+			++start;
+		}
+	}
+
+	void do_track_finished(const int, const arcstk::AudioSize&) final
+	{
+		// empty
+	}
+
+	arcstk::ChecksumSet do_result() const final
+	{
+		return arcstk::ChecksumSet {};
+	}
+
+	arcstk::ChecksumtypeSet do_types() const final
+	{
+		return arcstk::ChecksumtypeSet {};
+	}
+
+	std::unique_ptr<arcstk::Algorithm> do_clone() const final
+	{
+		return std::make_unique<IteratorOnlyAlgorithm>(*this);
+	}
+
+public:
+
+	uint64_t sum_ = 0;
+};
+
+} // namespace
+
+
+TEST_CASE ( "Algorithm", "[algorithm] [calc]" )
+{
+	SECTION ( "Contiguous update falls back to the update with iterators" )
+	{
+		const auto samples { std::vector<uint32_t> { 1, 2, 3, 4, 5 } };
+
+		auto algorithm = IteratorOnlyAlgorithm {};
+		arcstk::Algorithm& base { algorithm };
+
+		base.update(samples.data(), samples.data() + samples.size());
+
+		CHECK ( algorithm.sum_ == 15 );
+	}
+}
+
+
 TEST_CASE ( "Calculation", "[calculation] [calc]" )
 {
 	using arcstk::AccurateRip::V1;
@@ -269,5 +589,480 @@ TEST_CASE ( "Calculation", "[calculation] [calc]" )
 		CHECK ( c->types() ==
 				std::unordered_set<type>{ type::ARCS1, type::ARCS2 } );
 	}
+
+
+	SECTION ("Calculation with incomplete ToC is correct after setting size")
+	{
+		const auto leadout { fixtures::album_leadout };
+
+		auto samples { fixtures::ascending_samples(leadout, 1u) };
+
+		auto complete { make_calculation(std::make_unique<V1andV2>(),
+				*fixtures::album_toc()) };
+		complete->update(samples.data(), samples.data() + samples.size());
+
+		auto incomplete { make_calculation(std::make_unique<V1andV2>(),
+				*make_toc(fixtures::album_offsets())) };
+		incomplete->update(AudioSize { leadout, UNIT::FRAMES });
+
+		CHECK ( incomplete->samples_expected() == leadout * 588 );
+
+		incomplete->update(samples.data(), samples.data() + samples.size());
+
+		CHECK ( incomplete->complete() );
+		CHECK ( incomplete->result() == complete->result() );
+	}
+
+
+	SECTION ("Setting size between updates is correct")
+	{
+		const auto leadout { fixtures::album_leadout };
+
+		auto samples { fixtures::random_samples(leadout, 0xC0FFEEu) };
+
+		auto complete { make_calculation(std::make_unique<V1andV2>(),
+				*fixtures::album_toc()) };
+		complete->update(samples.data(), samples.data() + samples.size());
+
+		auto incomplete { make_calculation(std::make_unique<V1andV2>(),
+				*make_toc(fixtures::album_offsets())) };
+
+		// Set the size within track 2
+		const auto split { std::size_t { 6000 * 588 + 17 } };
+
+		incomplete->update(samples.data(), samples.data() + split);
+		incomplete->update(AudioSize { leadout, UNIT::FRAMES });
+
+		CHECK ( incomplete->current_offset() == split );
+		CHECK ( incomplete->samples_expected() == leadout * 588 );
+
+		incomplete->update(samples.data() + split,
+				samples.data() + samples.size());
+
+		CHECK ( incomplete->complete() );
+		CHECK ( incomplete->result() == complete->result() );
+	}
+}
+
+
+TEST_CASE ( "Calculation::update()", "[calculation] [calc]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AudioSize;
+	using arcstk::Calculation;
+	using arcstk::Context;
+	using arcstk::Points;
+	using arcstk::Settings;
+	using arcstk::UNIT;
+	using arcstk::sample_t;
+
+	const auto size   { AudioSize { 10000, UNIT::FRAMES } };
+	const auto points { Points {
+		AudioSize {   33, UNIT::FRAMES },
+		AudioSize { 5225, UNIT::FRAMES },
+		AudioSize { 7390, UNIT::FRAMES }
+	}};
+
+	auto samples = std::vector<sample_t>(
+			static_cast<std::size_t>(size.samples()));
+	std::iota(samples.begin(), samples.end(), 1);
+
+	auto c_iterators { Calculation(Context::ALBUM,
+			std::make_unique<V1andV2>(), size, points) };
+
+	auto c_pointers  { Calculation(Context::ALBUM,
+			std::make_unique<V1andV2>(), size, points) };
+
+	const auto block_size { std::size_t { 4096 * 3 } }; // samples
+
+
+	SECTION ("Updating with pointers equals updating with iterators")
+	{
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			const auto end_idx { std::min(i + block_size, samples.size()) };
+
+			using diff = std::vector<sample_t>::difference_type;
+
+			c_iterators.update(samples.cbegin() + static_cast<diff>(i),
+					samples.cbegin() + static_cast<diff>(end_idx));
+
+			c_pointers.update(samples.data() + i, samples.data() + end_idx);
+		}
+
+		REQUIRE ( c_iterators.complete() );
+		REQUIRE ( c_pointers.complete() );
+
+		CHECK ( c_pointers.samples_processed() ==
+				c_iterators.samples_processed() );
+
+		CHECK ( c_pointers.result().size() == 3 );
+		CHECK ( c_pointers.result() == c_iterators.result() );
+	}
+
+
+	SECTION ("Time is measured according to the timing level")
+	{
+		using arcstk::Timing;
+
+		auto off    { Settings { Context::ALBUM } };
+		auto coarse { Settings { Context::ALBUM } };
+		auto fine   { Settings { Context::ALBUM } };
+
+		off.set_timing(Timing::OFF);
+		coarse.set_timing(Timing::COARSE);
+
+		auto c_off    { Calculation(off,    std::make_unique<V1andV2>(), size,
+				points) };
+		auto c_coarse { Calculation(coarse, std::make_unique<V1andV2>(), size,
+				points) };
+		auto c_fine   { Calculation(fine,   std::make_unique<V1andV2>(), size,
+				points) };
+
+		for (auto* c : { &c_off, &c_coarse, &c_fine })
+		{
+			c->update(samples.data(), samples.data() + samples.size());
+			REQUIRE ( c->complete() );
+		}
+
+		CHECK ( c_off.update_time_elapsed().count()    == 0 );
+		CHECK ( c_off.algo_time_elapsed().count()      == 0 );
+
+		CHECK ( c_coarse.update_time_elapsed().count() >  0 );
+		CHECK ( c_coarse.algo_time_elapsed().count()   == 0 );
+
+		CHECK ( c_fine.update_time_elapsed().count()   >  0 );
+		CHECK ( c_fine.algo_time_elapsed().count()     >  0 );
+
+		CHECK ( c_fine.result() == c_off.result() );
+	}
+
+
+	SECTION ("Updating with multiple threads equals updating single-threaded")
+	{
+		auto settings { Settings { Context::ALBUM } };
+		settings.set_threads(4);
+
+		auto c_threads { Calculation(settings,
+				std::make_unique<V1andV2>(), size, points) };
+
+		REQUIRE ( c_threads.settings().threads() == 4 );
+
+		// Update with the entire album at once
+		c_threads.update(samples.data(), samples.data() + samples.size());
+
+		// Update with two blocks, split within track 2
+		const auto split { std::size_t { 3000 * 588 + 17 } };
+		c_pointers.update(samples.data(), samples.data() + split);
+		c_pointers.update(samples.data() + split,
+				samples.data() + samples.size());
+
+		REQUIRE ( c_threads.complete() );
+		REQUIRE ( c_pointers.complete() );
+
+		CHECK ( c_threads.result().size() == 3 );
+		CHECK ( c_threads.result() == c_pointers.result() );
+	}
+
+
+	SECTION ("Reset calculation equals a new calculation")
+	{
+		c_iterators.update(samples.data(), samples.data() + samples.size());
+		REQUIRE ( c_iterators.complete() );
+
+		// Abort within track 2, then reset to calculate a single track
+		c_pointers.update(samples.data(), samples.data() + 6000 * 588);
+		c_pointers.reset(AudioSize { 1000, UNIT::FRAMES }, Points {});
+
+		CHECK ( c_pointers.samples_processed() == 0 );
+		CHECK ( c_pointers.result().empty() );
+
+		c_pointers.update(samples.data(), samples.data() + 1000 * 588);
+		REQUIRE ( c_pointers.complete() );
+		CHECK ( c_pointers.result().size() == 1 );
+
+		// Reset to the original input
+		c_pointers.reset(size, points);
+		c_pointers.update(samples.data(), samples.data() + samples.size());
+		REQUIRE ( c_pointers.complete() );
+
+		CHECK ( c_pointers.result() == c_iterators.result() );
+	}
+}
+
+
+TEST_CASE ( "merge()", "[calculation] [calc]" )
+{
+	using arcstk::AccurateRip::V1;
+	using arcstk::AccurateRip::V2;
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AccurateRip::V1andV2withFrame450;
+	using arcstk::Algorithm;
+	using arcstk::Calculation;
+	using arcstk::make_calculation;
+	using arcstk::merge;
+
+	const auto toc { fixtures::album_toc() };
+
+	auto samples { fixtures::ascending_samples(fixtures::album_leadout, 7u) };
+
+	const auto last { static_cast<int32_t>(samples.size()) - 1 };
+
+	// Calculate each sub-range in its own Calculation
+	const auto partials = [&](const std::function<std::unique_ptr<Algorithm>()>&
+			create, const std::vector<std::pair<int32_t, int32_t>>& subranges)
+	{
+		auto calculations { std::vector<std::unique_ptr<Calculation>> {} };
+
+		for (const auto& subrange : subranges)
+		{
+			auto c { make_calculation(create(), *toc, subrange.first,
+					subrange.second) };
+
+			c->update(samples.data() + subrange.first,
+					samples.data() + subrange.second + 1);
+
+			REQUIRE ( c->complete() );
+			REQUIRE ( c->subrange() == subrange );
+
+			calculations.push_back(std::move(c));
+		}
+
+		return calculations;
+	};
+
+	const auto pointers = [](
+			const std::vector<std::unique_ptr<Calculation>>& calculations)
+	{
+		auto result { std::vector<const Calculation*> {} };
+
+		for (const auto& c : calculations)
+		{
+			result.push_back(c.get());
+		}
+
+		return result;
+	};
+
+	const auto direct_result = [&](std::unique_ptr<Algorithm> a)
+	{
+		auto calculation { make_calculation(std::move(a), *toc) };
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		return calculation->result();
+	};
+
+	// Split within track 2 and exactly at the start of track 3
+	const auto split_1 { 6000 * 588 + 17 };
+	const auto split_2 { 7390 * 588 };
+
+	const auto subranges { std::vector<std::pair<int32_t, int32_t>> {
+		{ 0, split_1 - 1 }, { split_1, split_2 - 1 }, { split_2, last }
+	}};
+
+
+	SECTION ("Merged result of V1andV2 equals the result of the entire input")
+	{
+		const auto c { partials(
+				[]{ return std::make_unique<V1andV2>(); }, subranges) };
+
+		CHECK ( merge(pointers(c)) == direct_result(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Merged result of V1 and of V2 equals the result of the entire"
+			" input")
+	{
+		const auto c1 { partials(
+				[]{ return std::make_unique<V1>(); }, subranges) };
+		const auto c2 { partials(
+				[]{ return std::make_unique<V2>(); }, subranges) };
+
+		CHECK ( merge(pointers(c1)) == direct_result(std::make_unique<V1>()) );
+		CHECK ( merge(pointers(c2)) == direct_result(std::make_unique<V2>()) );
+	}
+
+
+	SECTION ("Partial calculations can be merged in any order")
+	{
+		const auto c { partials(
+				[]{ return std::make_unique<V1andV2>(); }, subranges) };
+
+		auto reversed { pointers(c) };
+		std::reverse(reversed.begin(), reversed.end());
+
+		CHECK ( merge(reversed) == direct_result(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Partial calculations with a gap are rejected")
+	{
+		const auto c { partials([]{ return std::make_unique<V1andV2>(); },
+				{ { 0, split_1 - 1 }, { split_1 + 1, last } }) };
+
+		CHECK_THROWS_AS ( merge(pointers(c)), std::invalid_argument );
+	}
+
+
+	SECTION ("Partial calculations not covering the input are rejected")
+	{
+		const auto c { partials([]{ return std::make_unique<V1andV2>(); },
+				{ { 0, split_1 - 1 } }) };
+
+		CHECK_THROWS_AS ( merge(pointers(c)), std::invalid_argument );
+	}
+
+
+	SECTION ("Incomplete partial calculations are rejected")
+	{
+		auto c { partials([]{ return std::make_unique<V1andV2>(); },
+				{ { 0, split_1 - 1 } }) };
+
+		c.push_back(make_calculation(std::make_unique<V1andV2>(), *toc,
+					split_1, last));
+
+		CHECK_THROWS_AS ( merge(pointers(c)), std::invalid_argument );
+	}
+
+
+	SECTION ("Illegal sub-ranges are rejected")
+	{
+		CHECK_THROWS_AS ( make_calculation(std::make_unique<V1andV2>(), *toc,
+					-1, last), std::invalid_argument );
+		CHECK_THROWS_AS ( make_calculation(std::make_unique<V1andV2>(), *toc,
+					split_1, split_1 - 1), std::invalid_argument );
+		CHECK_THROWS_AS ( make_calculation(std::make_unique<V1andV2>(), *toc,
+					0, last + 1), std::invalid_argument );
+	}
+
+
+	SECTION ("Algorithms without support for partial calculations are rejected")
+	{
+		CHECK_THROWS_AS ( make_calculation(
+					std::make_unique<V1andV2withFrame450>(), *toc, split_1, last),
+				std::logic_error );
+	}
 }
 
+
+TEST_CASE ( "Calculation::set_track_callback()", "[calculation] [calc]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::ChecksumSet;
+	using arcstk::make_calculation;
+
+	const auto toc { fixtures::album_toc() };
+
+	auto samples { fixtures::ascending_samples(fixtures::album_leadout, 7u) };
+
+	auto reference { make_calculation(std::make_unique<V1andV2>(), *toc) };
+	reference->update(samples.data(), samples.data() + samples.size());
+
+	const auto expected { reference->result() };
+
+	auto tracks    { std::vector<int> {} };
+	auto checksums { std::vector<ChecksumSet> {} };
+
+	const auto callback = [&tracks,&checksums](const int track,
+			const ChecksumSet& c)
+	{
+		tracks.push_back(track);
+		checksums.push_back(c);
+	};
+
+	// Split within track 2
+	const auto split { std::size_t { 6000 * 588 + 17 } };
+
+
+	SECTION ("Callback is called as soon as a track is finished")
+	{
+		auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		calculation->set_track_callback(callback);
+
+		calculation->update(samples.data(), samples.data() + split);
+
+		CHECK ( tracks == std::vector<int>{ 1 } );
+
+		calculation->update(samples.data() + split,
+				samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		CHECK ( tracks == std::vector<int>{ 1, 2, 3 } );
+		CHECK ( checksums.size() == expected.size() );
+		CHECK ( std::equal(checksums.begin(), checksums.end(),
+					expected.begin()) );
+	}
+
+
+	SECTION ("Callback of a partial calculation has the correct track numbers")
+	{
+		const auto last { static_cast<int32_t>(split) - 1 };
+
+		auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc,
+				5225 * 588, last) };
+		calculation->set_track_callback(callback);
+
+		calculation->update(samples.data() + 5225 * 588,
+				samples.data() + last + 1);
+
+		CHECK ( tracks == std::vector<int>{ 2 } );
+	}
+
+
+	SECTION ("Callback throwing leaves no finished track unnotified")
+	{
+		auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		calculation->set_track_callback(
+			[&callback](const int track, const ChecksumSet& c)
+			{
+				callback(track, c);
+
+				if (track == 1)
+				{
+					throw std::runtime_error("Stop after track 1");
+				}
+			});
+
+		CHECK_THROWS_AS ( calculation->update(samples.data(),
+					samples.data() + samples.size()), std::runtime_error );
+
+		CHECK ( tracks == std::vector<int>{ 1 } );
+		REQUIRE ( calculation->current_offset() == 5225 * 588 );
+
+		const auto offset {
+			static_cast<std::size_t>(calculation->current_offset()) };
+
+		calculation->update(samples.data() + offset,
+				samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		CHECK ( tracks == std::vector<int>{ 1, 2, 3 } );
+		CHECK ( std::equal(checksums.begin(), checksums.end(),
+					expected.begin()) );
+		CHECK ( calculation->result() == expected );
+	}
+
+
+	SECTION ("Empty callback removes the callback")
+	{
+		auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		calculation->set_track_callback(callback);
+		calculation->set_track_callback(nullptr);
+
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		CHECK ( tracks.empty() );
+	}
+
+
+	SECTION ("take_result() moves the result out of the Calculation")
+	{
+		auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		CHECK ( calculation->take_result() == expected );
+		CHECK ( calculation->result().empty() );
+	}
+}
@@ -18,6 +18,8 @@
 #include "metadata.hpp"           // for AudioSize, UNIT
 #endif
 
+#include <cstddef>                // for size_t
+#include <utility>                // for make_pair
 #include <vector>                 // for vector
 
 
@@ -451,13 +453,96 @@ TEST_CASE ( "Partition", "[partitioner] [calc]" )
 {
 	// TODO Implement
 }
+*/
 
 
 TEST_CASE ( "TrackPartitioner", "[trackpartitioner] [calc]" )
 {
-	// TODO Implement
+	using arcstk::AudioSize;
+	using arcstk::UNIT;
+	using arcstk::details::TrackPartitioner;
+	using arcstk::details::get_partitioning;
+
+	/* use Bach, Organ Concertos, Simon Preston, DGG */
+	const auto points = arcstk::Points {
+		AudioSize {     33 * 588, UNIT::SAMPLES },
+		AudioSize {   5225 * 588, UNIT::SAMPLES },
+		AudioSize {   7390 * 588, UNIT::SAMPLES },
+		AudioSize {  23380 * 588, UNIT::SAMPLES },
+		AudioSize {  35608 * 588, UNIT::SAMPLES },
+		AudioSize {  49820 * 588, UNIT::SAMPLES },
+		AudioSize {  69508 * 588, UNIT::SAMPLES },
+		AudioSize {  87733 * 588, UNIT::SAMPLES },
+		AudioSize { 106333 * 588, UNIT::SAMPLES },
+		AudioSize { 139495 * 588, UNIT::SAMPLES },
+		AudioSize { 157863 * 588, UNIT::SAMPLES },
+		AudioSize { 198495 * 588, UNIT::SAMPLES },
+		AudioSize { 213368 * 588, UNIT::SAMPLES },
+		AudioSize { 225320 * 588, UNIT::SAMPLES },
+		AudioSize { 234103 * 588, UNIT::SAMPLES }
+	};
+
+	const auto legal { arcstk::details::SampleRange {
+		33 * 588 + 2939, 253038 * 588 - 2940 } };
+
+	auto partitioner { TrackPartitioner {
+		AudioSize { 253038 * 588, UNIT::SAMPLES }, points, legal } };
+
+
+	SECTION ( "Bounds are the points in samples" )
+	{
+		CHECK ( partitioner.points().size() == 15 );
+		CHECK ( partitioner.bounds().size() == 15 );
+		CHECK ( partitioner.bounds().front() ==     33 * 588 );
+		CHECK ( partitioner.bounds().back()  == 234103 * 588 );
+	}
+
+	SECTION ( "Partitioning equals get_partitioning()" )
+	{
+		for (const auto& block : { std::make_pair(0, 29000000),
+				std::make_pair(29000000, 16777216),
+				std::make_pair(120000000, 28786344),
+				std::make_pair(3072000, 588) })
+		{
+			const auto& p { partitioner.create_partitioning(
+					block.first, block.second) };
+
+			const auto expected { get_partitioning(
+					{ block.first, block.first + block.second - 1 },
+					legal, points) };
+
+			REQUIRE ( p.size() == expected.size() );
+
+			for (auto i = std::size_t { 0 }; i < p.size(); ++i)
+			{
+				CHECK ( p[i].begin_offset() == expected[i].begin_offset() );
+				CHECK ( p[i].end_offset()   == expected[i].end_offset()   );
+				CHECK ( p[i].starts_track() == expected[i].starts_track() );
+				CHECK ( p[i].ends_track()   == expected[i].ends_track()   );
+				CHECK ( p[i].track()        == expected[i].track()        );
+			}
+		}
+	}
+
+	SECTION ( "Partitioning reuses its buffer" )
+	{
+		const auto& p1 { partitioner.create_partitioning(0, 148786344) };
+		const auto* data1 { p1.data() };
+
+		REQUIRE ( p1.size() == 15 );
+
+		const auto& p2 { partitioner.create_partitioning(3072000, 588) };
+
+		CHECK ( &p1 == &p2 );
+		CHECK ( p2.size() == 2 );
+		CHECK ( p2.data() == data1 );
+	}
+
+	SECTION ( "Block without relevant samples yields empty partitioning" )
+	{
+		CHECK ( partitioner.create_partitioning(0, 588).empty() );
+	}
 }
-*/
 
 // Commented out: intended use is:
 //
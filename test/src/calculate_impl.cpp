@@ -164,7 +164,7 @@ TEST_CASE ( "perform_update", "[perform_update] [calc]" )
 	REQUIRE ( state.algorithm() == algorithm.get() );
 
 	/* use Bach, Organ Concertos, Simon Preston, DGG */
-	const auto partitioner { TrackPartitioner {
+	auto partitioner { TrackPartitioner {
 		AudioSize { 253038 * 588 /* 148786344 */, UNIT::SAMPLES },
 		{ /* split points (track offsets) */
 			AudioSize {     33 * 588, UNIT::SAMPLES },
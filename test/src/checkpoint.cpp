@@ -0,0 +1,310 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for checkpoint.hpp.
+ */
+
+#ifndef __LIBARCSTK_CHECKPOINT_HPP__
+#include "checkpoint.hpp"         // TO BE TESTED
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for AccurateRip::V1andV2, ...
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for Calculation, make_calculation, merge
+#endif
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#include "composite.hpp"          // for CompositeAlgorithm
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for make_toc
+#endif
+
+#include "fixtures.hpp"           // for album_toc, ascending_samples
+
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint8_t, uint32_t
+#include <memory>                 // for make_unique, unique_ptr
+#include <stdexcept>              // for invalid_argument
+#include <vector>                 // for vector
+
+
+TEST_CASE ( "CheckpointWriter and CheckpointReader", "[checkpoint]" )
+{
+	using arcstk::CheckpointReader;
+	using arcstk::CheckpointWriter;
+	using arcstk::ChecksumSet;
+	using type = arcstk::checksum::type;
+
+	auto checksums { ChecksumSet { 1234 } };
+	checksums.insert(type::ARCS2, 0x8DFA6E8D);
+	checksums.insert(type::CRC32, 0x12345678);
+
+	auto out { CheckpointWriter {} };
+	out.write_u32(0xDEADBEEF);
+	out.write_u64(0x0123456789ABCDEF);
+	out.write_i32(-4711);
+	out.write(checksums);
+
+	const auto data { out.release() };
+
+
+	SECTION ("Values are written in little endian byte order")
+	{
+		CHECK ( data.size() == 4 + 8 + 4 + 4 + 4 + 2 * 8 );
+
+		CHECK ( data[0] == 0xEF );
+		CHECK ( data[3] == 0xDE );
+		CHECK ( data[4] == 0xEF );
+		CHECK ( data[11] == 0x01 );
+	}
+
+
+	SECTION ("Values are read as written")
+	{
+		auto in { CheckpointReader { data.data(), data.size() } };
+
+		CHECK ( in.read_u32() == 0xDEADBEEF );
+		CHECK ( in.read_u64() == 0x0123456789ABCDEF );
+		CHECK ( in.read_i32() == -4711 );
+		CHECK ( in.read_checksums() == checksums );
+		CHECK ( in.remaining() == 0 );
+	}
+
+
+	SECTION ("Reading beyond the end fails")
+	{
+		auto in { CheckpointReader { data.data(), 6 } };
+
+		CHECK ( in.read_u32() == 0xDEADBEEF );
+		CHECK_THROWS_AS ( in.read_u32(), std::invalid_argument );
+	}
+}
+
+
+TEST_CASE ( "Calculation checkpoint and restore", "[checkpoint] [calc]" )
+{
+	using arcstk::Algorithm;
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AccurateRip::V1andV2withFrame450;
+	using arcstk::ChecksumtypeSet;
+	using arcstk::CompositeAlgorithm;
+	using arcstk::make_calculation;
+	using arcstk::make_toc;
+	using type = arcstk::checksum::type;
+
+	const auto toc { fixtures::album_toc() };
+
+	auto samples { fixtures::ascending_samples(fixtures::album_leadout, 7u) };
+
+	// Interrupt the calculation within the second track
+	const auto split { std::size_t { 6000 * 588 + 17 } };
+
+	// Calculate with a checkpoint at split and resume a new Calculation
+	const auto resumed_result = [&](std::unique_ptr<Algorithm> a,
+			std::unique_ptr<Algorithm> b)
+	{
+		auto first { make_calculation(std::move(a), *toc) };
+		first->update(samples.data(), samples.data() + split);
+
+		const auto checkpoint { first->checkpoint() };
+
+		auto second { make_calculation(std::move(b), *toc) };
+		second->restore(checkpoint);
+
+		const auto offset { static_cast<std::size_t>(second->current_offset()) };
+
+		second->update(samples.data() + offset, samples.data() + samples.size());
+
+		REQUIRE ( second->complete() );
+
+		return second->result();
+	};
+
+	const auto direct_result = [&](std::unique_ptr<Algorithm> a)
+	{
+		auto calculation { make_calculation(std::move(a), *toc) };
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		return calculation->result();
+	};
+
+
+	SECTION ("Restored Calculation with V1andV2 has the correct result")
+	{
+		CHECK ( resumed_result(std::make_unique<V1andV2>(),
+					std::make_unique<V1andV2>())
+				== direct_result(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Restored Calculation with V1andV2withFrame450 has the correct"
+			" result")
+	{
+		CHECK ( resumed_result(std::make_unique<V1andV2withFrame450>(),
+					std::make_unique<V1andV2withFrame450>())
+				== direct_result(std::make_unique<V1andV2withFrame450>()) );
+	}
+
+
+	SECTION ("Restored Calculation retains the windows around frame 450")
+	{
+		using arcstk::accuraterip::details::ARCSFrame450Base;
+
+		// Interrupt the calculation within the window of the second track
+		const auto within { std::size_t { (5225 + 450) * 588 + 100 } };
+
+		auto first { make_calculation(
+				std::make_unique<V1andV2withFrame450>(1000), *toc) };
+		first->update(samples.data(), samples.data() + within);
+
+		auto second { make_calculation(
+				std::make_unique<V1andV2withFrame450>(1000), *toc) };
+		second->restore(first->checkpoint());
+		second->update(samples.data() + within,
+				samples.data() + samples.size());
+
+		auto direct { make_calculation(
+				std::make_unique<V1andV2withFrame450>(1000), *toc) };
+		direct->update(samples.data(), samples.data() + samples.size());
+
+		REQUIRE ( second->complete() );
+		CHECK ( second->result() == direct->result() );
+
+		const auto resumed { dynamic_cast<const ARCSFrame450Base*>(
+				second->algorithm()) };
+		const auto expected { dynamic_cast<const ARCSFrame450Base*>(
+				direct->algorithm()) };
+
+		REQUIRE ( resumed  );
+		REQUIRE ( expected );
+
+		for (auto t = 1; t <= 3; ++t)
+		{
+			CHECK ( not resumed->frame450_window(t).empty() );
+			CHECK ( resumed->frame450_window(t)
+					== expected->frame450_window(t) );
+		}
+	}
+
+
+	SECTION ("Checkpoint with windows for another maximal offset is rejected")
+	{
+		auto first { make_calculation(
+				std::make_unique<V1andV2withFrame450>(1000), *toc) };
+		auto second { make_calculation(
+				std::make_unique<V1andV2withFrame450>(2000), *toc) };
+
+		CHECK_THROWS_AS ( second->restore(first->checkpoint()),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Restored Calculation with CompositeAlgorithm has the correct"
+			" result")
+	{
+		const auto types { ChecksumtypeSet { type::ARCS1, type::ARCS2,
+			type::CRC32, type::CRC32ns, type::CTDB } };
+
+		CHECK ( resumed_result(std::make_unique<CompositeAlgorithm>(types),
+					std::make_unique<CompositeAlgorithm>(types))
+				== direct_result(std::make_unique<CompositeAlgorithm>(types)) );
+	}
+
+
+	SECTION ("Checkpoint of other checksum types is rejected")
+	{
+		auto first { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		auto second { make_calculation(
+				std::make_unique<V1andV2withFrame450>(), *toc) };
+
+		CHECK_THROWS_AS ( second->restore(first->checkpoint()),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Checkpoint of other offsets is rejected")
+	{
+		const auto other { make_toc(fixtures::album_leadout,
+				{ 33, 5225, 7391 }) };
+
+		auto first { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		auto second { make_calculation(std::make_unique<V1andV2>(), *other) };
+
+		CHECK_THROWS_AS ( second->restore(first->checkpoint()),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Checkpoint of another sub-range is rejected")
+	{
+		const auto last { static_cast<int32_t>(samples.size()) - 1 };
+
+		auto first { make_calculation(std::make_unique<V1andV2>(), *toc,
+				static_cast<int32_t>(split), last) };
+
+		auto full { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		auto other { make_calculation(std::make_unique<V1andV2>(), *toc,
+				static_cast<int32_t>(split) + 1, last) };
+
+		CHECK_THROWS_AS ( full->restore(first->checkpoint()),
+				std::invalid_argument );
+		CHECK_THROWS_AS ( other->restore(first->checkpoint()),
+				std::invalid_argument );
+		CHECK_THROWS_AS ( first->restore(full->checkpoint()),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Restored partial Calculations can be merged")
+	{
+		using arcstk::merge;
+
+		const auto last { static_cast<int32_t>(samples.size()) - 1 };
+
+		// Each sub-range is calculated on its own node
+		auto head { make_calculation(std::make_unique<V1andV2>(), *toc,
+				0, static_cast<int32_t>(split) - 1) };
+		head->update(samples.data(), samples.data() + split);
+
+		auto tail { make_calculation(std::make_unique<V1andV2>(), *toc,
+				static_cast<int32_t>(split), last) };
+		tail->update(samples.data() + split, samples.data() + samples.size());
+
+		// The merging node restores the checkpoint of the other node
+		auto restored { make_calculation(std::make_unique<V1andV2>(), *toc,
+				static_cast<int32_t>(split), last) };
+		restored->restore(tail->checkpoint());
+
+		REQUIRE ( restored->complete() );
+
+		CHECK ( merge({ head.get(), restored.get() })
+				== direct_result(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Truncated or corrupt checkpoint is rejected and has no effect")
+	{
+		auto first { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		first->update(samples.data(), samples.data() + split);
+
+		auto checkpoint { first->checkpoint() };
+
+		auto second { make_calculation(std::make_unique<V1andV2>(), *toc) };
+
+		auto truncated { checkpoint };
+		truncated.pop_back();
+
+		CHECK_THROWS_AS ( second->restore(truncated), std::invalid_argument );
+		CHECK ( second->current_offset() == 0 );
+
+		checkpoint[0] ^= 0xFF;
+
+		CHECK_THROWS_AS ( second->restore(checkpoint), std::invalid_argument );
+		CHECK ( second->current_offset() == 0 );
+	}
+}
+
@@ -10,7 +10,11 @@
 #include "checksum.hpp"           // TO BE TESTED
 #endif
 
+#include <functional>             // for hash
+#include <type_traits>            // for is_const, remove_reference_t
+#include <unordered_set>          // for unordered_set
 #include <utility>                // for move
+#include <vector>                 // for vector
 
 
 TEST_CASE ( "checksum::type_name provides correct names",
@@ -21,8 +25,10 @@ TEST_CASE ( "checksum::type_name provides correct names",
 
 	CHECK ( type_name(type::ARCS1) == "ARCSv1" );
 	CHECK ( type_name(type::ARCS2) == "ARCSv2" );
-	//CHECK ( type_name(type::CRC32)   == "CRC32" );
-	//CHECK ( type_name(type::CRC32ns) == "CRC32ns" );
+	CHECK ( type_name(type::FRAME450) == "ARCS450" );
+	CHECK ( type_name(type::CRC32)    == "CRC32" );
+	CHECK ( type_name(type::CRC32ns)  == "CRC32ns" );
+	CHECK ( type_name(type::CTDB)     == "CTDB" );
 }
 
 
@@ -55,6 +61,135 @@ TEST_CASE ( "Checksum", "[checksum] [calc]" )
 }
 
 
+TEST_CASE ( "ChecksumtypeSet", "[checksumtypeset] [calc]" )
+{
+	using arcstk::checksum::type;
+	using arcstk::ChecksumtypeSet;
+
+	auto types { ChecksumtypeSet { type::CRC32, type::ARCS2, type::ARCS2 } };
+
+
+	SECTION ( "construction is correct" )
+	{
+		CHECK ( ChecksumtypeSet{}.empty() );
+		CHECK ( ChecksumtypeSet{}.size() == 0 );
+
+		CHECK ( not types.empty() );
+		CHECK ( types.size() == 2 );
+		CHECK ( types.contains(type::ARCS2) );
+		CHECK ( types.contains(type::CRC32) );
+		CHECK ( not types.contains(type::ARCS1) );
+		CHECK ( types.count(type::CRC32) == 1 );
+		CHECK ( types.count(type::CTDB)  == 0 );
+		CHECK ( types.mask() == 10 );
+	}
+
+
+	SECTION ( "insert(type) inserts new types only" )
+	{
+		const auto existing { types.insert(type::ARCS2) };
+
+		CHECK ( not existing.second );
+		CHECK ( *existing.first == type::ARCS2 );
+
+		const auto inserted { types.insert(type::ARCS1) };
+
+		CHECK ( inserted.second );
+		CHECK ( *inserted.first == type::ARCS1 );
+		CHECK ( types.size() == 3 );
+	}
+
+
+	SECTION ( "erase(type) erases present types only" )
+	{
+		CHECK ( types.erase(type::ARCS1) == 0 );
+		CHECK ( types.erase(type::ARCS2) == 1 );
+		CHECK ( types == ChecksumtypeSet { type::CRC32 } );
+
+		types.clear();
+
+		CHECK ( types.empty() );
+	}
+
+
+	SECTION ( "types are iterated in the order of their values" )
+	{
+		types.insert(type::CTDB);
+		types.insert(type::ARCS1);
+
+		auto visited { std::vector<type> {} };
+		for (const auto& t : types)
+		{
+			visited.push_back(t);
+		}
+
+		CHECK ( visited == std::vector<type>{ type::ARCS1, type::ARCS2,
+				type::CRC32, type::CTDB } );
+	}
+
+
+	SECTION ( "equality does not depend on the order of insertion" )
+	{
+		CHECK ( types == ChecksumtypeSet { type::ARCS2, type::CRC32 } );
+		CHECK ( types != ChecksumtypeSet { type::ARCS2 } );
+	}
+
+
+	SECTION ( "find(type) finds present types only" )
+	{
+		CHECK ( types.find(type::ARCS1) == types.end() );
+		REQUIRE ( types.find(type::CRC32) != types.end() );
+		CHECK ( *types.find(type::CRC32) == type::CRC32 );
+	}
+
+
+	SECTION ( "emplace(type) and erase(iterator) are correct" )
+	{
+		CHECK ( types.emplace(type::CTDB).second );
+		CHECK ( not types.emplace(type::CTDB).second );
+
+		const auto next { types.erase(types.find(type::CRC32)) };
+
+		REQUIRE ( next != types.end() );
+		CHECK ( *next == type::CTDB );
+		CHECK ( types == ChecksumtypeSet { type::ARCS2, type::CTDB } );
+	}
+
+
+	SECTION ( "range construction is correct" )
+	{
+		const auto v { std::vector<type> { type::CTDB, type::ARCS1,
+			type::ARCS1 } };
+
+		CHECK ( ChecksumtypeSet(v.begin(), v.end()) ==
+				ChecksumtypeSet { type::ARCS1, type::CTDB } );
+	}
+
+
+	SECTION ( "conversion from and to std::unordered_set is correct" )
+	{
+		const auto u { std::unordered_set<type> { type::ARCS2, type::CRC32 } };
+
+		CHECK ( types == u );
+		CHECK ( u == types );
+		CHECK ( ChecksumtypeSet { u } == types );
+		CHECK ( std::unordered_set<type> { types } == u );
+	}
+
+
+	SECTION ( "hash is equal for equal sets" )
+	{
+		const auto hash { std::hash<ChecksumtypeSet>{} };
+
+		CHECK ( hash(types) == hash(ChecksumtypeSet { type::CRC32,
+					type::ARCS2 }) );
+
+		auto sets { std::unordered_set<ChecksumtypeSet> { types } };
+		CHECK ( sets.count(ChecksumtypeSet { type::ARCS2, type::CRC32 }) == 1 );
+	}
+}
+
+
 TEST_CASE ( "ChecksumSet", "[checksumset] [calc]" )
 {
 	using arcstk::checksum::type;
@@ -197,6 +332,52 @@ TEST_CASE ( "ChecksumSet", "[checksumset] [calc]" )
 	}
 
 
+	SECTION ( "entries are iterated in the order of their types" )
+	{
+		track01.insert(type::CTDB,  Checksum(0x11111111));
+		track01.insert(type::CRC32, Checksum(0x22222222));
+		track01.erase(type::ARCS2);
+
+		auto types { std::vector<type> {} };
+		for (const auto& entry : track01)
+		{
+			types.push_back(entry.first);
+		}
+
+		CHECK ( types == std::vector<type>{ type::ARCS1, type::CRC32,
+				type::CTDB } );
+		CHECK ( track01.get(type::CRC32) == Checksum(0x22222222) );
+		CHECK ( track01.get(type::CTDB)  == Checksum(0x11111111) );
+		CHECK ( track01.get(type::ARCS2).empty() );
+	}
+
+
+	SECTION ( "equality does not depend on the order of insertion" )
+	{
+		ChecksumSet track02 { track01.length() };
+		track02.insert(type::ARCS1, Checksum(0x98B10E0F));
+		track02.insert(type::ARCS2, Checksum(0xB89992E5));
+
+		CHECK ( track02 == track01 );
+
+		track02.erase(type::ARCS2);
+
+		CHECK ( track02 != track01 );
+	}
+
+
+	SECTION ( "keys are not modifiable by iterators" )
+	{
+		using key = decltype(track01.begin()->first);
+
+		CHECK ( std::is_const<std::remove_reference_t<key>>::value );
+
+		track01.begin()->second = Checksum(0x11111111);
+
+		CHECK ( track01.get(type::ARCS1) == Checksum(0x11111111) );
+	}
+
+
 	SECTION ( "iterator begin() points to first entry" )
 	{
 		auto it { track01.begin()  };
@@ -0,0 +1,320 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for composite.hpp.
+ */
+
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#include "composite.hpp"          // TO BE TESTED
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for AccurateRip::V1andV2, ...
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for make_calculation
+#endif
+#ifndef __LIBARCSTK_CHECKSUM_HPP__
+#include "checksum.hpp"           // for checksum::type
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for make_toc
+#endif
+
+#include "fixtures.hpp"           // for album_toc, random_samples, ...
+
+#include <algorithm>              // for min
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <memory>                 // for make_unique
+#include <stdexcept>              // for invalid_argument, logic_error
+#include <vector>                 // for vector
+
+
+namespace
+{
+
+/**
+ * \brief Bytewise reference implementation of the CRC32 of little endian
+ * samples.
+ */
+uint32_t reference_crc32(const uint32_t* start, const uint32_t* stop,
+		const bool skip_nulls)
+{
+	auto crc = uint32_t { 0xFFFFFFFF };
+
+	for (auto s { start }; s != stop; ++s)
+	{
+		for (auto shift = 0; shift < 32; shift += 16)
+		{
+			const auto word { (*s >> shift) & 0xFFFF };
+
+			if (skip_nulls && word == 0)
+			{
+				continue;
+			}
+
+			for (const auto byte : { word & 0xFF, word >> 8 })
+			{
+				crc ^= byte;
+
+				for (auto k = 0; k < 8; ++k)
+				{
+					crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+				}
+			}
+		}
+	}
+
+	return ~crc;
+}
+
+} // namespace
+
+
+TEST_CASE ( "CompositeAlgorithm", "[composite] [calc]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AccurateRip::V1andV2withFrame450;
+	using arcstk::ChecksumtypeSet;
+	using arcstk::CompositeAlgorithm;
+	using arcstk::make_calculation;
+	using type = arcstk::checksum::type;
+
+	const auto offsets { fixtures::album_offsets() };
+	const auto leadout { fixtures::album_leadout };
+	const auto toc     { fixtures::album_toc() };
+
+	auto samples { fixtures::random_samples(leadout, 0x12345678) };
+
+	// Let some samples have a silent channel
+	for (auto& s : samples)
+	{
+		s = (s % 5 == 0) ? s & 0xFFFF0000 : s;
+	}
+
+	// Bounds of the tracks
+	const auto track_start = [&samples,&offsets,leadout](const std::size_t t)
+	{
+		return samples.data() + (t < offsets.size()
+			? static_cast<std::size_t>(offsets[t])
+			: static_cast<std::size_t>(leadout)) * 588;
+	};
+
+	const auto block_size { std::size_t { 100003 } };
+
+
+	SECTION ("Construction without types fails")
+	{
+		CHECK_THROWS_AS ( CompositeAlgorithm(ChecksumtypeSet{}),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Types are as requested")
+	{
+		const auto types { ChecksumtypeSet{ type::ARCS2, type::CRC32 } };
+
+		CHECK ( CompositeAlgorithm(types).types() == types );
+	}
+
+
+	SECTION ("All types are calculated in a single pass")
+	{
+		auto reference { make_calculation(
+				std::make_unique<V1andV2withFrame450>(), *toc) };
+		reference->update(samples.data(), samples.data() + samples.size());
+
+		auto calculation { make_calculation(std::make_unique<CompositeAlgorithm>(
+				ChecksumtypeSet{ type::ARCS1, type::ARCS2, type::FRAME450,
+					type::CRC32, type::CRC32ns, type::CTDB }), *toc) };
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			const auto end { std::min(i + block_size, samples.size()) };
+			calculation->update(samples.data() + i, samples.data() + end);
+		}
+
+		REQUIRE ( calculation->complete() );
+
+		const auto result   { calculation->result() };
+		const auto expected { reference->result() };
+
+		REQUIRE ( result.size() == 3 );
+
+		for (auto t = std::size_t { 0 }; t < result.size(); ++t)
+		{
+			CHECK ( result[t].get(type::ARCS1) == expected[t].get(type::ARCS1) );
+			CHECK ( result[t].get(type::ARCS2) == expected[t].get(type::ARCS2) );
+			CHECK ( result[t].get(type::FRAME450)
+					== expected[t].get(type::FRAME450) );
+
+			CHECK ( result[t].get(type::CRC32).value() ==
+				reference_crc32(track_start(t), track_start(t + 1), false) );
+			CHECK ( result[t].get(type::CRC32ns).value() ==
+				reference_crc32(track_start(t), track_start(t + 1), true) );
+
+			CHECK ( result[t].length() ==
+				(track_start(t + 1) - track_start(t)) / 588 );
+		}
+
+		CHECK ( result[2].get(type::CTDB).value() ==
+			reference_crc32(track_start(0) + 10 * 588, track_start(3) - 10 * 588,
+				false) );
+	}
+
+
+	SECTION ("Only ARCS types have the range of the AccurateRip algorithm")
+	{
+		auto reference { make_calculation(std::make_unique<V1andV2>(), *toc) };
+		reference->update(samples.data(), samples.data() + samples.size());
+
+		auto calculation { make_calculation(std::make_unique<CompositeAlgorithm>(
+				ChecksumtypeSet{ type::ARCS2 }), *toc) };
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		const auto result   { calculation->result() };
+		const auto expected { reference->result() };
+
+		REQUIRE ( result.size() == 3 );
+
+		for (auto t = std::size_t { 0 }; t < result.size(); ++t)
+		{
+			CHECK ( result[t].size() == 1 );
+			CHECK ( result[t].get(type::ARCS2) == expected[t].get(type::ARCS2) );
+			CHECK ( result[t].length() == expected[t].length() );
+		}
+	}
+
+
+	SECTION ("Only CTDB is calculated correctly")
+	{
+		auto calculation { make_calculation(std::make_unique<CompositeAlgorithm>(
+				ChecksumtypeSet{ type::CTDB }), *toc) };
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			const auto end { std::min(i + block_size, samples.size()) };
+			calculation->update(samples.data() + i, samples.data() + end);
+		}
+
+		REQUIRE ( calculation->complete() );
+
+		CHECK ( calculation->result()[2].get(type::CTDB).value() ==
+			reference_crc32(track_start(0) + 10 * 588, track_start(3) - 10 * 588,
+				false) );
+	}
+
+
+	SECTION ("CTDB is only reported for the last track")
+	{
+		auto calculation { make_calculation(std::make_unique<CompositeAlgorithm>(
+				ChecksumtypeSet{ type::CRC32, type::CTDB }), *toc) };
+
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		const auto result { calculation->result() };
+
+		CHECK ( not result[0].contains(type::CTDB) );
+		CHECK ( not result[1].contains(type::CTDB) );
+		CHECK ( result[2].contains(type::CTDB) );
+
+		for (const auto& checksums : result)
+		{
+			CHECK ( checksums.contains(type::CRC32) );
+		}
+	}
+
+
+	SECTION ("Updating the size does not rewind the calculation")
+	{
+		using arcstk::AudioSize;
+		using arcstk::UNIT;
+
+		const auto types { ChecksumtypeSet{ type::ARCS2, type::CTDB } };
+
+		auto reference { make_calculation(
+				std::make_unique<CompositeAlgorithm>(types), *toc) };
+		reference->update(samples.data(), samples.data() + samples.size());
+
+		auto calculation { make_calculation(
+				std::make_unique<CompositeAlgorithm>(types), *toc) };
+
+		const auto half { samples.data() + samples.size() / 2 };
+
+		calculation->update(samples.data(), half);
+		calculation->update(AudioSize { leadout, UNIT::FRAMES });
+		calculation->update(half, samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		CHECK ( calculation->result() == reference->result() );
+		CHECK ( calculation->result()[2].get(type::CTDB).value() ==
+			reference_crc32(track_start(0) + 10 * 588, track_start(3) - 10 * 588,
+				false) );
+	}
+
+
+	SECTION ("Partial calculations of ARCS types and CRC32 can be merged")
+	{
+		using arcstk::Calculation;
+		using arcstk::merge;
+
+		const auto types { ChecksumtypeSet{ type::ARCS1, type::ARCS2,
+			type::CRC32 } };
+
+		auto reference { make_calculation(
+				std::make_unique<CompositeAlgorithm>(types), *toc) };
+		reference->update(samples.data(), samples.data() + samples.size());
+
+		// Split before the range of ARCS, within track 2 and at track 3
+		const auto splits { std::vector<int32_t> { 0, offsets[0] * 588 + 1000,
+			6000 * 588 + 17, offsets[2] * 588,
+			static_cast<int32_t>(samples.size()) } };
+
+		auto calculations { std::vector<std::unique_ptr<Calculation>> {} };
+		auto partials     { std::vector<const Calculation*> {} };
+
+		for (auto i = std::size_t { 1 }; i < splits.size(); ++i)
+		{
+			calculations.push_back(make_calculation(
+				std::make_unique<CompositeAlgorithm>(types), *toc,
+				splits[i - 1], splits[i] - 1));
+
+			calculations.back()->update(
+					samples.data() + static_cast<std::size_t>(splits[i - 1]),
+					samples.data() + static_cast<std::size_t>(splits[i]));
+
+			REQUIRE ( calculations.back()->complete() );
+
+			partials.push_back(calculations.back().get());
+		}
+
+		CHECK ( merge(partials) == reference->result() );
+	}
+
+
+	SECTION ("Partial calculations of CRC32ns or CTDB are rejected")
+	{
+		using arcstk::ChecksumSet;
+
+		for (const auto t : { type::CRC32ns, type::CTDB })
+		{
+			CHECK_THROWS_AS ( make_calculation(
+					std::make_unique<CompositeAlgorithm>(ChecksumtypeSet{ t }),
+					*toc, offsets[0] * 588 + 1000,
+					static_cast<int32_t>(samples.size()) - 1),
+				std::logic_error );
+
+			CHECK_THROWS_AS ( CompositeAlgorithm(ChecksumtypeSet{ t }).merge(
+					ChecksumSet {}, ChecksumSet {}, 1000), std::logic_error );
+		}
+	}
+}
+
@@ -0,0 +1,145 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for composite_details.hpp.
+ */
+
+#ifndef __LIBARCSTK_COMPOSITE_HPP__
+#include "composite.hpp"
+#endif
+#ifndef __LIBARCSTK_COMPOSITE_DETAILS_HPP__
+#include "composite_details.hpp"  // TO BE TESTED
+#endif
+
+#include <cstdint>                // for uint32_t, uint64_t
+#include <random>                 // for mt19937, uniform_int_distribution
+#include <vector>                 // for vector
+
+
+namespace
+{
+
+/**
+ * \brief Bitwise reference implementation of the CRC32 of little endian
+ * samples.
+ */
+uint32_t reference_crc32(const std::vector<uint32_t>& samples,
+		const bool skip_nulls)
+{
+	auto crc = uint32_t { 0xFFFFFFFF };
+
+	const auto update = [&crc](const uint32_t byte)
+	{
+		crc ^= byte;
+
+		for (auto k = 0; k < 8; ++k)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+		}
+	};
+
+	for (const auto& s : samples)
+	{
+		for (auto shift = 0; shift < 32; shift += 16)
+		{
+			const auto word { (s >> shift) & 0xFFFF };
+
+			if (skip_nulls && word == 0)
+			{
+				continue;
+			}
+
+			update(word & 0xFF);
+			update(word >> 8);
+		}
+	}
+
+	return ~crc;
+}
+
+} // namespace
+
+
+TEST_CASE ( "CRC32 kernels", "[crc] [calc]" )
+{
+	using arcstk::details::crc::CRC32Pair;
+	using arcstk::details::crc::combine_crc32;
+	using arcstk::details::crc::update_crc32;
+	using arcstk::details::crc::update_crc32_pair;
+	using arcstk::details::crc::update_crc32_skip_nulls;
+
+	auto engine       = std::mt19937 { 4711 };
+	auto distribution = std::uniform_int_distribution<uint32_t> {};
+
+	auto samples = std::vector<uint32_t>(10007);
+	for (auto& s : samples)
+	{
+		s = distribution(engine);
+	}
+
+	// Insert null samples of either and of both channels
+	for (auto i = std::size_t { 0 }; i < samples.size(); i += 7)
+	{
+		samples[i] &= (i % 3 == 0) ? 0xFFFF0000 : (i % 3 == 1) ? 0x0000FFFF : 0;
+	}
+
+	const auto first { samples.data() };
+	const auto last  { samples.data() + samples.size() };
+
+
+	SECTION ("update_crc32() computes CRC32 of known input")
+	{
+		// CRC32 of the bytes "1234" and "5678", i.e. of "12345678"
+		const auto input { std::vector<uint32_t>{ 0x34333231, 0x38373635 } };
+
+		CHECK ( update_crc32(0, input.data(), input.data() + 2) == 0x9AE0DAAF );
+	}
+
+
+	SECTION ("update_crc32() is equal to the reference")
+	{
+		CHECK ( update_crc32(0, first, last) == reference_crc32(samples, false));
+	}
+
+
+	SECTION ("update_crc32() can be continued")
+	{
+		const auto crc1 { update_crc32(0, first, first + 1000) };
+
+		CHECK ( update_crc32(crc1, first + 1000, last)
+				== reference_crc32(samples, false) );
+	}
+
+
+	SECTION ("update_crc32_skip_nulls() is equal to the reference")
+	{
+		CHECK ( update_crc32_skip_nulls(0, first, last)
+				== reference_crc32(samples, true) );
+	}
+
+
+	SECTION ("update_crc32_pair() is equal to the single CRCs")
+	{
+		const auto crc1 { update_crc32_pair({ 0, 0 }, first, first + 1000) };
+		const auto crcs { update_crc32_pair(crc1, first + 1000, last) };
+
+		CHECK ( crcs.crc    == reference_crc32(samples, false) );
+		CHECK ( crcs.crc_ns == reference_crc32(samples, true)  );
+	}
+
+
+	SECTION ("combine_crc32() is equal to the CRC32 of the concatenation")
+	{
+		const auto crc1 { update_crc32(0, first, first + 4711) };
+		const auto crc2 { update_crc32(0, first + 4711, last) };
+		const auto len2 { static_cast<uint64_t>(last - first - 4711) * 4 };
+
+		CHECK ( combine_crc32(crc1, crc2, len2)
+				== reference_crc32(samples, false) );
+		CHECK ( combine_crc32(crc1, 0, 0) == crc1 );
+		CHECK ( combine_crc32(0, crc2, len2) == crc2 );
+	}
+}
+
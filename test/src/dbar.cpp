@@ -12,11 +12,19 @@
 #ifndef __LIBARCSTK_DBAR_DETAILS_HPP__
 #include "dbar_details.hpp"       // for parse_dbar_stream
 #endif
+#ifndef __LIBARCSTK_IDENTIFIER_HPP__
+#include "identifier.hpp"         // for ARId
+#endif
 
+#include <algorithm>              // for min
+#include <cstddef>                // for size_t
+#include <cstdint>                // for uint8_t, uint32_t, uint64_t
 #include <fstream>                // for ifstream
-#include <stdexcept>              // for runtime_error
+#include <iterator>               // for istreambuf_iterator
+#include <stdexcept>              // for runtime_error, logic_error, ...
 #include <string>                 // for string
 #include <utility>                // for move
+#include <vector>                 // for vector
 
 
 TEST_CASE ( "DBARBlock", "[dbarblock] [dbar]" )
@@ -421,3 +429,524 @@ TEST_CASE ( "DBAR", "[dbar]" )
 
 }
 
+
+
+TEST_CASE ( "DBAR with blocks of different sizes", "[dbar]" )
+{
+	using arcstk::DBAR;
+
+	const auto dBAR = DBAR {
+		{ { 2, 0x00000001, 0x00000002, 0x00000003 },
+		{ /* triplets */
+			{ 0x11111111,  1, 0x1111AAAA },
+			{ 0x22222222,  2, 0x2222AAAA }
+		} },
+		{ { 4, 0x00000004, 0x00000005, 0x00000006 },
+		{ /* triplets */
+			{ 0x33333333,  3, 0x3333AAAA },
+			{ 0x44444444,  4, 0x4444AAAA },
+			{ 0x55555555,  5, 0x5555AAAA },
+			{ 0x66666666,  6, 0x6666AAAA }
+		} },
+		{ { 1, 0x00000007, 0x00000008, 0x00000009 },
+		{ /* triplets */
+			{ 0x77777777,  7, 0x7777AAAA }
+		} }
+	};
+
+	REQUIRE ( dBAR.size() == 3 );
+
+
+	SECTION ( "Headers are addressed correctly" )
+	{
+		CHECK ( dBAR.block(1).header().total_tracks() == 4 );
+		CHECK ( dBAR.block(1).header().id1() == 0x00000004 );
+		CHECK ( dBAR.block(2).header().total_tracks() == 1 );
+		CHECK ( dBAR.block(2).header().cddb_id() == 0x00000009 );
+	}
+
+
+	SECTION ( "Sizes of the blocks are correct" )
+	{
+		CHECK ( dBAR.size(0) == 2 );
+		CHECK ( dBAR.size(1) == 4 );
+		CHECK ( dBAR.size(2) == 1 );
+	}
+
+
+	SECTION ( "Triplets are addressed correctly" )
+	{
+		const auto last_of_1 { dBAR.block(1).triplet(3) };
+
+		CHECK ( last_of_1.arcs() == 0x66666666 );
+		CHECK ( last_of_1.confidence() == 6 );
+		CHECK ( last_of_1.frame450_arcs() == 0x6666AAAA );
+
+		const auto first_of_2 { dBAR.block(2).triplet(0) };
+
+		CHECK ( first_of_2.arcs() == 0x77777777 );
+		CHECK ( first_of_2.confidence() == 7 );
+		CHECK ( first_of_2.frame450_arcs() == 0x7777AAAA );
+	}
+}
+
+
+TEST_CASE ( "DBARView", "[dbarview] [dbar]" )
+{
+	using arcstk::DBARView;
+	using arcstk::load_file;
+
+	const auto dBAR { load_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+	const auto view { DBARView { "dBAR-015-001b9178-014be24e-b40d2d0f.bin" } };
+
+
+	SECTION ( "DBARView on a file has the same values as the loaded DBAR" )
+	{
+		CHECK ( view.bytes() == 444 );
+
+		REQUIRE ( view.size() == dBAR.size() );
+
+		for (auto b = std::size_t { 0 }; b < view.size(); ++b)
+		{
+			CHECK ( view.header(b) == dBAR.header(b) );
+			CHECK ( view.id(b) == dBAR.block(b).id() );
+
+			REQUIRE ( view.size(b) == dBAR.size(b) );
+
+			for (auto t = std::size_t { 0 }; t < view.size(b); ++t)
+			{
+				CHECK ( view.triplet(b, t) == dBAR.triplet(b, t) );
+				CHECK ( view.arcs_value(b, t) == dBAR.arcs_value(b, t) );
+				CHECK ( view.confidence_value(b, t)
+						== dBAR.confidence_value(b, t) );
+				CHECK ( view.frame450_arcs_value(b, t)
+						== dBAR.frame450_arcs_value(b, t) );
+			}
+		}
+	}
+
+
+	SECTION ( "DBARView on a buffer decodes little endian values" )
+	{
+		const auto bytes { std::vector<uint8_t> {
+			0x01, 0x78, 0x91, 0x1B, 0x00, 0x4E, 0xE2, 0x4B, 0x01,
+				0x0F, 0x2D, 0x0D, 0xB4,
+			0x18, 0xE5, 0x92, 0x99, 0xB8, 0x5E, 0x87, 0x6D, 0x12,
+			0x02, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+				0x03, 0x00, 0x00, 0x00,
+			0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99,
+			0x07, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x01
+		} };
+
+		const auto buffer_view { DBARView { bytes.data(), bytes.size() } };
+
+		REQUIRE ( buffer_view.size() == 2 );
+
+		CHECK ( buffer_view.size(0) == 1 );
+		CHECK ( buffer_view.header(0).id1() == 0x001B9178 );
+		CHECK ( buffer_view.header(0).id2() == 0x014BE24E );
+		CHECK ( buffer_view.header(0).cddb_id() == 0xB40D2D0F );
+		CHECK ( buffer_view.arcs_value(0, 0) == 0xB89992E5 );
+		CHECK ( buffer_view.confidence_value(0, 0) == 24 );
+		CHECK ( buffer_view.frame450_arcs_value(0, 0) == 0x126D875E );
+
+		CHECK ( buffer_view.size(1) == 2 );
+		CHECK ( buffer_view.header(1).cddb_id() == 0x00000003 );
+		CHECK ( buffer_view.triplet(1, 0).arcs() == 0x55443322 );
+		CHECK ( buffer_view.triplet(1, 0).confidence() == 0x11 );
+		CHECK ( buffer_view.triplet(1, 0).frame450_arcs() == 0x99887766 );
+		CHECK ( buffer_view.triplet(1, 1).arcs() == 0xDDCCBBAA );
+		CHECK ( buffer_view.triplet(1, 1).confidence() == 7 );
+		CHECK ( buffer_view.triplet(1, 1).frame450_arcs() == 0x0100FFEE );
+	}
+
+
+	SECTION ( "DBARView on an empty buffer is empty" )
+	{
+		const auto bytes { std::vector<uint8_t> {} };
+
+		CHECK ( DBARView { bytes.data(), bytes.size() }.empty() );
+	}
+
+
+	SECTION ( "DBARView on an incomplete header fails" )
+	{
+		try
+		{
+			DBARView { "dBAR-015-001b9178-014be24e-b40d2d0f_H+01.bin" };
+
+			FAIL ( "Expected StreamParseException was not thrown" );
+		} catch (const arcstk::StreamParseException &e)
+		{
+			CHECK ( e.block()               == 2 );
+			CHECK ( e.block_byte_position() == 1 );
+			CHECK ( e.byte_position()       == 149 );
+		}
+	}
+
+
+	SECTION ( "DBARView on an incomplete triplet fails" )
+	{
+		try
+		{
+			DBARView { "dBAR-015-001b9178-014be24e-b40d2d0f_T+5.bin" };
+
+			FAIL ( "Expected StreamParseException was not thrown" );
+		} catch (const arcstk::StreamParseException &e)
+		{
+			CHECK ( e.block() == 2 );
+		}
+	}
+
+
+	SECTION ( "DBARView on a missing file fails" )
+	{
+		CHECK_THROWS_AS ( DBARView { "no-such-file.bin" }, std::runtime_error );
+	}
+}
+
+
+TEST_CASE ( "parse_buffer", "[parse_buffer] [dbar]" )
+{
+	using arcstk::DBARBuilder;
+	using arcstk::load_file;
+	using arcstk::parse_buffer;
+
+	std::ifstream file { "dBAR-015-001b9178-014be24e-b40d2d0f.bin",
+		std::ifstream::in | std::ifstream::binary };
+
+	const auto bytes { std::vector<uint8_t> {
+		std::istreambuf_iterator<char> { file },
+		std::istreambuf_iterator<char> {} } };
+
+	REQUIRE ( bytes.size() == 444 );
+
+	auto builder = DBARBuilder {};
+
+	CHECK ( parse_buffer(bytes.data(), bytes.size(), &builder, nullptr)
+			== 444 );
+
+	auto parsed { builder.result() };
+	auto loaded { load_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+
+	CHECK ( parsed.equals(loaded) );
+}
+
+
+/**
+ * \brief Handler for parse_buffer() that only counts the values.
+ */
+struct CountingHandler final
+{
+	int      blocks     = 0;
+	int      triplets   = 0;
+	int      input_ends = 0;
+	uint64_t arcs       = 0;
+
+	void start_input()
+	{
+		// empty
+	}
+
+	void start_block()
+	{
+		++blocks;
+	}
+
+	void header(const uint8_t, const uint32_t, const uint32_t,
+			const uint32_t)
+	{
+		// empty
+	}
+
+	void triplet(const uint32_t arcs_value, const uint8_t, const uint32_t)
+	{
+		++triplets;
+		arcs += arcs_value;
+	}
+
+	void end_block()
+	{
+		// empty
+	}
+
+	void end_input()
+	{
+		++input_ends;
+	}
+};
+
+
+/**
+ * \brief Error handler for parse_buffer() that only counts the errors.
+ */
+struct CountingErrorHandler final
+{
+	int errors = 0;
+
+	void on_error(const unsigned, const unsigned, const unsigned)
+	{
+		++errors;
+	}
+};
+
+
+TEST_CASE ( "parse_buffer with static handlers", "[parse_buffer] [dbar]" )
+{
+	using arcstk::DBARBuilder;
+	using arcstk::load_file;
+	using arcstk::parse_buffer;
+
+	std::ifstream file { "dBAR-015-001b9178-014be24e-b40d2d0f.bin",
+		std::ifstream::in | std::ifstream::binary };
+
+	const auto bytes { std::vector<uint8_t> {
+		std::istreambuf_iterator<char> { file },
+		std::istreambuf_iterator<char> {} } };
+
+	REQUIRE ( bytes.size() == 444 );
+
+	const auto dBAR { load_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+
+
+	SECTION ( "Handler that is no ParseHandler receives all values" )
+	{
+		auto expected_arcs = uint64_t { 0 };
+
+		for (auto b = std::size_t { 0 }; b < dBAR.size(); ++b)
+		{
+			for (auto t = std::size_t { 0 }; t < dBAR.size(b); ++t)
+			{
+				expected_arcs += dBAR.arcs_value(b, t);
+			}
+		}
+
+		auto handler = CountingHandler {};
+
+		CHECK ( parse_buffer(bytes.data(), bytes.size(), handler) == 444 );
+
+		CHECK ( handler.blocks     == 3 );
+		CHECK ( handler.triplets   == 45 );
+		CHECK ( handler.input_ends == 1 );
+		CHECK ( handler.arcs       == expected_arcs );
+	}
+
+
+	SECTION ( "Error handler that is no ParseErrorHandler is called" )
+	{
+		auto handler       = CountingHandler {};
+		auto error_handler = CountingErrorHandler {};
+
+		CHECK ( parse_buffer(bytes.data(), 300, handler, error_handler)
+				== 300 );
+
+		CHECK ( handler.blocks       == 3 );
+		CHECK ( handler.input_ends   == 1 );
+		CHECK ( error_handler.errors == 1 );
+	}
+
+
+	SECTION ( "Missing error handler throws on incomplete input" )
+	{
+		auto handler = CountingHandler {};
+
+		CHECK_THROWS_AS ( parse_buffer(bytes.data(), 300, handler),
+				arcstk::StreamParseException );
+	}
+
+
+	SECTION ( "DBARBuilder can be passed as a static handler" )
+	{
+		auto builder = DBARBuilder {};
+
+		CHECK ( parse_buffer(bytes.data(), bytes.size(), builder) == 444 );
+
+		CHECK ( builder.result().equals(dBAR) );
+	}
+
+
+	SECTION ( "Pointers to handlers select the virtual overload" )
+	{
+		auto builder = DBARBuilder {};
+		auto pointer { &builder };
+
+		CHECK ( parse_buffer(bytes.data(), bytes.size(), pointer, nullptr)
+				== 444 );
+
+		CHECK ( builder.result().equals(dBAR) );
+	}
+
+
+	SECTION ( "Decoder fed in chunks passes the same values as parse_buffer" )
+	{
+		auto handler       = CountingHandler {};
+		auto error_handler = CountingErrorHandler {};
+		auto decoder       = arcstk::details::DBARDecoder {};
+
+		// Chunks of 5 bytes split each header and each triplet
+		for (auto pos = std::size_t { 0 }; pos < 300; pos += 5)
+		{
+			decoder.feed(bytes.data() + pos,
+					std::min(std::size_t { 5 }, 300 - pos), handler);
+		}
+
+		CHECK ( decoder.finish(handler, error_handler) == 300 );
+
+		auto expected       = CountingHandler {};
+		auto expected_error = CountingErrorHandler {};
+
+		parse_buffer(bytes.data(), 300, expected, expected_error);
+
+		CHECK ( handler.blocks       == expected.blocks );
+		CHECK ( handler.triplets     == expected.triplets );
+		CHECK ( handler.input_ends   == 1 );
+		CHECK ( handler.arcs         == expected.arcs );
+		CHECK ( error_handler.errors == 1 );
+	}
+}
+
+
+TEST_CASE ( "DBARPushParser", "[dbarpushparser] [dbar]" )
+{
+	using arcstk::DBARBuilder;
+	using arcstk::DBARPushParser;
+	using arcstk::StreamParseException;
+	using arcstk::load_file;
+
+	const auto read_bytes = [](const std::string& filename)
+	{
+		std::ifstream file { filename,
+			std::ifstream::in | std::ifstream::binary };
+
+		return std::vector<uint8_t> {
+			std::istreambuf_iterator<char> { file },
+			std::istreambuf_iterator<char> {} };
+	};
+
+	// Feed bytes in chunks of the specified size
+	const auto feed = [](DBARPushParser& parser,
+			const std::vector<uint8_t>& bytes, const std::size_t chunk_size)
+	{
+		for (auto i = std::size_t { 0 }; i < bytes.size(); i += chunk_size)
+		{
+			parser.feed(bytes.data() + i,
+					std::min(chunk_size, bytes.size() - i));
+		}
+	};
+
+	const auto bytes { read_bytes("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+	const auto dBAR  { load_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+
+	REQUIRE ( bytes.size() == 444 );
+
+
+	SECTION ( "Input in chunks of any size yields the same DBAR" )
+	{
+		for (const auto chunk_size : { 1, 2, 7, 9, 13, 100, 148, 444 })
+		{
+			auto builder = DBARBuilder {};
+			auto parser  = DBARPushParser { &builder, nullptr };
+
+			feed(parser, bytes, static_cast<std::size_t>(chunk_size));
+
+			CHECK ( parser.block_complete() );
+			CHECK ( parser.finish() == 444 );
+			CHECK ( builder.result().equals(dBAR) );
+		}
+	}
+
+
+	SECTION ( "Split records are kept between chunks" )
+	{
+		auto builder = DBARBuilder {};
+		auto parser  = DBARPushParser { &builder, nullptr };
+
+		parser.feed(bytes.data(), 20);
+
+		CHECK ( parser.bytes_parsed() == 20 );
+		CHECK ( not parser.block_complete() );
+
+		parser.feed(bytes.data() + 20, 128);
+
+		CHECK ( parser.bytes_parsed() == 148 );
+		CHECK ( parser.block_complete() );
+
+		parser.feed(bytes.data() + 148, 296);
+
+		CHECK ( parser.finish() == 444 );
+		CHECK ( builder.result().equals(dBAR) );
+	}
+
+
+	SECTION ( "Incomplete input is reported like parse_file() reports it" )
+	{
+		const auto files = {
+			"dBAR-015-001b9178-014be24e-b40d2d0f_H+01.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_H+05.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_H+09.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_H+13.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_T+0.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_T+1.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_T+5.bin",
+			"dBAR-015-001b9178-014be24e-b40d2d0f_T+8.bin"
+		};
+
+		for (const auto& filename : files)
+		{
+			auto expected_builder = DBARBuilder {};
+			auto expected_pos     = std::vector<unsigned> {};
+
+			try
+			{
+				arcstk::parse_file(filename, &expected_builder, nullptr);
+			} catch (const StreamParseException& e)
+			{
+				expected_pos = { e.byte_position(), e.block(),
+					e.block_byte_position() };
+			}
+
+			REQUIRE ( expected_pos.size() == 3 );
+
+			auto builder = DBARBuilder {};
+			auto parser  = DBARPushParser { &builder, nullptr };
+
+			feed(parser, read_bytes(filename), 5);
+
+			CHECK ( not parser.block_complete() );
+
+			try
+			{
+				parser.finish();
+
+				FAIL ( "Expected StreamParseException was not thrown" );
+			} catch (const StreamParseException& e)
+			{
+				CHECK ( e.byte_position()       == expected_pos[0] );
+				CHECK ( e.block()               == expected_pos[1] );
+				CHECK ( e.block_byte_position() == expected_pos[2] );
+			}
+		}
+	}
+
+
+	SECTION ( "Feeding a finished parser fails" )
+	{
+		auto builder = DBARBuilder {};
+		auto parser  = DBARPushParser { &builder, nullptr };
+
+		parser.feed(bytes.data(), bytes.size());
+
+		CHECK ( parser.finish() == 444 );
+		CHECK ( parser.finish() == 444 );
+
+		CHECK_THROWS_AS ( parser.feed(bytes.data(), bytes.size()),
+				std::logic_error );
+	}
+
+
+	SECTION ( "Parser without content handler cannot be constructed" )
+	{
+		CHECK_THROWS_AS ( DBARPushParser(nullptr, nullptr),
+				std::invalid_argument );
+	}
+}
@@ -13,9 +13,13 @@
 #include "dbar_details.hpp"       // TO BE TESTED
 #endif
 
+#include <cstdint>                // for uint8_t, uint32_t
 #include <fstream>                // for ifstream
+#include <sstream>                // for istringstream
 #include <stdexcept>              // for runtime_error
 #include <string>                 // for string
+#include <tuple>                  // for make_tuple, tuple
+#include <vector>                 // for vector
 
 /**
  * \brief Complete test of possible input
@@ -770,3 +774,219 @@ TEST_CASE ( "parse_dbar_stream", "[parse_dbar_stream] [dbar]" )
 	}
 }
 
+
+
+/**
+ * \brief ParseHandler that records the values passed.
+ */
+class RecordingHandler final : public arcstk::ParseHandler
+{
+	void do_start_input() final
+	{
+		// empty
+	}
+
+	void do_start_block() final
+	{
+		++blocks_started;
+	}
+
+	void do_header(const uint8_t total_tracks, const uint32_t id1,
+			const uint32_t id2, const uint32_t cddb_id) final
+	{
+		headers.emplace_back(total_tracks, id1, id2, cddb_id);
+	}
+
+	void do_triplet(const uint32_t arcs, const uint8_t confidence,
+			const uint32_t frame450_arcs) final
+	{
+		triplets.emplace_back(arcs, confidence, frame450_arcs);
+	}
+
+	void do_end_block() final
+	{
+		++blocks_ended;
+	}
+
+	void do_end_input() final
+	{
+		// empty
+	}
+
+public:
+
+	std::vector<std::tuple<unsigned, uint32_t, uint32_t, uint32_t>> headers;
+	std::vector<std::tuple<uint32_t, unsigned, uint32_t>> triplets;
+	int blocks_started = 0;
+	int blocks_ended   = 0;
+};
+
+
+/**
+ * \brief ParseErrorHandler that records the errors without throwing.
+ */
+class RecordingErrorHandler final : public arcstk::ParseErrorHandler
+{
+	void do_on_error(const unsigned byte_counter, const unsigned block_counter,
+			const unsigned block_byte_counter) final
+	{
+		errors.emplace_back(byte_counter, block_counter, block_byte_counter);
+	}
+
+public:
+
+	std::vector<std::tuple<unsigned, unsigned, unsigned>> errors;
+};
+
+
+TEST_CASE ( "parse_dbar_buffer", "[parse_dbar_buffer] [dbar]" )
+{
+	using arcstk::details::parse_dbar_buffer;
+
+	const auto bytes { std::vector<uint8_t> {
+		0x02, 0x78, 0x91, 0x1B, 0x00, 0x4E, 0xE2, 0x4B, 0x01,
+			0x0F, 0x2D, 0x0D, 0xB4,
+		0x18, 0xE5, 0x92, 0x99, 0xB8, 0x5E, 0x87, 0x6D, 0x12,
+		0x07, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x01,
+		0x01, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+			0x03, 0x00, 0x00, 0x00,
+		0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99
+	} };
+
+	auto handler       = RecordingHandler {};
+	auto error_handler = RecordingErrorHandler {};
+
+
+	SECTION ( "Parse complete buffer" )
+	{
+		CHECK ( parse_dbar_buffer(bytes.data(), bytes.size(), &handler,
+					nullptr) == 53 );
+
+		CHECK ( handler.blocks_started == 2 );
+		CHECK ( handler.blocks_ended   == 2 );
+
+		REQUIRE ( handler.headers.size() == 2 );
+
+		CHECK ( handler.headers[0] == std::make_tuple(2u,
+					0x001B9178u, 0x014BE24Eu, 0xB40D2D0Fu) );
+		CHECK ( handler.headers[1] == std::make_tuple(1u, 1u, 2u, 3u) );
+
+		REQUIRE ( handler.triplets.size() == 3 );
+
+		CHECK ( handler.triplets[0] == std::make_tuple(0xB89992E5u, 24u,
+					0x126D875Eu) );
+		CHECK ( handler.triplets[1] == std::make_tuple(0xDDCCBBAAu, 7u,
+					0x0100FFEEu) );
+		CHECK ( handler.triplets[2] == std::make_tuple(0x55443322u, 0x11u,
+					0x99887766u) );
+	}
+
+
+	SECTION ( "Parse buffer with incomplete header passes the complete ids" )
+	{
+		CHECK ( parse_dbar_buffer(bytes.data(), 31 + 10, &handler,
+					&error_handler) == 41 );
+
+		CHECK ( handler.blocks_started == 2 );
+		CHECK ( handler.blocks_ended   == 1 );
+
+		REQUIRE ( handler.headers.size() == 2 );
+		CHECK ( handler.headers[1] == std::make_tuple(1u, 1u, 2u, 0u) );
+
+		REQUIRE ( error_handler.errors.size() == 1 );
+		CHECK ( error_handler.errors[0] == std::make_tuple(41u, 2u, 10u) );
+	}
+
+
+	SECTION ( "Parse buffer with incomplete triplet passes the complete values" )
+	{
+		CHECK ( parse_dbar_buffer(bytes.data(), 13 + 9 + 6, &handler,
+					&error_handler) == 28 );
+
+		CHECK ( handler.blocks_started == 1 );
+		CHECK ( handler.blocks_ended   == 1 );
+
+		REQUIRE ( handler.triplets.size() == 2 );
+		CHECK ( handler.triplets[1] == std::make_tuple(0xDDCCBBAAu, 7u, 0u) );
+
+		REQUIRE ( error_handler.errors.size() == 1 );
+		CHECK ( error_handler.errors[0] == std::make_tuple(28u, 1u, 28u) );
+	}
+
+
+	SECTION ( "Parse buffer with missing triplet fails without a triplet" )
+	{
+		CHECK_THROWS_AS ( parse_dbar_buffer(bytes.data(), 13 + 9, &handler,
+					nullptr), arcstk::StreamParseException );
+
+		CHECK ( handler.triplets.size() == 1 );
+	}
+
+
+	SECTION ( "Parse empty buffer" )
+	{
+		CHECK ( parse_dbar_buffer(nullptr, 0, &handler, nullptr) == 0 );
+		CHECK ( handler.blocks_started == 0 );
+	}
+}
+
+
+TEST_CASE ( "parse_dbar_stream on input larger than a chunk",
+		"[parse_dbar_stream] [dbar]" )
+{
+	using arcstk::details::parse_dbar_stream;
+	using arcstk::details::read_dbar_file;
+	using arcstk::details::READ_BUFFER_BYTES;
+	using arcstk::DBARBuilder;
+
+	const auto file_bytes {
+		read_dbar_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+
+	// 150 copies of the file are 66600 bytes. The first chunk ends within the
+	// 12th triplet of block 443.
+
+	auto input = std::string {};
+	for (auto i = 0; i < 150; ++i)
+	{
+		input.append(file_bytes.begin(), file_bytes.end());
+	}
+
+	REQUIRE ( input.size() > READ_BUFFER_BYTES );
+
+	DBARBuilder builder;
+
+
+	SECTION ( "Records split between chunks are parsed" )
+	{
+		auto in = std::istringstream { input };
+
+		CHECK ( parse_dbar_stream(in, &builder, nullptr) == 66600 );
+
+		const auto dBAR { builder.result() };
+
+		REQUIRE ( dBAR.size() == 450 );
+		CHECK ( dBAR.header(442) == dBAR.header(1) );
+		CHECK ( dBAR.triplet(442, 11) == dBAR.triplet(1, 11) );
+		CHECK ( dBAR.triplet(442, 14) == dBAR.triplet(1, 14) );
+		CHECK ( dBAR.triplet(449, 14) == dBAR.triplet(2, 14) );
+	}
+
+
+	SECTION ( "Error position is counted over all chunks" )
+	{
+		auto in = std::istringstream { input.substr(0, input.size() - 4) };
+
+		try
+		{
+			auto b = parse_dbar_stream(in, &builder, nullptr);
+			static_cast<void>(b); // to avoid -Wunused-variable
+
+			FAIL ( "Expected StreamParseException was not thrown" );
+		} catch (const arcstk::StreamParseException &e)
+		{
+			CHECK ( e.block()               == 450 );
+			CHECK ( e.block_byte_position() == 144 );
+			CHECK ( e.byte_position()       == 66596 );
+		}
+	}
+}
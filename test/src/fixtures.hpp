@@ -0,0 +1,93 @@
+#ifndef __LIBARCSTK_TEST_FIXTURES_HPP__
+#define __LIBARCSTK_TEST_FIXTURES_HPP__
+
+/**
+ * \file
+ *
+ * \brief Fixtures shared by several testsuites.
+ */
+
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for ToC, make_toc
+#endif
+
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <memory>                 // for unique_ptr
+#include <numeric>                // for iota
+#include <vector>                 // for vector
+
+
+namespace fixtures
+{
+
+/**
+ * \brief Offsets of the album of three tracks.
+ *
+ * \return Offsets of the album
+ */
+inline std::vector<int32_t> album_offsets()
+{
+	return { 33, 5225, 7390 };
+}
+
+/**
+ * \brief Leadout of the album of three tracks.
+ */
+constexpr int32_t album_leadout { 23380 };
+
+/**
+ * \brief Complete ToC of the album of three tracks.
+ *
+ * \return ToC of the album
+ */
+inline std::unique_ptr<arcstk::ToC> album_toc()
+{
+	return arcstk::make_toc(album_leadout, album_offsets());
+}
+
+/**
+ * \brief Ascending samples for \c frames frames, starting with \c first.
+ *
+ * \param[in] frames Number of LBA frames
+ * \param[in] first  Value of the first sample
+ *
+ * \return Samples for \c frames frames
+ */
+inline std::vector<uint32_t> ascending_samples(const int32_t frames,
+		const uint32_t first)
+{
+	auto samples { std::vector<uint32_t>(
+			static_cast<std::size_t>(frames) * 588) };
+	std::iota(samples.begin(), samples.end(), first);
+
+	return samples;
+}
+
+/**
+ * \brief Pseudo random samples for \c frames frames.
+ *
+ * \param[in] frames Number of LBA frames
+ * \param[in] seed   Seed of the sequence
+ *
+ * \return Samples for \c frames frames
+ */
+inline std::vector<uint32_t> random_samples(const int32_t frames,
+		uint32_t seed)
+{
+	auto samples { std::vector<uint32_t>(
+			static_cast<std::size_t>(frames) * 588) };
+
+	for (auto& sample : samples)
+	{
+		seed   = seed * 1664525u + 1013904223u;
+		sample = seed;
+	}
+
+	return samples;
+}
+
+} // namespace fixtures
+
+#endif
+
@@ -0,0 +1,211 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for pipeline.hpp.
+ */
+
+#ifndef __LIBARCSTK_PIPELINE_HPP__
+#include "pipeline.hpp"           // TO BE TESTED
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for AccurateRipV1V2
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for Calculation, make_calculation
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for make_toc
+#endif
+
+#include "fixtures.hpp"           // for album_toc, ascending_samples
+
+#include <algorithm>              // for copy, min
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <memory>                 // for make_unique
+#include <stdexcept>              // for invalid_argument, logic_error, ...
+#include <utility>                // for pair
+#include <vector>                 // for vector
+
+
+namespace
+{
+
+/**
+ * \brief Algorithm that fails on any update.
+ */
+class FailingAlgorithm final : public arcstk::Algorithm
+{
+	void do_setup(const arcstk::Settings*) final
+	{
+		// empty
+	}
+
+	std::pair<int32_t,int32_t> do_range(const arcstk::AudioSize& size,
+			const arcstk::Points&) const final
+	{
+		return { 1, size.samples() };
+	}
+
+	void do_update(arcstk::SampleInputIterator, arcstk::SampleInputIterator)
+		final
+	{
+		throw std::runtime_error("Update failed");
+	}
+
+	void do_update(const uint32_t*, const uint32_t*) final
+	{
+		throw std::runtime_error("Update failed");
+	}
+
+	void do_track_finished(const int, const arcstk::AudioSize&) final
+	{
+		// empty
+	}
+
+	arcstk::ChecksumSet do_result() const final
+	{
+		return arcstk::ChecksumSet {};
+	}
+
+	arcstk::ChecksumtypeSet do_types() const final
+	{
+		return arcstk::ChecksumtypeSet {};
+	}
+
+	std::unique_ptr<arcstk::Algorithm> do_clone() const final
+	{
+		return std::make_unique<FailingAlgorithm>();
+	}
+};
+
+} // namespace
+
+
+TEST_CASE ( "CalculationPipeline", "[pipeline] [calc]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::CalculationPipeline;
+	using arcstk::make_calculation;
+
+	const auto toc { fixtures::album_toc() };
+
+	auto samples { fixtures::ascending_samples(fixtures::album_leadout, 7u) };
+
+	auto reference { make_calculation(std::make_unique<V1andV2>(), *toc) };
+	reference->update(samples.data(), samples.data() + samples.size());
+
+	auto calculation { make_calculation(std::make_unique<V1andV2>(), *toc) };
+
+
+	SECTION ("Construction with empty blocks fails")
+	{
+		CHECK_THROWS_AS ( CalculationPipeline(*calculation, 0, 4),
+				std::invalid_argument );
+		CHECK_THROWS_AS ( CalculationPipeline(*calculation, 588, 0),
+				std::invalid_argument );
+	}
+
+
+	SECTION ("Parametized construction is as declared")
+	{
+		CalculationPipeline pipeline(*calculation, 1000, 3);
+
+		CHECK ( pipeline.block_size()   == 1000 );
+		CHECK ( pipeline.total_blocks() == 3 );
+	}
+
+
+	SECTION ("Result is equal to the result of a direct update")
+	{
+		// Odd block size and few blocks to let the producer wait and the
+		// blocks not be aligned to the tracks
+		CalculationPipeline pipeline(*calculation, 100003, 2);
+
+		auto pos = std::size_t { 0 };
+
+		while (pos < samples.size())
+		{
+			auto block { pipeline.acquire() };
+
+			const auto size { std::min(pipeline.block_size(),
+					samples.size() - pos) };
+
+			std::copy(samples.data() + pos, samples.data() + pos + size, block);
+			pipeline.commit(size);
+
+			pos += size;
+		}
+
+		pipeline.close();
+
+		CHECK ( calculation->complete() );
+		CHECK ( calculation->result() == reference->result() );
+	}
+
+
+	SECTION ("Acquiring twice without commit returns the same block")
+	{
+		CalculationPipeline pipeline(*calculation);
+
+		CHECK ( pipeline.acquire() == pipeline.acquire() );
+	}
+
+
+	SECTION ("Committing is validated")
+	{
+		CalculationPipeline pipeline(*calculation, 1000, 2);
+
+		CHECK_THROWS_AS ( pipeline.commit(10), std::logic_error );
+
+		pipeline.acquire();
+
+		CHECK_THROWS_AS ( pipeline.commit(1001), std::out_of_range );
+	}
+
+
+	SECTION ("Acquiring from a closed pipeline fails")
+	{
+		CalculationPipeline pipeline(*calculation);
+
+		pipeline.close();
+		pipeline.close(); // no effect
+
+		CHECK_THROWS_AS ( pipeline.acquire(), std::logic_error );
+	}
+
+
+	SECTION ("Errors of the consumer are rethrown to the producer")
+	{
+		auto failing { make_calculation(std::make_unique<FailingAlgorithm>(),
+				*toc) };
+
+		CalculationPipeline pipeline(*failing, 1000, 2);
+
+		// At latest the third acquire has to wait for the consumer to release
+		// a block, which it does after the failure
+
+		auto thrown = bool { false };
+
+		try
+		{
+			for (auto i = 0; i < 3; ++i)
+			{
+				auto block { pipeline.acquire() };
+				std::copy(samples.begin(), samples.begin() + 1000, block);
+				pipeline.commit(1000);
+			}
+
+			pipeline.close();
+
+		} catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+
+		CHECK ( thrown );
+	}
+}
@@ -10,9 +10,12 @@
 #include "samples.hpp"            // TO BE TESTED
 #endif
 
+#include <cstddef>                // for size_t
 #include <cstdint>                // for int16_t, uint8_t, uint32_t, int32_t,...
 #include <fstream>                // for ifstream, istreambuf_iterator
-#include <iterator>               // for begin, end, next, prev
+#include <iterator>               // for begin, end, next, prev, distance
+#include <stdexcept>              // for out_of_range
+#include <type_traits>            // for is_same
 #include <utility>                // for move
 #include <vector>                 // for vector
 
@@ -993,6 +996,109 @@ TEST_CASE ( "SampleSequence index access works correctly",
 }
 
 
+TEST_CASE ( "SampleSequence copy equals subscript access",
+		"[samplesequence] [calc]" )
+{
+	using arcstk::PlanarSamples;
+	using arcstk::InterleavedSamples;
+	using arcstk::sample_type;
+
+	// Load example samples
+
+	std::ifstream in;
+	in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+	try
+	{
+		in.open("samplesequence-test-01.bin",
+				std::ifstream::in | std::ifstream::binary);
+	} catch (const std::ifstream::failure& f)
+	{
+		FAIL ("Could not open test data file samplesequence-test-01.bin");
+	}
+
+	std::vector<uint8_t> bytes(
+			(std::istreambuf_iterator<char>(in)),
+			std::istreambuf_iterator<char>()
+	);
+
+	in.close();
+
+	REQUIRE ( bytes.size() == 1024 );
+
+	// Copy from an unaligned position to the end, include remainders that
+	// are not processed by vectorized conversion
+	const auto check_copy = [](const auto& sequence)
+	{
+		const auto pos { std::size_t { 3 } };
+
+		auto copied = std::vector<sample_type>(sequence.size() + 5);
+		const auto n { sequence.copy(copied.data(), copied.size(), pos) };
+
+		REQUIRE ( n == sequence.size() - pos );
+
+		auto matches { std::size_t { 0 } };
+		for (auto i = std::size_t { 0 }; i < n; ++i)
+		{
+			if (copied[i] == sequence[pos + i])
+			{
+				++matches;
+			}
+		}
+
+		CHECK ( matches == n );
+	};
+
+
+	SECTION ("Copying from int16_t interleaved sequence")
+	{
+		check_copy(InterleavedSamples<int16_t>{ bytes.data(), bytes.size(), true });
+		check_copy(InterleavedSamples<int16_t>{ bytes.data(), bytes.size(), false });
+	}
+
+
+	SECTION ("Copying from int32_t interleaved sequence")
+	{
+		check_copy(InterleavedSamples<int32_t>{ bytes.data(), bytes.size(), true });
+		check_copy(InterleavedSamples<int32_t>{ bytes.data(), bytes.size(), false });
+	}
+
+
+	SECTION ("Copying from uint16_t planar sequence")
+	{
+		const auto half { bytes.size() / 2 };
+
+		check_copy(PlanarSamples<uint16_t>{ bytes.data(), bytes.data() + half,
+				half, true });
+		check_copy(PlanarSamples<uint16_t>{ bytes.data(), bytes.data() + half,
+				half, false });
+	}
+
+
+	SECTION ("Copying from uint32_t planar sequence")
+	{
+		const auto half { bytes.size() / 2 };
+
+		check_copy(PlanarSamples<uint32_t>{ bytes.data(), bytes.data() + half,
+				half, true });
+		check_copy(PlanarSamples<uint32_t>{ bytes.data(), bytes.data() + half,
+				half, false });
+	}
+
+
+	SECTION ("Copying from position beyond the end throws")
+	{
+		const auto sequence { InterleavedSamples<int16_t>{ bytes.data(),
+				bytes.size() } };
+		auto copied = std::vector<sample_type>(1);
+
+		CHECK ( sequence.copy(copied.data(), 1, sequence.size()) == 0 );
+		CHECK_THROWS_AS ( sequence.copy(copied.data(), 1, sequence.size() + 1),
+				std::out_of_range );
+	}
+}
+
+
 TEST_CASE ( "SampleIterator increment and decrement",
 		"[sampleiterator] [calc]" )
 {
@@ -1303,6 +1409,35 @@ TEST_CASE ( "SampleIterator increment and decrement",
 		CHECK ( e.index()   == 0 );
 	}
 
+	SECTION ("Iterator is a random access iterator")
+	{
+		auto sequence = InterleavedSamples<uint32_t>{};
+		sequence.wrap_byte_buffer(&bytes[0], 1024, true); // bytes
+
+		using category = std::iterator_traits<
+			decltype(cbegin(sequence))>::iterator_category;
+
+		CHECK ( std::is_same<category, std::random_access_iterator_tag>::value );
+
+		const auto first = cbegin(sequence);
+		const auto last  = first + 118;
+
+		CHECK ( first[0]   == 0x9ECCC2A5 );
+		CHECK ( first[9]   == 0x5BCA0129 );
+		CHECK ( first[118] == 0xE6791252 );
+		CHECK ( last[-109] == 0x5BCA0129 );
+
+		CHECK ( first < last );
+		CHECK ( first <= last );
+		CHECK ( last > first );
+		CHECK ( last >= first );
+		CHECK ( first <= first );
+		CHECK ( not (first < first) );
+
+		CHECK ( std::distance(first, last) == 118 );
+		CHECK ( std::next(first, 118) == last );
+	}
+
 	SECTION ("Iterator 16 bit begin and end")
 	{
 		auto sequence = PlanarSamples<int16_t>{};
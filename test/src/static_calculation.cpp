@@ -0,0 +1,141 @@
+#include "catch2/catch_test_macros.hpp"
+
+/**
+ * \file
+ *
+ * \brief Fixtures for static_calculation.hpp.
+ */
+
+#ifndef __LIBARCSTK_STATIC_CALCULATION_HPP__
+#include "static_calculation.hpp" // TO BE TESTED
+#endif
+
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for AccurateRip::V1, V2, V1andV2
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for Calculation, make_calculation
+#endif
+#ifndef __LIBARCSTK_METADATA_HPP__
+#include "metadata.hpp"           // for make_toc
+#endif
+
+#include "fixtures.hpp"           // for album_toc, ascending_samples
+
+#include <algorithm>              // for min
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <list>                   // for list
+#include <memory>                 // for make_unique
+#include <stdexcept>              // for invalid_argument
+#include <vector>                 // for vector
+
+
+TEST_CASE ( "StaticCalculation", "[staticcalculation] [calc]" )
+{
+	using arcstk::AccurateRip::V1;
+	using arcstk::AccurateRip::V2;
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AudioSize;
+	using arcstk::Calculation;
+	using arcstk::Context;
+	using arcstk::make_calculation;
+	using arcstk::Points;
+	using arcstk::StaticCalculation;
+	using arcstk::UNIT;
+
+	const auto toc { fixtures::album_toc() };
+
+	auto samples { fixtures::ascending_samples(fixtures::album_leadout,
+			0xFFFF0000u) };
+
+	const auto block_size { std::size_t { 100003 } };
+
+	const auto expected = [&](std::unique_ptr<arcstk::Algorithm> a)
+	{
+		auto calculation { make_calculation(std::move(a), *toc) };
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		return calculation->result();
+	};
+
+
+	SECTION ("Result of V1andV2 equals the result of Calculation")
+	{
+		auto calculation { StaticCalculation<V1andV2, const uint32_t*> { *toc } };
+
+		for (auto i = std::size_t { 0 }; i < samples.size(); i += block_size)
+		{
+			const auto end { std::min(i + block_size, samples.size()) };
+			calculation.update(samples.data() + i, samples.data() + end);
+		}
+
+		REQUIRE ( calculation.complete() );
+
+		CHECK ( calculation.samples_processed()
+				== static_cast<int32_t>(samples.size()) );
+		CHECK ( calculation.result() == expected(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Result of V1 and of V2 equals the result of Calculation")
+	{
+		auto c1 { StaticCalculation<V1, const uint32_t*> { *toc } };
+		auto c2 { StaticCalculation<V2, const uint32_t*> { *toc } };
+
+		c1.update(samples.data(), samples.data() + samples.size());
+		c2.update(samples.data(), samples.data() + samples.size());
+
+		REQUIRE ( c1.complete() );
+		REQUIRE ( c2.complete() );
+
+		CHECK ( c1.result() == expected(std::make_unique<V1>()) );
+		CHECK ( c2.take_result() == expected(std::make_unique<V2>()) );
+		CHECK ( c2.result().empty() );
+	}
+
+
+	SECTION ("Non-contiguous iterators yield the same result")
+	{
+		const auto list { std::list<uint32_t>(samples.begin(), samples.end()) };
+
+		auto calculation { StaticCalculation<V1andV2,
+			std::list<uint32_t>::const_iterator> { *toc } };
+
+		calculation.update(list.begin(), list.end());
+
+		REQUIRE ( calculation.complete() );
+
+		CHECK ( calculation.result() == expected(std::make_unique<V1andV2>()) );
+	}
+
+
+	SECTION ("Single track without context equals the result of Calculation")
+	{
+		const auto size { AudioSize { 5000, UNIT::FRAMES } };
+
+		auto reference { Calculation { Context::TRACK,
+			std::make_unique<V1andV2>(), size, Points{} } };
+		reference.update(samples.data(), samples.data() + size.samples());
+
+		auto calculation { StaticCalculation<V1andV2, const uint32_t*> {
+			Context::TRACK, size, Points{} } };
+		calculation.update(samples.data(), samples.data() + size.samples());
+
+		REQUIRE ( calculation.complete() );
+
+		CHECK ( calculation.result() == reference.result() );
+	}
+
+
+	SECTION ("Input without samples to calculate is rejected")
+	{
+		using Calc = StaticCalculation<V1andV2, const uint32_t*>;
+
+		CHECK_THROWS_AS ( Calc(Context::ALBUM, AudioSize{}, Points{}),
+				std::invalid_argument );
+		CHECK_THROWS_AS ( Calc(Context::ALBUM,
+					AudioSize { 1000, UNIT::SAMPLES }, Points{}),
+				std::invalid_argument );
+	}
+}
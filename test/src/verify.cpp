@@ -10,6 +10,12 @@
 #include "verify.hpp"             // TO BE TESTED
 #endif
 
+#ifndef __LIBARCSTK_ALGORITHMS_HPP__
+#include "algorithms.hpp"         // for V1andV2, V1andV2withFrame450
+#endif
+#ifndef __LIBARCSTK_CALCULATE_HPP__
+#include "calculate.hpp"          // for make_calculation
+#endif
 #ifndef __LIBARCSTK_CHECKSUM_HPP__
 #include "checksum.hpp"           // for Checksum, ChecksumSet, Checksums,...
 #endif
@@ -17,10 +23,17 @@
 #include "identifier.hpp"         // for ARId
 #endif
 #ifndef __LIBARCSTK_DBAR_HPP__
-#include "dbar.hpp"               // for DBAR
+#include "dbar.hpp"               // for DBAR, DBARView, load_file
 #endif
 
+#include "fixtures.hpp"           // for album_offsets, album_toc, ...
+
+#include <cstddef>                // for size_t
+#include <cstdint>                // for int32_t, uint32_t
+#include <memory>                 // for make_unique
+#include <stdexcept>              // for invalid_argument
 #include <tuple>                  // for get
+#include <vector>                 // for vector
 
 
 // TODO ChecksumSourceOf
@@ -170,6 +183,65 @@ TEST_CASE ( "DBARSource", "[dbarsource] [verify]" )
 }
 
 
+TEST_CASE ( "DBARViewSource", "[dbarviewsource] [verify]" )
+{
+	using arcstk::DBARSource;
+	using arcstk::DBARView;
+	using arcstk::DBARViewSource;
+	using arcstk::load_file;
+
+	const auto dBAR { load_file("dBAR-015-001b9178-014be24e-b40d2d0f.bin") };
+	const auto view { DBARView { "dBAR-015-001b9178-014be24e-b40d2d0f.bin" } };
+
+	const auto expected = DBARSource { &dBAR };
+	const auto r        = DBARViewSource { &view };
+
+	SECTION ( "ChecksumSoure of DBARView is constructed correctly" )
+	{
+		CHECK ( &view == r.source() );
+	}
+
+	SECTION ( "Access on DBARView data is correct" )
+	{
+		REQUIRE ( r.size() == expected.size() );
+
+		for (auto b = std::size_t { 0 }; b < r.size(); ++b)
+		{
+			CHECK ( r.id(b) == expected.id(b) );
+
+			REQUIRE ( r.size(b) == 15 );
+
+			for (auto t = std::size_t { 0 }; t < r.size(b); ++t)
+			{
+				CHECK ( r.checksum(b, t) == expected.checksum(b, t) );
+				CHECK ( r.arcs_value(b, t) == expected.arcs_value(b, t) );
+				CHECK ( r.confidence(b, t) == expected.confidence(b, t) );
+				CHECK ( r.frame450_arcs_value(b, t)
+						== expected.frame450_arcs_value(b, t) );
+			}
+		}
+	}
+
+	SECTION ( "Values of subsequent accesses do not alias each other" )
+	{
+		const auto& first  = r.arcs_value(0, 0);
+		const auto& second = r.arcs_value(2, 14);
+
+		REQUIRE ( expected.arcs_value(0, 0) != expected.arcs_value(2, 14) );
+
+		CHECK ( first  == expected.arcs_value(0, 0) );
+		CHECK ( second == expected.arcs_value(2, 14) );
+	}
+
+	SECTION ( "Clone of ChecksumSource of DBARView accesses the same data" )
+	{
+		const auto clone { r.clone() };
+
+		CHECK ( clone->arcs_value(2, 14) == expected.arcs_value(2, 14) );
+	}
+}
+
+
 TEST_CASE ( "AlbumVerifier", "[albumverifier] [verify]" )
 {
 	using arcstk::ARId;
@@ -1350,3 +1422,173 @@ TEST_CASE ( "TracksetVerifier", "[tracksetverifier] [verify]" )
 	}
 }
 
+
+TEST_CASE ( "OffsetDetector", "[offsetdetector] [verify]" )
+{
+	using arcstk::DBAR;
+	using arcstk::DBARSource;
+	using arcstk::OffsetDetector;
+	using arcstk::OffsetMatch;
+	using arcstk::sample_t;
+
+	const auto max_offset { 2940 };
+
+	// Window of samples around frame 450
+	auto window = std::vector<sample_t>(588 + 2 * max_offset);
+
+	auto x { uint32_t { 3 } };
+	for (auto& s : window)
+	{
+		x = x * 1664525u + 1013904223u;
+		s = x;
+	}
+
+	// ARCS of frame 450 when read with the specified offset
+	const auto frame450_arcs = [&window,max_offset](const int32_t offset)
+	{
+		const auto first { static_cast<std::size_t>(max_offset + offset) };
+
+		auto arcs { uint32_t { 0 } };
+		for (auto i = std::size_t { 0 }; i < 588; ++i)
+		{
+			arcs += static_cast<uint32_t>(i + 1) * window[first + i];
+		}
+
+		return arcs;
+	};
+
+	const auto dBAR = DBAR {
+		{ { 3, 0x001B9178, 0x014BE24E, 0xB40D2D0F },
+		{ /* triplets */
+			{ 0x98B10E0F, 3, 0x11111111 },
+			{ 0x475F57E9, 4, 0 },
+			{ 0x7304F1C4, 5, 0x22222222 }
+		} },
+		{ { 3, 0x001B9178, 0x014BE24E, 0xB40D2D0F },
+		{ /* triplets */
+			{ 0xB89992E5, 6, 0x33333333 },
+			{ 0x4F77EB03, 8, frame450_arcs(-1234) },
+			{ 0x56582282, 7, frame450_arcs(667) }
+		} }
+	};
+
+	const auto source   { DBARSource { &dBAR } };
+	const auto detector { OffsetDetector { source } };
+
+
+	SECTION ( "Index contains all non-zero reference values" )
+	{
+		CHECK ( detector.size() == 5 );
+
+		const auto refs { detector.lookup(0x22222222) };
+
+		REQUIRE ( refs.size() == 1 );
+		CHECK ( refs[0].first  == 0 );
+		CHECK ( refs[0].second == 2 );
+
+		CHECK ( detector.lookup(0).empty() );
+	}
+
+
+	SECTION ( "Offsets are detected" )
+	{
+		const auto matches { detector.detect(window.data(),
+				window.data() + window.size(), max_offset) };
+
+		REQUIRE ( matches.size() == 2 );
+		CHECK ( matches[0] == OffsetMatch { -1234, 1, 1 } );
+		CHECK ( matches[1] == OffsetMatch {   667, 1, 2 } );
+	}
+
+
+	SECTION ( "Window that does not match maximal offset throws" )
+	{
+		CHECK_THROWS ( detector.detect(window.data(),
+				window.data() + window.size() - 1, max_offset) );
+	}
+}
+
+
+TEST_CASE ( "OffsetDetector on a Calculation", "[offsetdetector] [verify]" )
+{
+	using arcstk::AccurateRip::V1andV2;
+	using arcstk::AccurateRip::V1andV2withFrame450;
+	using arcstk::DBAR;
+	using arcstk::DBARSource;
+	using arcstk::OffsetDetector;
+	using arcstk::OffsetMatch;
+	using arcstk::make_calculation;
+
+	const auto max_offset { 2000 };
+
+	const auto toc     { fixtures::album_toc() };
+	const auto offsets { fixtures::album_offsets() };
+	const auto samples { fixtures::random_samples(fixtures::album_leadout,
+			11u) };
+
+	// ARCS of frame 450 of a track when read with the specified offset
+	const auto frame450_arcs = [&samples,&offsets](const std::size_t track,
+			const int32_t offset)
+	{
+		const auto first { static_cast<std::size_t>(
+				offsets[track - 1] * 588 + 450 * 588 + offset) };
+
+		auto arcs { uint32_t { 0 } };
+		for (auto i = std::size_t { 0 }; i < 588; ++i)
+		{
+			arcs += static_cast<uint32_t>(i + 1) * samples[first + i];
+		}
+
+		return arcs;
+	};
+
+	const auto dBAR = DBAR {
+		{ { 3, 0x001B9178, 0x014BE24E, 0xB40D2D0F },
+		{ /* triplets */
+			{ 0x98B10E0F, 3, frame450_arcs(1, 0) },
+			{ 0x475F57E9, 4, frame450_arcs(2, 667) },
+			{ 0x7304F1C4, 5, frame450_arcs(3, -1234) }
+		} }
+	};
+
+	const auto source   { DBARSource { &dBAR } };
+	const auto detector { OffsetDetector { source } };
+
+
+	SECTION ( "Offsets are detected from the windows of the calculation" )
+	{
+		auto calculation { make_calculation(
+				std::make_unique<V1andV2withFrame450>(max_offset), *toc) };
+
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		REQUIRE ( calculation->complete() );
+
+		const auto matches_1 { detector.detect(*calculation, 1) };
+		REQUIRE ( matches_1.size() == 1 );
+		CHECK ( matches_1[0] == OffsetMatch { 0, 0, 0 } );
+
+		const auto matches_2 { detector.detect(*calculation, 2) };
+		REQUIRE ( matches_2.size() == 1 );
+		CHECK ( matches_2[0] == OffsetMatch { 667, 0, 1 } );
+
+		const auto matches_3 { detector.detect(*calculation, 3) };
+		REQUIRE ( matches_3.size() == 1 );
+		CHECK ( matches_3[0] == OffsetMatch { -1234, 0, 2 } );
+
+		CHECK_THROWS_AS ( detector.detect(*calculation, 4),
+				std::invalid_argument );
+	}
+
+
+	SECTION ( "Calculation without windows is rejected" )
+	{
+		auto calculation { make_calculation(std::make_unique<V1andV2>(),
+					*toc) };
+
+		calculation->update(samples.data(), samples.data() + samples.size());
+
+		CHECK_THROWS_AS ( detector.detect(*calculation, 1),
+				std::invalid_argument );
+	}
+}